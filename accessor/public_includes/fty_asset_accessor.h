@@ -25,6 +25,7 @@
 #include <fty/expected.h>
 #include <list>
 #include <string>
+#include <vector>
 
 namespace fty
 {
@@ -33,6 +34,7 @@ namespace fty
     public:
         static fty::Expected<uint32_t> assetInameToID(const std::string& iname);
         static fty::Expected<fty::Asset> getAsset(const std::string& iname);
+        static std::vector<fty::Expected<fty::Asset>> getAssets(const std::vector<std::string>& inames);
         static void notifyStatusUpdate(const std::string& iname, const std::string& oldStatus, const std::string& newStatus);
         static void notifyAssetUpdate(const Asset& oldAsset, const Asset& newAsset);
     };
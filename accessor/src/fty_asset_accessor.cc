@@ -144,6 +144,55 @@ namespace fty
         return asset;
     }
 
+    /// returns the full fty::Asset of each internal name, in order, with a single request
+    std::vector<fty::Expected<fty::Asset>> AssetAccessor::getAssets(const std::vector<std::string>& inames)
+    {
+        std::vector<fty::Expected<fty::Asset>> assets;
+        messagebus::Message ret;
+
+        try
+        {
+            cxxtools::SerializationInfo si;
+            si <<= inames;
+            ret = sendSyncReq("GET_MANY", {JSON::writeToString(si, false)});
+        }
+        catch (messagebus::MessageBusException &e)
+        {
+            for (size_t i = 0; i < inames.size(); i++) {
+                assets.push_back(fty::unexpected("MessageBus request failed: {}", e.what()));
+            }
+            return assets;
+        }
+
+        if (ret.metaData().at(messagebus::Message::STATUS) != messagebus::STATUS_OK)
+        {
+            for (size_t i = 0; i < inames.size(); i++) {
+                assets.push_back(fty::unexpected("Request of fty::FullAsset list from inames failed"));
+            }
+            return assets;
+        }
+
+        cxxtools::SerializationInfo si;
+        JSON::readFromString(ret.userData().front(), si);
+
+        for (const auto& item : si) {
+            std::string status;
+            item.getMember("status") >>= status;
+
+            if (status == "OK") {
+                Asset asset;
+                item.getMember("asset") >>= asset;
+                assets.push_back(asset);
+            } else {
+                std::string error;
+                item.getMember("error") >>= error;
+                assets.push_back(fty::unexpected("{}", error));
+            }
+        }
+
+        return assets;
+    }
+
     /// triggers an update notification. It receives the DTOs of the asset before and after the update
     void AssetAccessor::notifyStatusUpdate(const std::string& iname, const std::string& oldStatus, const std::string& newStatus)
     {
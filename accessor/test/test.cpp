@@ -46,3 +46,14 @@ TEST_CASE("Request ID - Failure")
     REQUIRE(!id);
     CHECK(id.error() == "Request of ID from iname failed");  
 }
+
+TEST_CASE("Get many")
+{
+    auto assets = AssetAccessor::getAssets({"rackcontroller-0", "datacenter-0"});
+
+    REQUIRE(assets.size() == 2);
+    REQUIRE(assets[0]);
+    CHECK(assets[0]->getInternalName() == "rackcontroller-0");
+    REQUIRE(!assets[1]);
+    CHECK(assets[1].error() == "Asset datacenter-0 not found");
+}
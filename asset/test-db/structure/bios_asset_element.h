@@ -15,6 +15,7 @@ void createAssetElement(fty::db::Connection& conn)
             status            VARCHAR(9)          NOT NULL DEFAULT "nonactive",
             priority          TINYINT             NOT NULL DEFAULT 5,
             asset_tag         VARCHAR(50),
+            id_secondary      VARCHAR(255),
 
             PRIMARY KEY (id_asset_element),
 
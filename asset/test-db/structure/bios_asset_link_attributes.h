@@ -0,0 +1,29 @@
+#pragma once
+#include <fty_common_db_connection.h>
+
+namespace fty {
+
+void createAssetLinkAttributes(fty::db::Connection& conn)
+{
+    conn.execute(R"(
+        CREATE TABLE t_bios_asset_link_attributes(
+            id_asset_link_attribute   INT UNSIGNED NOT NULL AUTO_INCREMENT,
+            keytag                    VARCHAR(40)  NOT NULL,
+            value                     VARCHAR(255) NOT NULL,
+            id_link                   INT UNSIGNED NOT NULL,
+            read_only                 TINYINT      NOT NULL DEFAULT 0,
+
+            PRIMARY KEY (id_asset_link_attribute),
+
+            INDEX FK_ASSETLINKATTR_LINK_idx (id_link ASC),
+            UNIQUE INDEX `UI_t_bios_asset_link_attributes` (`keytag`, `id_link` ASC),
+
+            CONSTRAINT FK_ASSETLINKATTR_LINK
+            FOREIGN KEY (id_link)
+            REFERENCES t_bios_asset_link (id_link)
+            ON DELETE CASCADE
+        );
+    )");
+}
+
+} // namespace fty
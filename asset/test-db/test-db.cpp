@@ -5,6 +5,7 @@
 #include "structure/bios_asset_ext_attributes.h"
 #include "structure/bios_asset_group_relation.h"
 #include "structure/bios_asset_link.h"
+#include "structure/bios_asset_link_attributes.h"
 #include "structure/bios_asset_link_type.h"
 #include "structure/bios_device_type.h"
 #include "structure/bios_discovered_device.h"
@@ -85,6 +86,7 @@ static void createDB()
     createAssetAttributes(conn);
     createGroupRelations(conn);
     createAssetLink(conn);
+    createAssetLinkAttributes(conn);
     createDiscoveryDevice(conn);
     createMonitorAssetRelation(conn);
     createTag(conn);
@@ -28,6 +28,8 @@
 #include <map>
 #include <optional>
 #include <string>
+#include <utility>
+#include <vector>
 
 // fwd declaration
 struct fty_proto_t;
@@ -326,6 +328,54 @@ public:
     void deserializeUI(const cxxtools::SerializationInfo& si);
 };
 
+/// Changes between two states of an asset: basic fields, ext entries and links that differ.
+/// Links are compared as AssetLink ==, a link whose attributes changed is set again. Links set carry
+/// their position in the after state, links are all set again if the others were reordered.
+class AssetDelta
+{
+public:
+    /// version of the serialized format, a delta of a newer version is rejected on deserialization
+    static constexpr int VERSION = 1;
+
+    AssetDelta() = default;
+    AssetDelta(const Asset& before, const Asset& after);
+
+    const std::string& getInternalName() const;
+    int                getVersion() const;
+
+    /// true if before and after are equal
+    bool empty() const;
+
+    /// applies changes to asset, which is expected to be in the before state
+    void apply(Asset& asset) const;
+
+    // serialization / deserialization for cxxtools
+    void serialize(cxxtools::SerializationInfo& si) const;
+    void deserialize(const cxxtools::SerializationInfo& si);
+
+    static std::string toJson(const AssetDelta& d);
+    static void        fromJson(const std::string& json, AssetDelta& d);
+
+private:
+    int                        m_version = VERSION;
+    std::string                m_internalName;
+    std::optional<AssetStatus> m_assetStatus;
+    std::optional<std::string> m_assetType;
+    std::optional<std::string> m_assetSubtype;
+    std::optional<int>         m_priority;
+    std::optional<std::string> m_parentIname;
+    std::optional<std::string> m_secondaryID;
+    std::optional<std::string> m_assetTag;
+    Asset::ExtMap              m_extSet;
+    std::vector<std::string>   m_extRemoved;
+    // position in the after links, by increasing position
+    std::vector<std::pair<size_t, AssetLink>> m_linksSet;
+    std::vector<AssetLink>                    m_linksRemoved;
+};
+
+void operator<<=(cxxtools::SerializationInfo& si, const fty::AssetDelta& delta);
+void operator>>=(const cxxtools::SerializationInfo& si, fty::AssetDelta& delta);
+
 } // namespace fty
 
 //  Self test of this class
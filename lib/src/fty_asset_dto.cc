@@ -35,6 +35,7 @@
 #include <algorithm>
 #include <fty_proto.h>
 #include <sstream>
+#include <stdexcept>
 
 #include <cxxtools/jsondeserializer.h>
 #include <cxxtools/jsonserializer.h>
@@ -930,5 +931,353 @@ void UIAsset::deserializeUI(const cxxtools::SerializationInfo& /*si*/)
 }
 
 
+// AssetDelta
+
+static constexpr const char* SI_DELTA_VERSION       = "version";
+static constexpr const char* SI_DELTA_EXT_REMOVED   = "ext_removed";
+static constexpr const char* SI_DELTA_LINKS_SET     = "linked_set";
+static constexpr const char* SI_DELTA_LINKS_REMOVED = "linked_removed";
+static constexpr const char* SI_DELTA_ASSET_TAG     = "asset_tag";
+static constexpr const char* SI_DELTA_LINK_POSITION = "position";
+
+static bool sameLinkAttributes(const AssetLink& l, const AssetLink& r)
+{
+    return l.ext() == r.ext() && l.secondaryID() == r.secondaryID();
+}
+
+AssetDelta::AssetDelta(const Asset& before, const Asset& after)
+    : m_internalName(after.getInternalName())
+{
+    if (before.getAssetStatus() != after.getAssetStatus()) {
+        m_assetStatus = after.getAssetStatus();
+    }
+    if (before.getAssetType() != after.getAssetType()) {
+        m_assetType = after.getAssetType();
+    }
+    if (before.getAssetSubtype() != after.getAssetSubtype()) {
+        m_assetSubtype = after.getAssetSubtype();
+    }
+    if (before.getPriority() != after.getPriority()) {
+        m_priority = after.getPriority();
+    }
+    if (before.getParentIname() != after.getParentIname()) {
+        m_parentIname = after.getParentIname();
+    }
+    if (before.getSecondaryID() != after.getSecondaryID()) {
+        m_secondaryID = after.getSecondaryID();
+    }
+    if (before.getAssetTag() != after.getAssetTag()) {
+        m_assetTag = after.getAssetTag();
+    }
+
+    // both maps are sorted by key
+    const Asset::ExtMap& extBefore = before.getExt();
+    for (const auto& e : after.getExt()) {
+        auto it = extBefore.find(e.first);
+        if (it == extBefore.end() || it->second != e.second) {
+            m_extSet.emplace(e);
+        }
+    }
+    for (const auto& e : extBefore) {
+        if (after.getExt().count(e.first) == 0) {
+            m_extRemoved.push_back(e.first);
+        }
+    }
+
+    const std::vector<AssetLink>& linksBefore = before.getLinkedAssets();
+    const std::vector<AssetLink>& linksAfter  = after.getLinkedAssets();
+    for (const auto& l : linksBefore) {
+        if (std::find(linksAfter.begin(), linksAfter.end(), l) == linksAfter.end()) {
+            m_linksRemoved.push_back(l);
+        }
+    }
+
+    // links kept keep their order unless they were reordered, then all are set at their position
+    std::vector<AssetLink> keptBefore, keptAfter;
+    for (const auto& l : linksBefore) {
+        if (std::find(linksAfter.begin(), linksAfter.end(), l) != linksAfter.end()) {
+            keptBefore.push_back(l);
+        }
+    }
+    for (const auto& l : linksAfter) {
+        if (std::find(linksBefore.begin(), linksBefore.end(), l) != linksBefore.end()) {
+            keptAfter.push_back(l);
+        }
+    }
+    bool reordered = keptBefore != keptAfter;
+
+    for (size_t pos = 0; pos < linksAfter.size(); pos++) {
+        const AssetLink& l  = linksAfter[pos];
+        auto             it = std::find(linksBefore.begin(), linksBefore.end(), l);
+        if (reordered || it == linksBefore.end() || !sameLinkAttributes(*it, l)) {
+            m_linksSet.emplace_back(pos, l);
+        }
+    }
+}
+
+const std::string& AssetDelta::getInternalName() const
+{
+    return m_internalName;
+}
+
+int AssetDelta::getVersion() const
+{
+    return m_version;
+}
+
+bool AssetDelta::empty() const
+{
+    return !m_assetStatus && !m_assetType && !m_assetSubtype && !m_priority && !m_parentIname && !m_secondaryID &&
+           !m_assetTag && m_extSet.empty() && m_extRemoved.empty() && m_linksSet.empty() && m_linksRemoved.empty();
+}
+
+void AssetDelta::apply(Asset& asset) const
+{
+    if (m_assetStatus) {
+        asset.setAssetStatus(*m_assetStatus);
+    }
+    if (m_assetType) {
+        asset.setAssetType(*m_assetType);
+    }
+    if (m_assetSubtype) {
+        asset.setAssetSubtype(*m_assetSubtype);
+    }
+    if (m_priority) {
+        asset.setPriority(*m_priority);
+    }
+    if (m_parentIname) {
+        asset.setParentIname(*m_parentIname);
+    }
+    if (m_secondaryID) {
+        asset.setSecondaryID(*m_secondaryID);
+    }
+    if (m_assetTag) {
+        asset.setAssetTag(*m_assetTag);
+    }
+
+    if (!m_extSet.empty() || !m_extRemoved.empty()) {
+        Asset::ExtMap ext = asset.getExt();
+        for (const auto& e : m_extSet) {
+            ext[e.first] = e.second;
+        }
+        for (const auto& key : m_extRemoved) {
+            ext.erase(key);
+        }
+        asset.setExtMap(ext);
+    }
+
+    if (!m_linksSet.empty() || !m_linksRemoved.empty()) {
+        std::vector<AssetLink> links = asset.getLinkedAssets();
+        for (const auto& l : m_linksRemoved) {
+            links.erase(std::remove(links.begin(), links.end(), l), links.end());
+        }
+        // remaining links are in the after order, links set are inserted back at their position
+        for (const auto& l : m_linksSet) {
+            links.erase(std::remove(links.begin(), links.end(), l.second), links.end());
+        }
+        for (const auto& l : m_linksSet) {
+            size_t pos = std::min(l.first, links.size());
+            links.insert(links.begin() + std::ptrdiff_t(pos), l.second);
+        }
+        asset.setLinkedAssets(links);
+    }
+}
+
+static void serializeLinks(
+    cxxtools::SerializationInfo& si, const char* name, const std::vector<AssetLink>& links)
+{
+    cxxtools::SerializationInfo& siLinks = si.addMember(name);
+    for (const auto& l : links) {
+        cxxtools::SerializationInfo& link = siLinks.addMember("");
+        link <<= l;
+        link.setCategory(cxxtools::SerializationInfo::Category::Object);
+    }
+    siLinks.setCategory(cxxtools::SerializationInfo::Category::Array);
+}
+
+static void serializeLinks(
+    cxxtools::SerializationInfo& si, const char* name, const std::vector<std::pair<size_t, AssetLink>>& links)
+{
+    cxxtools::SerializationInfo& siLinks = si.addMember(name);
+    for (const auto& l : links) {
+        cxxtools::SerializationInfo& link = siLinks.addMember("");
+        link <<= l.second;
+        link.addMember(SI_DELTA_LINK_POSITION) <<= uint64_t(l.first);
+        link.setCategory(cxxtools::SerializationInfo::Category::Object);
+    }
+    siLinks.setCategory(cxxtools::SerializationInfo::Category::Array);
+}
+
+static void deserializeLinks(
+    const cxxtools::SerializationInfo& si, const char* name, std::vector<AssetLink>& links)
+{
+    links.clear();
+    const cxxtools::SerializationInfo* siLinks = si.findMember(name);
+    if (siLinks == nullptr) {
+        return;
+    }
+    for (const auto& siLink : *siLinks) {
+        AssetLink l;
+        siLink >>= l;
+        links.push_back(l);
+    }
+}
+
+static void deserializeLinks(
+    const cxxtools::SerializationInfo& si, const char* name, std::vector<std::pair<size_t, AssetLink>>& links)
+{
+    links.clear();
+    const cxxtools::SerializationInfo* siLinks = si.findMember(name);
+    if (siLinks == nullptr) {
+        return;
+    }
+    for (const auto& siLink : *siLinks) {
+        AssetLink l;
+        siLink >>= l;
+        uint64_t position = 0;
+        siLink.getMember(SI_DELTA_LINK_POSITION) >>= position;
+        links.emplace_back(size_t(position), l);
+    }
+    // inserted in increasing position on apply
+    std::stable_sort(links.begin(), links.end(), [](const auto& l, const auto& r) {
+        return l.first < r.first;
+    });
+}
+
+// only the members that changed are present
+void AssetDelta::serialize(cxxtools::SerializationInfo& si) const
+{
+    si.addMember(SI_DELTA_VERSION) <<= m_version;
+    si.addMember(SI_NAME) <<= m_internalName;
+
+    if (m_assetStatus) {
+        si.addMember(SI_STATUS) <<= int(*m_assetStatus);
+    }
+    if (m_assetType) {
+        si.addMember(SI_TYPE) <<= *m_assetType;
+    }
+    if (m_assetSubtype) {
+        si.addMember(SI_SUB_TYPE) <<= *m_assetSubtype;
+    }
+    if (m_priority) {
+        si.addMember(SI_PRIORITY) <<= *m_priority;
+    }
+    if (m_parentIname) {
+        si.addMember(SI_PARENT) <<= *m_parentIname;
+    }
+    if (m_secondaryID) {
+        si.addMember(SI_SECONDARY_ID) <<= *m_secondaryID;
+    }
+    if (m_assetTag) {
+        si.addMember(SI_DELTA_ASSET_TAG) <<= *m_assetTag;
+    }
+
+    if (!m_extSet.empty()) {
+        cxxtools::SerializationInfo& ext = si.addMember(SI_EXT);
+        for (const auto& e : m_extSet) {
+            ext.addMember(e.first) <<= e.second;
+        }
+        ext.setCategory(cxxtools::SerializationInfo::Category::Object);
+    }
+    if (!m_extRemoved.empty()) {
+        si.addMember(SI_DELTA_EXT_REMOVED) <<= m_extRemoved;
+    }
+
+    if (!m_linksSet.empty()) {
+        serializeLinks(si, SI_DELTA_LINKS_SET, m_linksSet);
+    }
+    if (!m_linksRemoved.empty()) {
+        serializeLinks(si, SI_DELTA_LINKS_REMOVED, m_linksRemoved);
+    }
+}
+
+void AssetDelta::deserialize(const cxxtools::SerializationInfo& si)
+{
+    si.getMember(SI_DELTA_VERSION) >>= m_version;
+    if (m_version > VERSION) {
+        throw std::runtime_error("Unsupported asset delta version " + std::to_string(m_version));
+    }
+    si.getMember(SI_NAME) >>= m_internalName;
+
+    m_assetStatus.reset();
+    if (si.findMember(SI_STATUS) != nullptr) {
+        int tmpInt = 0;
+        si.getMember(SI_STATUS) >>= tmpInt;
+        m_assetStatus = AssetStatus(tmpInt);
+    }
+
+    auto getOptional = [&si](const char* name, std::optional<std::string>& member) {
+        member.reset();
+        if (si.findMember(name) != nullptr) {
+            std::string value;
+            si.getMember(name) >>= value;
+            member = value;
+        }
+    };
+    getOptional(SI_TYPE, m_assetType);
+    getOptional(SI_SUB_TYPE, m_assetSubtype);
+    getOptional(SI_PARENT, m_parentIname);
+    getOptional(SI_SECONDARY_ID, m_secondaryID);
+    getOptional(SI_DELTA_ASSET_TAG, m_assetTag);
+
+    m_priority.reset();
+    if (si.findMember(SI_PRIORITY) != nullptr) {
+        int priority = 0;
+        si.getMember(SI_PRIORITY) >>= priority;
+        m_priority = priority;
+    }
+
+    m_extSet.clear();
+    if (si.findMember(SI_EXT) != nullptr) {
+        for (const auto& siExt : si.getMember(SI_EXT)) {
+            ExtMapElement element;
+            siExt >>= element;
+            m_extSet[siExt.name()] = element;
+        }
+    }
+    m_extRemoved.clear();
+    if (si.findMember(SI_DELTA_EXT_REMOVED) != nullptr) {
+        si.getMember(SI_DELTA_EXT_REMOVED) >>= m_extRemoved;
+    }
+
+    deserializeLinks(si, SI_DELTA_LINKS_SET, m_linksSet);
+    deserializeLinks(si, SI_DELTA_LINKS_REMOVED, m_linksRemoved);
+}
+
+std::string AssetDelta::toJson(const AssetDelta& d)
+{
+    std::ostringstream output;
+
+    cxxtools::SerializationInfo si;
+    cxxtools::JsonSerializer    serializer(output);
+
+    si <<= d;
+    serializer.serialize(si);
+
+    return output.str();
+}
+
+void AssetDelta::fromJson(const std::string& json, AssetDelta& d)
+{
+    std::istringstream input(json);
+
+    cxxtools::SerializationInfo si;
+    cxxtools::JsonDeserializer  deserializer(input);
+
+    deserializer.deserialize(si);
+
+    si >>= d;
+}
+
+void operator<<=(cxxtools::SerializationInfo& si, const fty::AssetDelta& delta)
+{
+    delta.serialize(si);
+}
+
+void operator>>=(const cxxtools::SerializationInfo& si, fty::AssetDelta& delta)
+{
+    delta.deserialize(si);
+}
+
 } // namespace fty
 
@@ -79,3 +79,106 @@ TEST_CASE("Priority set")
     CHECK_NOTHROW(asset.setPriority("P1"));
     CHECK(asset.getPriority() == 1);
 }
+
+TEST_CASE("Asset delta")
+{
+    Asset before;
+    before.setInternalName("ups-1");
+    before.setAssetStatus(AssetStatus::Active);
+    before.setAssetType(TYPE_DEVICE);
+    before.setAssetSubtype(SUB_UPS);
+    before.setParentIname("rack-1");
+    before.setExtEntry("status.operating", "in_service");
+    before.setExtEntry("name", "UPS 1");
+    before.setExtEntry("old", "x");
+    before.addLink("epdu-1", "1", "2", 1, {});
+
+    SECTION("No change")
+    {
+        AssetDelta delta(before, before);
+        CHECK(delta.empty());
+        CHECK(delta.getInternalName() == "ups-1");
+    }
+
+    SECTION("Only changes are carried and applied")
+    {
+        Asset after = before;
+        after.setExtEntry("status.operating", "retired");
+        after.setExtEntry("new", "y");
+        after.setExtMap([&]() {
+            auto ext = after.getExt();
+            ext.erase("old");
+            return ext;
+        }());
+        after.removeLink("epdu-1", "1", "2", 1);
+        after.addLink("epdu-2", "1", "2", 1, {});
+        after.setPriority(2);
+
+        AssetDelta delta(before, after);
+        CHECK(!delta.empty());
+
+        std::string json = AssetDelta::toJson(delta);
+        CHECK(json.find("in_service") == std::string::npos);
+        CHECK(json.find("UPS 1") == std::string::npos);
+        CHECK(json.find("rack-1") == std::string::npos);
+
+        AssetDelta received;
+        AssetDelta::fromJson(json, received);
+        CHECK(received.getVersion() == AssetDelta::VERSION);
+
+        Asset applied = before;
+        received.apply(applied);
+        CHECK(applied == after);
+    }
+
+    SECTION("Asset tag")
+    {
+        Asset after = before;
+        after.setAssetTag("TAG-1");
+
+        AssetDelta delta(before, after);
+        CHECK(!delta.empty());
+
+        AssetDelta received;
+        AssetDelta::fromJson(AssetDelta::toJson(delta), received);
+
+        Asset applied = before;
+        received.apply(applied);
+        CHECK(applied.getAssetTag() == "TAG-1");
+        CHECK(applied == after);
+    }
+
+    SECTION("Link order is kept")
+    {
+        Asset first = before;
+        first.setLinkedAssets({AssetLink("epdu-1", "1", "2", 1), AssetLink("epdu-2", "1", "2", 1)});
+
+        // links inserted around a kept one
+        Asset inserted = first;
+        inserted.setLinkedAssets({AssetLink("epdu-0", "1", "2", 1), AssetLink("epdu-1", "1", "2", 1),
+            AssetLink("epdu-3", "1", "2", 1), AssetLink("epdu-2", "1", "2", 1)});
+        // same links, other order
+        Asset reordered = first;
+        reordered.setLinkedAssets({AssetLink("epdu-2", "1", "2", 1), AssetLink("epdu-1", "1", "2", 1)});
+
+        for (const Asset& after : {inserted, reordered}) {
+            AssetDelta received;
+            AssetDelta::fromJson(AssetDelta::toJson(AssetDelta(first, after)), received);
+
+            Asset applied = first;
+            received.apply(applied);
+            CHECK(applied == after);
+        }
+    }
+
+    SECTION("Newer version is rejected")
+    {
+        std::string json = AssetDelta::toJson(AssetDelta(before, before));
+        auto        pos  = json.find("\"version\":1");
+        REQUIRE(pos != std::string::npos);
+        json.replace(pos, 11, "\"version\":99");
+
+        AssetDelta delta;
+        CHECK_THROWS(AssetDelta::fromJson(json, delta));
+    }
+}
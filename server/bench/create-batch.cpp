@@ -0,0 +1,61 @@
+#include "asset.h"
+#include "request-stats.h"
+#include <catch2/catch.hpp>
+#include <cinttypes>
+#include <cstdlib>
+#include <czmq.h>
+#include <fty_common_asset_types.h>
+#include <fty_common_db_dbpath.h>
+#include <fty_log.h>
+#include <test-db/sample-db.h>
+
+static std::vector<fty::AssetImpl> benchAssets(const std::string& prefix, int count)
+{
+    std::vector<fty::AssetImpl> assets;
+    for (int i = 0; i < count; i++) {
+        fty::AssetImpl asset;
+        asset.setInternalName(prefix + std::to_string(i));
+        asset.setAssetType(fty::TYPE_DEVICE);
+        asset.setAssetSubtype(fty::SUB_UPS);
+        asset.setAssetStatus(fty::AssetStatus::Nonactive);
+        asset.setParentIname("bench-dc");
+        asset.setExtEntry("name", prefix + std::to_string(i));
+        assets.push_back(asset);
+    }
+    return assets;
+}
+
+TEST_CASE("Creation of 1000 assets, one by one vs one batch")
+{
+    fty::SampleDb db(R"(
+        items:
+            - type     : Datacenter
+              name     : bench-dc
+              ext-name : Bench DC
+    )");
+    DBConn::url = getenv("DBURL");
+
+    std::vector<fty::AssetImpl> single = benchAssets("ups-single-", 1000);
+    uint64_t                    start   = zclock_usecs();
+    uint64_t                    queries = fty::RequestStats::dbQueries();
+    for (auto& asset : single) {
+        asset.create();
+    }
+    uint64_t singleTime    = zclock_usecs() - start;
+    uint64_t singleQueries = fty::RequestStats::dbQueries() - queries;
+
+    std::vector<fty::AssetImpl> batch = benchAssets("ups-batch-", 1000);
+    start   = zclock_usecs();
+    queries = fty::RequestStats::dbQueries();
+    fty::AssetImpl::createBatch(batch);
+    uint64_t batchTime    = zclock_usecs() - start;
+    uint64_t batchQueries = fty::RequestStats::dbQueries() - queries;
+
+    log_info("%zu assets, one by one %" PRIu64 " us / %" PRIu64 " queries, batch %" PRIu64 " us / %" PRIu64
+             " queries",
+        batch.size(), singleTime, singleQueries, batchTime, batchQueries);
+
+    REQUIRE(fty::AssetImpl::loadList({batch.front().getInternalName(), batch.back().getInternalName()}).size() == 2);
+    // one statement per table and per chunk instead of several per asset
+    CHECK(batchQueries * 10 <= singleQueries);
+}
@@ -0,0 +1,98 @@
+#include "asset-stream-data.h"
+#include "asset.h"
+#include "fty_asset_server.h"
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <cinttypes>
+#include <fty_common_asset_types.h>
+#include <fty_log.h>
+#include <malamute.h>
+
+// synthetic asset ups-<n>
+static AssetStreamData benchAsset(size_t n)
+{
+    AssetStreamData data;
+    data.found     = true;
+    data.id        = static_cast<uint32_t>(n);
+    data.name      = "ups-" + std::to_string(n);
+    data.typeId    = persist::asset_type::DEVICE;
+    data.subtypeId = persist::asset_subtype::UPS;
+    data.status    = "active";
+    data.parents.assign(ASSET_STREAM_MAX_PARENTS, "");
+    data.ext.emplace_back("uuid", "00000000-0000-0000-0000-000000000000");
+    data.ext.emplace_back("create_ts", "2020-01-01T00:00:00+0000");
+    return data;
+}
+
+TEST_CASE("Mailbox latency while a republish of 5000 assets is running")
+{
+    // assets served by the test storage
+    g_testMode = true;
+
+    std::string endpoint = "inproc://fty_asset_server-bench";
+    std::string agent    = "asset_agent_bench";
+
+    zactor_t* server = zactor_new(mlm_server, const_cast<char*>("Malamute"));
+    zstr_sendx(server, "BIND", endpoint.c_str(), NULL);
+
+    zactor_t* assetServer = zactor_new(fty_asset_server, const_cast<char*>(agent.c_str()));
+    zstr_sendx(assetServer, "CONNECTSTREAM", endpoint.c_str(), NULL);
+    zsock_wait(assetServer);
+    zstr_sendx(assetServer, "PRODUCER", "ASSETS-BENCH", NULL);
+    zsock_wait(assetServer);
+    zstr_sendx(assetServer, "CONNECTMAILBOX", endpoint.c_str(), NULL);
+    zsock_wait(assetServer);
+
+    mlm_client_t* client = mlm_client_new();
+    mlm_client_connect(client, endpoint.c_str(), 5000, "fty-asset-bench");
+
+    set_assets_stream_data_loader([](const std::string& /*client_name*/, const std::set<std::string>* names,
+                                      std::vector<AssetStreamData>& assets, bool /*test_mode*/) {
+        for (size_t i = 1; i <= 5000; i++) {
+            if (!names || names->count("ups-" + std::to_string(i))) {
+                assets.push_back(benchAsset(i));
+            }
+        }
+        return 0;
+    });
+
+    // first REPEAT_ALL publishes everything at once, later ones are scheduled
+    zstr_sendx(assetServer, "REPEAT_ALL", NULL);
+
+    auto p99 = [&](const char* rate, const char* slice) -> int64_t {
+        zstr_sendx(assetServer, "REPEAT_RATE", rate, NULL);
+        zsock_wait(assetServer);
+        zstr_sendx(assetServer, "REPEAT_SLICE", slice, NULL);
+        zsock_wait(assetServer);
+        zstr_sendx(assetServer, "REPEAT_ALL", NULL);
+        zclock_sleep(10);
+
+        std::vector<int64_t> latencies;
+        for (int i = 0; i < 200; i++) {
+            int64_t start = zclock_usecs();
+            zmsg_t* msg   = zmsg_new();
+            zmsg_addstr(msg, TEST_INAME);
+            mlm_client_sendto(client, agent.c_str(), "ENAME_FROM_INAME", NULL, 5000, &msg);
+            zmsg_t* reply = mlm_client_recv(client);
+            latencies.push_back(zclock_usecs() - start);
+            CHECK(reply);
+            zmsg_destroy(&reply);
+        }
+        std::sort(latencies.begin(), latencies.end());
+        return latencies[latencies.size() * 99 / 100];
+    };
+
+    int64_t oneLoop = p99("0", "1000000");
+    int64_t sliced  = p99("0", "50");
+    int64_t paced   = p99("2000", "50");
+
+    log_info("ENAME_FROM_INAME p99 during republish of 5000 assets: single loop %" PRIi64 " us, slices %" PRIi64
+             " us, paced %" PRIi64 " us",
+        oneLoop, sliced, paced);
+
+    set_assets_stream_data_loader(AssetStreamDataLoader());
+    mlm_client_destroy(&client);
+    zactor_destroy(&assetServer);
+    zactor_destroy(&server);
+    g_testMode = false;
+}
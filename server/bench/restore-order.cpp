@@ -0,0 +1,45 @@
+#include "asset.h"
+#include <catch2/catch.hpp>
+#include <cinttypes>
+#include <czmq.h>
+#include <fty_log.h>
+#include <set>
+
+TEST_CASE("Restore order of deep and wide hierarchies of 20k assets")
+{
+    const int count = 20000;
+
+    // deep: one chain, listed children first
+    std::vector<fty::AssetImpl> deep(count);
+    for (int i = 0; i < count; i++) {
+        int level = count - 1 - i;
+        deep[i].setInternalName("deep-" + std::to_string(level));
+        deep[i].setParentIname(level == 0 ? "" : "deep-" + std::to_string(level - 1));
+    }
+
+    // wide: 100 datacenters of 199 children, listed children first
+    std::vector<fty::AssetImpl> wide(count);
+    for (int i = 0; i < count; i++) {
+        if (i < count - 100) {
+            wide[i].setInternalName("wide-child-" + std::to_string(i));
+            wide[i].setParentIname("wide-dc-" + std::to_string(i % 100));
+        } else {
+            wide[i].setInternalName("wide-dc-" + std::to_string(i - (count - 100)));
+        }
+    }
+
+    for (auto* assets : {&deep, &wide}) {
+        uint64_t start = zclock_usecs();
+        fty::AssetImpl::sortParentsFirst(*assets);
+        uint64_t time = zclock_usecs() - start;
+
+        log_info("%s hierarchy of %d assets ordered in %" PRIu64 " us", assets == &deep ? "deep" : "wide", count, time);
+
+        REQUIRE(assets->size() == size_t(count));
+        std::set<std::string> restored;
+        for (const auto& asset : *assets) {
+            CHECK((asset.getParentIname().empty() || restored.count(asset.getParentIname())));
+            restored.insert(asset.getInternalName());
+        }
+    }
+}
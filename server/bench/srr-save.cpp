@@ -0,0 +1,35 @@
+#include "asset.h"
+#include <catch2/catch.hpp>
+#include <cinttypes>
+#include <czmq.h>
+#include <fstream>
+#include <fty_log.h>
+#include <sys/resource.h>
+
+TEST_CASE("SRR save of 10k and 100k assets streamed with bounded memory")
+{
+    // assets served by the test storage
+    g_testMode = true;
+
+    for (size_t count : {10000, 100000}) {
+        std::vector<std::string> inames;
+        for (size_t i = 0; i < count; i++) {
+            inames.push_back("srr-" + std::to_string(i));
+        }
+
+        struct rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+        long before = usage.ru_maxrss;
+
+        std::ofstream out("/dev/null");
+        uint64_t      start = zclock_usecs();
+        fty::AssetImpl::assetsToSrr(inames, out);
+        uint64_t time = zclock_usecs() - start;
+
+        getrusage(RUSAGE_SELF, &usage);
+        log_info("%zu assets saved in %" PRIu64 " us, peak RSS %ld kB -> %ld kB", count, time, before, usage.ru_maxrss);
+        CHECK(out.good());
+    }
+
+    g_testMode = false;
+}
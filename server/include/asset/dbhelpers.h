@@ -28,6 +28,7 @@
 #include <functional>
 #include <string>
 #include <map>
+#include <set>
 #include <unordered_map>
 #include <vector>
 #include <tuple>
@@ -86,6 +87,52 @@
                 const tntdb::Row&
                 )>& cb, bool test);
 
+// Selects basic asset info (as select_asset_element_basic) of all assets in one query
+ int
+    select_asset_element_basic_all
+        (std::function<void(const tntdb::Row&)> cb,
+         bool test);
+
+// Selects ext attributes of all assets in one query, ordered by asset id
+ int
+    select_ext_attributes_all
+        (std::function<void(const tntdb::Row&)> cb,
+         bool test);
+
+// Selects basic asset info (as select_asset_element_basic_all) of the given assets only
+ int
+    select_asset_element_basic_by_names
+        (const std::set<std::string>& names,
+         std::function<void(const tntdb::Row&)> cb,
+         bool test);
+
+ int
+    select_asset_element_basic_by_ids
+        (const std::set<uint32_t>& ids,
+         std::function<void(const tntdb::Row&)> cb,
+         bool test);
+
+// Selects parent id and ancestor names of the given assets only
+ int
+    select_asset_element_parents_by_names
+        (const std::set<std::string>& names,
+         std::function<void(const tntdb::Row&)> cb,
+         bool test);
+
+// Selects ext attributes (as select_ext_attributes_all) of the given assets only
+ int
+    select_ext_attributes_by_ids
+        (const std::set<uint32_t>& ids,
+         std::function<void(const tntdb::Row&)> cb,
+         bool test);
+
+// Selects assets missing uuid or create_ts ext attribute (all assets if asset_name is empty)
+ int
+    select_assets_missing_uuid_create_ts
+        (const std::string& asset_name,
+         std::function<void(const tntdb::Row&)> cb,
+         bool test);
+
 //////////////////////////////////////////////////////////////////////////////////
 
 // Inserts ext attributes from inventory message into DB
@@ -96,6 +143,13 @@
     bool read_only,
     bool test);
 
+// Inserts ext attributes of several assets into DB in a single transaction
+ int
+    process_insert_inventory_batch
+    (const std::map<std::string, std::map<std::string, std::string>>& ext_attributes,
+    bool read_only,
+    bool test);
+
 // Inserts ext attributes from inventory message into DB if not present in the cache
  int
     process_insert_inventory
@@ -0,0 +1,199 @@
+/*  =========================================================================
+    asset-msg-cache - cache of encoded ASSETS stream messages
+
+    Copyright (C) 2014 - 2020 Eaton
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+    =========================================================================
+*/
+
+#include "asset-msg-cache.h"
+#include "fty-lock.h"
+
+#include <czmq.h>
+
+namespace fty {
+
+// per entry overhead of the hash map, of the lru list and of the message frames
+static constexpr size_t ENTRY_BYTES = 256;
+
+// caches of the process, see invalidateAll()
+static std::mutex               s_cachesLock;
+static std::set<AssetMsgCache*> s_caches;
+
+AssetMsgCache::AssetMsgCache(size_t budget, std::chrono::seconds ttl)
+    : m_budget(budget)
+    , m_ttl(ttl)
+{
+    Lock lock(s_cachesLock);
+    s_caches.insert(this);
+}
+
+AssetMsgCache::~AssetMsgCache()
+{
+    {
+        Lock lock(s_cachesLock);
+        s_caches.erase(this);
+    }
+    clear();
+}
+
+void AssetMsgCache::setBudget(size_t bytes)
+{
+    Lock lock(m_lock);
+    m_budget = bytes;
+    trim();
+}
+
+void AssetMsgCache::setTtl(std::chrono::seconds ttl)
+{
+    Lock lock(m_lock);
+    m_ttl = ttl;
+}
+
+zmsg_t* AssetMsgCache::get(const std::string& iname, const std::string& operation, std::string& subject)
+{
+    Lock lock(m_lock);
+
+    auto it = m_entries.find(iname);
+    if (it == m_entries.end() || it->second.operation != operation) {
+        m_misses++;
+        return NULL;
+    }
+    if (Clock::now() - it->second.encoded > m_ttl) {
+        erase(iname);
+        m_misses++;
+        return NULL;
+    }
+    m_hits++;
+    m_lru.splice(m_lru.begin(), m_lru, it->second.lru);
+    subject = it->second.subject;
+    return zmsg_dup(it->second.msg);
+}
+
+uint64_t AssetMsgCache::generation() const
+{
+    Lock lock(m_lock);
+    return m_generation;
+}
+
+void AssetMsgCache::put(const std::string& iname, const std::string& operation, const std::string& subject,
+    zmsg_t* msg, uint64_t generation)
+{
+    Lock lock(m_lock);
+
+    // asset may have been written while its message was encoded
+    if (generation != m_generation) {
+        return;
+    }
+    erase(iname);
+
+    // subject is <type>.<subtype>@<iname>
+    bool datacenter = subject.compare(0, 11, "datacenter.") == 0;
+    if (datacenter) {
+        m_datacenters.insert(iname);
+    }
+    size_t bytes = ENTRY_BYTES + 2 * iname.size() + operation.size() + subject.size() + zmsg_content_size(msg);
+
+    m_lru.push_front(iname);
+    m_entries.emplace(iname, Entry{operation, subject, zmsg_dup(msg), datacenter, bytes, Clock::now(), m_lru.begin()});
+    m_bytes += bytes;
+    trim();
+}
+
+void AssetMsgCache::invalidate(const std::string& iname)
+{
+    Lock lock(m_lock);
+
+    erase(iname);
+
+    std::set<std::string> datacenters;
+    datacenters.swap(m_datacenters);
+    for (const auto& dc : datacenters) {
+        erase(dc);
+    }
+    m_generation++;
+}
+
+void AssetMsgCache::clear()
+{
+    Lock lock(m_lock);
+
+    for (auto& it : m_entries) {
+        zmsg_destroy(&it.second.msg);
+    }
+    m_entries.clear();
+    m_lru.clear();
+    m_datacenters.clear();
+    m_bytes = 0;
+    m_generation++;
+}
+
+void AssetMsgCache::invalidateAll(const std::string& iname)
+{
+    Lock lock(s_cachesLock);
+    for (auto cache : s_caches) {
+        cache->invalidate(iname);
+    }
+}
+
+uint64_t AssetMsgCache::hits() const
+{
+    Lock lock(m_lock);
+    return m_hits;
+}
+
+uint64_t AssetMsgCache::misses() const
+{
+    Lock lock(m_lock);
+    return m_misses;
+}
+
+size_t AssetMsgCache::size() const
+{
+    Lock lock(m_lock);
+    return m_entries.size();
+}
+
+size_t AssetMsgCache::bytes() const
+{
+    Lock lock(m_lock);
+    return m_bytes;
+}
+
+void AssetMsgCache::erase(const std::string& iname)
+{
+    auto it = m_entries.find(iname);
+    if (it == m_entries.end()) {
+        return;
+    }
+    if (it->second.datacenter) {
+        m_datacenters.erase(iname);
+    }
+    zmsg_destroy(&it->second.msg);
+    m_bytes -= it->second.bytes;
+    m_lru.erase(it->second.lru);
+    m_entries.erase(it);
+}
+
+// messages not used for longest go first
+void AssetMsgCache::trim()
+{
+    while (m_bytes > m_budget && !m_lru.empty()) {
+        erase(m_lru.back());
+    }
+}
+
+} // namespace fty
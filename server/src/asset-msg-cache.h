@@ -0,0 +1,106 @@
+/*  =========================================================================
+    asset-msg-cache - cache of encoded ASSETS stream messages
+
+    Copyright (C) 2014 - 2020 Eaton
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+    =========================================================================
+*/
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <set>
+#include <string>
+#include <unordered_map>
+
+typedef struct _zmsg_t zmsg_t;
+
+namespace fty {
+
+// Encoded fty_proto asset messages by asset iname, so that an asset can be sent again
+// without reading the database. Messages are copied on insert and on lookup.
+// Datacenter messages carry the list of their upses, so they are dropped on any invalidation.
+// Messages not used for longest are dropped over the budget, and messages older than ttl are
+// encoded again, so that changes nobody invalidated are seen.
+class AssetMsgCache
+{
+public:
+    explicit AssetMsgCache(
+        size_t budget = 16 * 1024 * 1024, std::chrono::seconds ttl = std::chrono::seconds(300));
+    ~AssetMsgCache();
+
+    AssetMsgCache(const AssetMsgCache&) = delete;
+    AssetMsgCache& operator=(const AssetMsgCache&) = delete;
+
+    // size of the cached messages, in bytes
+    void setBudget(size_t bytes);
+    void setTtl(std::chrono::seconds ttl);
+
+    // copy of the message of iname encoded with operation, NULL if not cached
+    zmsg_t* get(const std::string& iname, const std::string& operation, std::string& subject);
+
+    // to pass to put(), read before the data of the message
+    uint64_t generation() const;
+    // not kept if an invalidation happened since generation was read
+    void put(const std::string& iname, const std::string& operation, const std::string& subject, zmsg_t* msg,
+        uint64_t generation);
+
+    // asset content changed
+    void invalidate(const std::string& iname);
+    void clear();
+    // asset written in this process outside of the asset server (inventory), for every cache
+    static void invalidateAll(const std::string& iname);
+
+    uint64_t hits() const;
+    uint64_t misses() const;
+    size_t   size() const;
+    size_t   bytes() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Entry
+    {
+        std::string                      operation;
+        std::string                      subject;
+        zmsg_t*                          msg;
+        bool                             datacenter;
+        size_t                           bytes;
+        Clock::time_point                encoded;
+        std::list<std::string>::iterator lru;
+    };
+
+    size_t               m_budget;
+    std::chrono::seconds m_ttl;
+
+    mutable std::mutex                     m_lock;
+    std::unordered_map<std::string, Entry> m_entries;
+    std::list<std::string>                 m_lru; // most recently used first
+    std::set<std::string>                  m_datacenters;
+    size_t                                 m_bytes      = 0;
+    uint64_t                               m_generation = 0;
+    uint64_t                               m_hits       = 0;
+    uint64_t                               m_misses     = 0;
+
+    // called locked
+    void erase(const std::string& iname);
+    void trim();
+};
+
+} // namespace fty
@@ -0,0 +1,115 @@
+/*  =========================================================================
+    asset-notification - payloads of asset change notifications
+
+    Copyright (C) 2014 - 2020 Eaton
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+    =========================================================================
+*/
+
+#include "asset-notification.h"
+#include "asset-server.h"
+
+#include <fty_asset_dto.h>
+
+namespace fty {
+
+AssetNotification::AssetNotification(Operation operation, const std::string& iname)
+    : m_operation(operation)
+    , m_iname(iname)
+    , m_delta(std::make_shared<const std::string>())
+{
+}
+
+void AssetNotification::setDelta(const Asset& before, const Asset& after)
+{
+    AssetDelta delta(before, after);
+    if (!delta.empty()) {
+        m_delta = std::make_shared<const std::string>(AssetDelta::toJson(delta));
+    }
+}
+
+AssetNotification AssetNotification::created(const Asset& asset)
+{
+    AssetNotification notification(Operation::Created, asset.getInternalName());
+    notification.m_asset   = std::make_shared<const std::string>(Asset::toJson(asset));
+    notification.m_payload = notification.m_asset;
+    notification.m_after   = std::make_shared<const Asset>(asset);
+    return notification;
+}
+
+AssetNotification AssetNotification::updated(const Asset& before, const Asset& after)
+{
+    AssetNotification notification(Operation::Updated, after.getInternalName());
+    notification.m_asset = std::make_shared<const std::string>(Asset::toJson(after));
+
+    // same output as serializing an object with "before" and "after" members, without copying
+    // both assets into another SerializationInfo
+    std::string beforeJson = Asset::toJson(before);
+    std::string payload;
+    payload.reserve(beforeJson.size() + notification.m_asset->size() + 22);
+    payload.append("{\"before\":").append(beforeJson);
+    payload.append(",\"after\":").append(*notification.m_asset).append("}");
+    notification.m_payload = std::make_shared<const std::string>(std::move(payload));
+    notification.m_after   = std::make_shared<const Asset>(after);
+    notification.setDelta(before, after);
+    return notification;
+}
+
+AssetNotification AssetNotification::updated(const std::string& json, const Asset& before, const Asset& after)
+{
+    AssetNotification notification(Operation::Updated, after.getInternalName());
+    notification.m_asset   = std::make_shared<const std::string>();
+    notification.m_payload = std::make_shared<const std::string>(json);
+    notification.m_after   = std::make_shared<const Asset>(after);
+    notification.setDelta(before, after);
+    return notification;
+}
+
+AssetNotification AssetNotification::deleted(const Asset& asset)
+{
+    AssetNotification notification(Operation::Deleted, asset.getInternalName());
+    notification.m_asset   = std::make_shared<const std::string>(Asset::toJson(asset));
+    notification.m_payload = notification.m_asset;
+    return notification;
+}
+
+const char* AssetNotification::subject() const
+{
+    switch (m_operation) {
+        case Operation::Created:
+            return FTY_ASSET_SUBJECT_CREATED;
+        case Operation::Updated:
+            return FTY_ASSET_SUBJECT_UPDATED;
+        case Operation::Deleted:
+            return FTY_ASSET_SUBJECT_DELETED;
+    }
+    return "";
+}
+
+const char* AssetNotification::lightSubject() const
+{
+    switch (m_operation) {
+        case Operation::Created:
+            return FTY_ASSET_SUBJECT_CREATED_L;
+        case Operation::Updated:
+            return FTY_ASSET_SUBJECT_UPDATED_L;
+        case Operation::Deleted:
+            return FTY_ASSET_SUBJECT_DELETED_L;
+    }
+    return "";
+}
+
+} // namespace fty
@@ -0,0 +1,101 @@
+/*  =========================================================================
+    asset-notification - payloads of asset change notifications
+
+    Copyright (C) 2014 - 2020 Eaton
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+    =========================================================================
+*/
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+namespace fty {
+
+class Asset;
+
+// Notification of one asset change. The asset is serialized once and the JSON buffers are shared,
+// read-only, by the reply, the full and light topics and the legacy ASSETS stream.
+class AssetNotification
+{
+public:
+    enum class Operation
+    {
+        Created,
+        Updated,
+        Deleted
+    };
+
+    static AssetNotification created(const Asset& asset);
+    static AssetNotification updated(const Asset& before, const Asset& after);
+    static AssetNotification deleted(const Asset& asset);
+    // json is the already serialized {"before": ..., "after": ...} payload of before and after
+    static AssetNotification updated(const std::string& json, const Asset& before, const Asset& after);
+
+    Operation operation() const
+    {
+        return m_operation;
+    }
+
+    const std::string& iname() const
+    {
+        return m_iname;
+    }
+
+    // payload of the full topic
+    const std::string& payload() const
+    {
+        return *m_payload;
+    }
+
+    // JSON of the asset after the change, empty if the payload was given already serialized
+    const std::string& asset() const
+    {
+        return *m_asset;
+    }
+
+    // asset after a creation or an update, NULL for a deletion; the legacy ASSETS stream message
+    // is built from it instead of reading the asset back from the DB
+    const Asset* after() const
+    {
+        return m_after.get();
+    }
+
+    // JSON of the AssetDelta of an update, empty if nothing changed or not an update
+    const std::string& delta() const
+    {
+        return *m_delta;
+    }
+
+    // subjects on the full and light topics
+    const char* subject() const;
+    const char* lightSubject() const;
+
+private:
+    AssetNotification(Operation operation, const std::string& iname);
+
+    Operation                          m_operation;
+    std::string                        m_iname;
+    std::shared_ptr<const std::string> m_payload;
+    std::shared_ptr<const std::string> m_asset;
+    std::shared_ptr<const std::string> m_delta;
+    std::shared_ptr<const Asset>       m_after;
+
+    void setDelta(const Asset& before, const Asset& after);
+};
+
+} // namespace fty
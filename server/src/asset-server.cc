@@ -47,8 +47,8 @@ using namespace std::placeholders;
 
 // REMOVE as soon as old interface is not needed anymore
 // fwd declaration
-void send_create_or_update_asset(
-    const fty::AssetServer& config, const std::string& asset_name, const char* operation, bool read_only);
+void send_create_or_update_assets(
+    const fty::AssetServer& config, const std::vector<const fty::Asset*>& assets, const char* operation);
 
 namespace fty {
 // ===========================================================================================================
@@ -70,6 +70,34 @@ static V value(const std::map<K, V>& map, const typename identify<K>::type& key,
     return def;
 }
 
+// output stream buffer appending to a string, so that the text written can be moved out instead of copied
+class StringAppendBuf : public std::streambuf
+{
+public:
+    explicit StringAppendBuf(std::string& out)
+        : m_out(out)
+    {
+    }
+
+protected:
+    int_type overflow(int_type ch) override
+    {
+        if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+            m_out.push_back(traits_type::to_char_type(ch));
+        }
+        return traits_type::not_eof(ch);
+    }
+
+    std::streamsize xsputn(const char* s, std::streamsize count) override
+    {
+        m_out.append(s, static_cast<size_t>(count));
+        return count;
+    }
+
+private:
+    std::string& m_out;
+};
+
 // ===========================================================================================================
 
 
@@ -143,6 +171,11 @@ void AssetServer::createPublisherClientNg()
         messagebus::MlmMessageBus(m_mailboxEndpoint, m_agentNameNg + "-delete-light"));
     log_debug("New publisher client registered to endpoint %s with name %s", m_mailboxEndpoint.c_str(),
         (m_agentNameNg + "-delete-light").c_str());
+
+    m_publisherUpdateDelta.reset(
+        messagebus::MlmMessageBus(m_mailboxEndpoint, m_agentNameNg + "-update-delta"));
+    log_debug("New publisher client registered to endpoint %s with name %s", m_mailboxEndpoint.c_str(),
+        (m_agentNameNg + "-update-delta").c_str());
 }
 
 void AssetServer::resetPublisherClientNg()
@@ -153,6 +186,7 @@ void AssetServer::resetPublisherClientNg()
     m_publisherCreateLight.reset();
     m_publisherUpdateLight.reset();
     m_publisherDeleteLight.reset();
+    m_publisherUpdateDelta.reset();
 }
 
 void AssetServer::connectPublisherClientNg()
@@ -163,6 +197,7 @@ void AssetServer::connectPublisherClientNg()
     m_publisherCreateLight->connect();
     m_publisherUpdateLight->connect();
     m_publisherDeleteLight->connect();
+    m_publisherUpdateDelta->connect();
 }
 
 // new generation asset manipulation handler
@@ -175,9 +210,12 @@ void AssetServer::handleAssetManipulationReq(const messagebus::Message& msg)
     static std::map<std::string, std::function<void(const messagebus::Message&)>> procMap = {
         { FTY_ASSET_SUBJECT_CREATE,       [&](const messagebus::Message& message){ createAsset(message); } },
         { FTY_ASSET_SUBJECT_UPDATE,       [&](const messagebus::Message& message){ updateAsset(message); } },
+        { FTY_ASSET_SUBJECT_CREATE_BATCH, [&](const messagebus::Message& message){ createAssetBatch(message); } },
+        { FTY_ASSET_SUBJECT_UPDATE_BATCH, [&](const messagebus::Message& message){ updateAssetBatch(message); } },
         { FTY_ASSET_SUBJECT_DELETE,       [&](const messagebus::Message& message){ deleteAsset(message); } },
         { FTY_ASSET_SUBJECT_GET,          [&](const messagebus::Message& message){ getAsset(message); } },
         { FTY_ASSET_SUBJECT_GET_BY_UUID,  [&](const messagebus::Message& message){ getAsset(message, true); } },
+        { FTY_ASSET_SUBJECT_GET_MANY,     [&](const messagebus::Message& message){ getAssets(message); } },
         { FTY_ASSET_SUBJECT_LIST,         [&](const messagebus::Message& message){ listAsset(message); } },
         { FTY_ASSET_SUBJECT_GET_ID,       [&](const messagebus::Message& message){ getAssetID(message); } },
         { FTY_ASSET_SUBJECT_GET_INAME,    [&](const messagebus::Message& message){ getAssetIname(message); } },
@@ -189,6 +227,7 @@ void AssetServer::handleAssetManipulationReq(const messagebus::Message& msg)
     const std::string& messageSubject = value(msg.metaData(), messagebus::Message::SUBJECT);
 
     if (procMap.find(messageSubject) != procMap.end()) {
+        RequestTimer timer(m_stats, messageSubject);
         procMap[messageSubject](msg);
     } else {
         log_warning("Handle asset manipulation - Unknown subject");
@@ -242,9 +281,12 @@ dto::srr::SaveResponse AssetServer::handleSave(const dto::srr::SaveQuery& query)
         if (featureName == FTY_ASSET_SRR_NAME) {
             f1.set_version(SRR_ACTIVE_VERSION);
             try {
-                Lock lock(m_srrLock);
-                auto savedAssets = saveAssets();
-                f1.set_data(JSON::writeToString(savedAssets, false));
+                Lock            lock(m_srrLock);
+                std::string     savedAssets;
+                StringAppendBuf buf(savedAssets);
+                std::ostream    out(&buf);
+                saveAssets(out);
+                f1.set_data(std::move(savedAssets));
                 fs1.mutable_status()->set_status(Status::SUCCESS);
             } catch (std::exception& e) {
                 fs1.mutable_status()->set_status(Status::FAILED);
@@ -256,7 +298,7 @@ dto::srr::SaveResponse AssetServer::handleSave(const dto::srr::SaveQuery& query)
             fs1.mutable_status()->set_error("Feature is not supported!");
         }
 
-        mapFeaturesData[featureName] = fs1;
+        mapFeaturesData[featureName] = std::move(fs1);
     }
 
     return (createSaveResponse(mapFeaturesData, SRR_ACTIVE_VERSION)).save();
@@ -275,8 +317,6 @@ dto::srr::RestoreResponse AssetServer::handleRestore(const dto::srr::RestoreQuer
         const Feature&     feature     = item.second;
 
         FeatureStatus featureStatus;
-        // backup current assets
-        cxxtools::SerializationInfo assetBackup = saveAssets();
 
         if (featureName == FTY_ASSET_SRR_NAME) {
             try {
@@ -317,6 +357,7 @@ dto::srr::ResetResponse AssetServer::handleReset(const dto::srr::ResetQuery& /*q
 
     try {
         AssetImpl::deleteAll(false);
+        m_msgCache.clear();
         featureStatus.set_status(Status::SUCCESS);
     }
     catch (std::exception& ex) {
@@ -330,42 +371,138 @@ dto::srr::ResetResponse AssetServer::handleReset(const dto::srr::ResetQuery& /*q
 }
 
 // sends create/update/delete notification on both new and old interface
-void AssetServer::sendNotification(const messagebus::Message& msg) const
+void AssetServer::sendNotification(const AssetNotification& notification, bool light) const
 {
-    const std::string& subject = msg.metaData().at(messagebus::Message::SUBJECT);
-
-    if (subject == FTY_ASSET_SUBJECT_CREATED) {
-        m_publisherCreate->publish(FTY_ASSET_TOPIC_CREATED, msg);
-
-        // REMOVE as soon as old interface is not needed anymore
-        // old interface
-        fty::Asset asset;
-        fty::Asset::fromJson(msg.userData().back(), asset);
-        send_create_or_update_asset(
-            *this, asset.getInternalName(), "create", false /* read_only is not used */);
-    } else if (subject == FTY_ASSET_SUBJECT_UPDATED) {
-        m_publisherUpdate->publish(FTY_ASSET_TOPIC_UPDATED, msg);
-
-        // REMOVE as soon as old interface is not needed anymore
-        // old interface
-        cxxtools::SerializationInfo si;
-        JSON::readFromString(msg.userData().front(), si);
-        const cxxtools::SerializationInfo& after = si.getMember("after");
-
-        fty::Asset asset;
-        // old interface replies only with updated asset
-        after >>= asset;
-
-        send_create_or_update_asset(
-            *this, asset.getInternalName(), "update", false /* read_only is not used */);
-    } else if (subject == FTY_ASSET_SUBJECT_DELETED) {
-        m_publisherDelete->publish(FTY_ASSET_TOPIC_DELETED, msg);
-    } else if (subject == FTY_ASSET_SUBJECT_CREATED_L) {
-        m_publisherCreateLight->publish(FTY_ASSET_TOPIC_CREATED_L, msg);
-    } else if (subject == FTY_ASSET_SUBJECT_UPDATED_L) {
-        m_publisherUpdateLight->publish(FTY_ASSET_TOPIC_UPDATED_L, msg);
-    } else if (subject == FTY_ASSET_SUBJECT_DELETED_L) {
-        m_publisherDeleteLight->publish(FTY_ASSET_TOPIC_DELETED_L, msg);
+    sendNotifications({notification}, light);
+}
+
+void AssetServer::sendNotifications(const std::vector<AssetNotification>& notifications, bool light) const
+{
+    // REMOVE as soon as old interface is not needed anymore
+    // old interface replies only with created or updated assets, built from the notified ones
+    std::vector<const Asset*> created;
+    std::vector<const Asset*> updated;
+
+    for (const auto& notification : notifications) {
+        messagebus::Message msg = assetutils::createMessage(
+            notification.subject(), "", m_agentNameNg, "", messagebus::STATUS_OK, notification.payload());
+
+        switch (notification.operation()) {
+            case AssetNotification::Operation::Created:
+                m_publisherCreate->publish(FTY_ASSET_TOPIC_CREATED, msg);
+                created.push_back(notification.after());
+                break;
+            case AssetNotification::Operation::Updated:
+                m_publisherUpdate->publish(FTY_ASSET_TOPIC_UPDATED, msg);
+                if (!notification.delta().empty()) {
+                    m_publisherUpdateDelta->publish(FTY_ASSET_TOPIC_UPDATED_D,
+                        assetutils::createMessage(FTY_ASSET_SUBJECT_UPDATED_D, "", m_agentNameNg, "",
+                            messagebus::STATUS_OK, notification.delta()));
+                }
+                updated.push_back(notification.after());
+                break;
+            case AssetNotification::Operation::Deleted:
+                m_publisherDelete->publish(FTY_ASSET_TOPIC_DELETED, msg);
+                publishedDeleted(notification.iname());
+                break;
+        }
+
+        m_msgCache.invalidate(notification.iname());
+    }
+
+    send_create_or_update_assets(*this, created, "create");
+    send_create_or_update_assets(*this, updated, "update");
+
+    if (!light) {
+        return;
+    }
+
+    // light notification carries only the iname
+    for (const auto& notification : notifications) {
+        messagebus::Message msgLight = assetutils::createMessage(
+            notification.lightSubject(), "", m_agentNameNg, "", messagebus::STATUS_OK, notification.iname());
+
+        switch (notification.operation()) {
+            case AssetNotification::Operation::Created:
+                m_publisherCreateLight->publish(FTY_ASSET_TOPIC_CREATED_L, msgLight);
+                break;
+            case AssetNotification::Operation::Updated:
+                m_publisherUpdateLight->publish(FTY_ASSET_TOPIC_UPDATED_L, msgLight);
+                break;
+            case AssetNotification::Operation::Deleted:
+                m_publisherDeleteLight->publish(FTY_ASSET_TOPIC_DELETED_L, msgLight);
+                break;
+        }
+    }
+}
+
+// every N-th periodic republish sends all assets, others only the changed ones
+bool AssetServer::nextRepeatIsFull()
+{
+    bool full = (m_repeatFullCycle <= 1) || (m_repeatCycle % m_repeatFullCycle == 0);
+    m_repeatCycle++;
+    if (m_repeatFullCycle > 1) {
+        m_repeatCycle %= m_repeatFullCycle;
+    }
+    return full;
+}
+
+// stores hash of the message published for assetName, returns true if it differs from the previous one
+bool AssetServer::updatePublishedHash(const std::string& assetName, size_t hash) const
+{
+    Lock lock(m_publishedLock);
+
+    auto it = m_publishedHash.find(assetName);
+    if (it != m_publishedHash.end() && !it->second.deleted && it->second.hash == hash) {
+        return false;
+    }
+    m_publishedHash[assetName] = {hash, ++m_publishSequence, false};
+    return true;
+}
+
+// true if hash is the one of the last message published for assetName
+bool AssetServer::isPublishedHash(const std::string& assetName, size_t hash) const
+{
+    Lock lock(m_publishedLock);
+
+    auto it = m_publishedHash.find(assetName);
+    return it != m_publishedHash.end() && !it->second.deleted && it->second.hash == hash;
+}
+
+uint64_t AssetServer::getPublishSequence() const
+{
+    Lock lock(m_publishedLock);
+    return m_publishSequence;
+}
+
+// records that assetName was deleted, it is then seen as published since any earlier sequence
+void AssetServer::publishedDeleted(const std::string& assetName) const
+{
+    Lock lock(m_publishedLock);
+
+    m_publishedHash[assetName] = {0, ++m_publishSequence, true};
+}
+
+// true if a new message was published for assetName after sequence was read, or if it was deleted since
+bool AssetServer::publishedSince(const std::string& assetName, uint64_t sequence) const
+{
+    Lock lock(m_publishedLock);
+
+    auto it = m_publishedHash.find(assetName);
+    return it != m_publishedHash.end() && it->second.sequence > sequence;
+}
+
+// forgets hashes of assets which do not exist anymore
+void AssetServer::retainPublishedHashes(const std::set<std::string>& assetNames) const
+{
+    Lock lock(m_publishedLock);
+
+    for (auto it = m_publishedHash.begin(); it != m_publishedHash.end();) {
+        if (assetNames.count(it->first) == 0) {
+            it = m_publishedHash.erase(it);
+        } else {
+            ++it;
+        }
     }
 }
 
@@ -437,26 +574,20 @@ void AssetServer::createAsset(const messagebus::Message& msg)
         // update asset data
         asset.load();
 
+        // asset is serialized once for the response and the notifications
+        AssetNotification notification = AssetNotification::created(asset);
+
         auto response = assetutils::createMessage(FTY_ASSET_SUBJECT_CREATE,
             msg.metaData().find(messagebus::Message::CORRELATION_ID)->second, m_agentNameNg,
             msg.metaData().find(messagebus::Message::FROM)->second, messagebus::STATUS_OK,
-            fty::Asset::toJson(asset));
+            notification.asset());
 
         // send response
         log_debug("sending response to %s", msg.metaData().find(messagebus::Message::FROM)->second.c_str());
         m_assetMsgQueue->sendReply(msg.metaData().find(messagebus::Message::REPLY_TO)->second, response);
 
-        // full notification
-        messagebus::Message notification = assetutils::createMessage(FTY_ASSET_SUBJECT_CREATED, "",
-            m_agentNameNg, "", messagebus::STATUS_OK, fty::Asset::toJson(asset));
         sendNotification(notification);
 
-        // light notification
-        messagebus::Message notification_l = assetutils::createMessage(FTY_ASSET_SUBJECT_CREATED_L, "",
-            m_agentNameNg, "", messagebus::STATUS_OK, asset.getInternalName());
-        sendNotification(notification_l);
-
-
     } catch (std::exception& e) {
         log_error(e.what());
         // create response (error)
@@ -527,17 +658,24 @@ void AssetServer::updateAsset(const messagebus::Message& msg)
         // update data from db
         asset.load();
 
+        // asset is serialized once for the response and the notifications
+        AssetNotification notification = AssetNotification::updated(currentAsset, asset);
+
         // create response (ok)
         auto response = assetutils::createMessage(FTY_ASSET_SUBJECT_UPDATE,
             msg.metaData().find(messagebus::Message::CORRELATION_ID)->second, m_agentNameNg,
             msg.metaData().find(messagebus::Message::FROM)->second, messagebus::STATUS_OK,
-            fty::Asset::toJson(asset));
+            notification.asset());
 
         // send response
         log_debug("sending response to %s", msg.metaData().find(messagebus::Message::FROM)->second.c_str());
         m_assetMsgQueue->sendReply(msg.metaData().find(messagebus::Message::REPLY_TO)->second, response);
 
-        notifyAssetUpdate(currentAsset, asset);
+        try {
+            sendNotification(notification);
+        } catch (std::exception& e) {
+            log_error(e.what());
+        }
     } catch (const std::exception& e) {
         log_error(e.what());
         // create response (error)
@@ -552,6 +690,338 @@ void AssetServer::updateAsset(const messagebus::Message& msg)
     }
 }
 
+// one asset of a CREATE_BATCH, UPDATE_BATCH or GET_MANY request
+struct BatchItem
+{
+    AssetImpl   asset;
+    AssetImpl   current; // before update
+    bool        requestActivation   = false;
+    bool        requestDeactivation = false;
+    std::string error;   // empty if the item succeeded so far
+};
+
+static std::vector<BatchItem> parseBatch(const std::string& json)
+{
+    cxxtools::SerializationInfo si;
+    JSON::readFromString(json, si);
+    if (si.category() != cxxtools::SerializationInfo::Category::Array) {
+        throw std::runtime_error("Batch payload is not an array of assets");
+    }
+
+    std::vector<BatchItem> items(si.memberCount());
+    size_t                 i = 0;
+    for (const auto& siAsset : si) {
+        try {
+            siAsset >>= items[i].asset;
+        } catch (const std::exception& e) {
+            items[i].error = "Invalid asset: " + std::string(e.what());
+        }
+        i++;
+    }
+    return items;
+}
+
+// reloads the written assets with one bulk load
+static void reloadBatch(std::vector<BatchItem>& items)
+{
+    std::vector<std::string> inames;
+    for (const auto& item : items) {
+        if (item.error.empty()) {
+            inames.push_back(item.asset.getInternalName());
+        }
+    }
+
+    std::map<std::string, AssetImpl> loaded;
+    for (auto& asset : AssetImpl::loadList(inames)) {
+        loaded.emplace(asset.getInternalName(), asset);
+    }
+    for (auto& item : items) {
+        if (!item.error.empty()) {
+            continue;
+        }
+        auto it = loaded.find(item.asset.getInternalName());
+        if (it == loaded.end()) {
+            item.error = "Asset " + item.asset.getInternalName() + " not found after write";
+        } else {
+            item.asset = it->second;
+        }
+    }
+}
+
+// activation of the devices of a batch requesting it, once the batch is written non active. The activator
+// handles one asset per request; each device is checked once the previous ones are active, so that the
+// devices of the batch count against the license. Statuses of the activated devices are then written in
+// one transaction. Devices over the license stay non active with tryActivate, or are returned in refused;
+// devices whose activation failed are returned in failed.
+static void activateBatchItems(
+    std::vector<BatchItem>& items, bool tryActivate, std::vector<BatchItem*>& refused, std::vector<BatchItem*>& failed)
+{
+    std::vector<std::string> activated;
+    for (auto& item : items) {
+        if (!item.error.empty() || !item.requestActivation) {
+            continue;
+        }
+        if (!item.asset.isActivable()) {
+            if (!tryActivate) {
+                item.error =
+                    "Licensing limitation hit - maximum amount of active power devices allowed in license reached.";
+                refused.push_back(&item);
+            }
+            continue;
+        }
+        if (!AssetImpl::activateBatch({&item.asset})[0]) {
+            item.error = "Activation of asset " + item.asset.getInternalName() + " failed";
+            failed.push_back(&item);
+            continue;
+        }
+        activated.push_back(item.asset.getInternalName());
+    }
+
+    try {
+        AssetImpl::updateStatusBatch(activated, AssetStatus::Active);
+    } catch (const std::exception& e) {
+        // activated assets are reloaded non active
+        log_error("Status of %zu activated assets not written: %s", activated.size(), e.what());
+    }
+}
+
+// [{"status": "OK", "asset": {...}} or {"status": "KO", "error": "..."}], in request order
+static std::string serializeBatchStatus(const std::vector<BatchItem>& items)
+{
+    cxxtools::SerializationInfo si;
+
+    for (const auto& item : items) {
+        cxxtools::SerializationInfo& status = si.addMember("");
+        if (item.error.empty()) {
+            status.addMember("status") <<= std::string("OK");
+            cxxtools::SerializationInfo& asset = status.addMember("asset");
+            asset <<= item.asset;
+            asset.setCategory(cxxtools::SerializationInfo::Category::Object);
+        } else {
+            status.addMember("status") <<= std::string("KO");
+            status.addMember("error") <<= item.error;
+        }
+        status.setCategory(cxxtools::SerializationInfo::Category::Object);
+    }
+
+    si.setCategory(cxxtools::SerializationInfo::Category::Array);
+
+    return JSON::writeToString(si, false);
+}
+
+void AssetServer::createAssetBatch(const messagebus::Message& msg)
+{
+    log_debug("subject CREATE_BATCH");
+
+    bool tryActivate = value(msg.metaData(), METADATA_TRY_ACTIVATE) == "true";
+
+    messagebus::Message response;
+    try {
+        // asset manipulation is disabled
+        if (getGlobalConfigurability() == 0) {
+            throw std::runtime_error("Licensing limitation hit - asset manipulation is prohibited");
+        }
+
+        std::vector<BatchItem> items = parseBatch(msg.userData().front());
+
+        // devices are inserted non active, licensing is checked when they are activated;
+        // other assets need no license and are inserted as sent
+        std::vector<AssetImpl> toCreate;
+        std::vector<size_t>    positions;
+        for (size_t i = 0; i < items.size(); i++) {
+            BatchItem& item = items[i];
+            if (!item.error.empty()) {
+                continue;
+            }
+
+            item.requestActivation =
+                (item.asset.getAssetStatus() == AssetStatus::Active && item.asset.getAssetType() == TYPE_DEVICE);
+            if (item.requestActivation) {
+                item.asset.setAssetStatus(AssetStatus::Nonactive);
+            }
+            toCreate.push_back(item.asset);
+            positions.push_back(i);
+        }
+
+        // all valid assets are created, or none is
+        if (!toCreate.empty()) {
+            try {
+                AssetImpl::createBatch(toCreate);
+                for (size_t i = 0; i < positions.size(); i++) {
+                    items[positions[i]].asset = toCreate[i];
+                }
+            } catch (const std::exception& e) {
+                log_error("CREATE_BATCH failed: %s", e.what());
+                for (size_t position : positions) {
+                    items[position].error = "An error occurred while creating asset. " + std::string(e.what());
+                }
+            }
+        }
+
+        std::vector<BatchItem*> refused;
+        std::vector<BatchItem*> failed;
+        activateBatchItems(items, tryActivate, refused, failed);
+        // assets refused by the license or whose activation failed are deleted
+        std::vector<std::string> toDelete;
+        for (const auto* item : refused) {
+            toDelete.push_back(item->asset.getInternalName());
+        }
+        for (const auto* item : failed) {
+            toDelete.push_back(item->asset.getInternalName());
+        }
+        if (!toDelete.empty()) {
+            AssetImpl::deleteList(toDelete, false);
+        }
+
+        reloadBatch(items);
+
+        response = assetutils::createMessage(FTY_ASSET_SUBJECT_CREATE_BATCH,
+            value(msg.metaData(), messagebus::Message::CORRELATION_ID), m_agentNameNg,
+            value(msg.metaData(), messagebus::Message::FROM), messagebus::STATUS_OK, serializeBatchStatus(items));
+
+        // notifications of the created assets, once the whole batch is written
+        std::vector<AssetNotification> notifications;
+        for (const auto& item : items) {
+            if (item.error.empty()) {
+                notifications.push_back(AssetNotification::created(item.asset));
+            }
+        }
+        sendNotifications(notifications);
+    } catch (const std::exception& e) {
+        log_error(e.what());
+        response = assetutils::createMessage(FTY_ASSET_SUBJECT_CREATE_BATCH,
+            value(msg.metaData(), messagebus::Message::CORRELATION_ID), m_agentNameNg,
+            value(msg.metaData(), messagebus::Message::FROM), messagebus::STATUS_KO,
+            "An error occurred while creating assets. " + std::string(e.what()));
+    }
+
+    log_debug("sending response to %s", value(msg.metaData(), messagebus::Message::FROM).c_str());
+    m_assetMsgQueue->sendReply(value(msg.metaData(), messagebus::Message::REPLY_TO), response);
+}
+
+void AssetServer::updateAssetBatch(const messagebus::Message& msg)
+{
+    log_debug("subject UPDATE_BATCH");
+
+    bool tryActivate = value(msg.metaData(), METADATA_TRY_ACTIVATE) == "true";
+
+    messagebus::Message response;
+    try {
+        // asset manipulation is disabled
+        if (getGlobalConfigurability() == 0) {
+            throw std::runtime_error("Licensing limitation hit - asset manipulation is prohibited");
+        }
+
+        std::vector<BatchItem> items = parseBatch(msg.userData().front());
+
+        // get current assets data from storage
+        std::vector<std::string> inames;
+        for (const auto& item : items) {
+            if (item.error.empty()) {
+                inames.push_back(item.asset.getInternalName());
+            }
+        }
+        std::map<std::string, AssetImpl> current;
+        for (auto& asset : AssetImpl::loadList(inames)) {
+            current.emplace(asset.getInternalName(), asset);
+        }
+
+        std::vector<AssetImpl> toUpdate;
+        std::vector<size_t>    positions;
+        for (size_t i = 0; i < items.size(); i++) {
+            BatchItem& item = items[i];
+            if (!item.error.empty()) {
+                continue;
+            }
+
+            auto it = current.find(item.asset.getInternalName());
+            if (it == current.end()) {
+                item.error = "Update failed, asset " + item.asset.getInternalName() + " does not exist.";
+                continue;
+            }
+            item.current = it->second;
+
+            item.requestActivation   = (item.current.getAssetStatus() == fty::AssetStatus::Nonactive &&
+                                        item.asset.getAssetStatus() == fty::AssetStatus::Active &&
+                                        item.asset.getAssetType() == TYPE_DEVICE);
+            item.requestDeactivation = (item.current.getAssetStatus() == fty::AssetStatus::Active &&
+                                        item.asset.getAssetStatus() == fty::AssetStatus::Nonactive);
+
+            // if a device changes from nonactive to active, activation is requested once the batch is written;
+            // other assets need no license and are written as sent
+            if (item.requestActivation) {
+                item.asset.setAssetStatus(fty::AssetStatus::Nonactive);
+            }
+            toUpdate.push_back(item.asset);
+            positions.push_back(i);
+        }
+
+        // all valid assets are updated, or none is
+        if (!toUpdate.empty()) {
+            try {
+                AssetImpl::updateBatch(toUpdate);
+                for (size_t i = 0; i < positions.size(); i++) {
+                    items[positions[i]].asset = toUpdate[i];
+                }
+            } catch (const std::exception& e) {
+                log_error("UPDATE_BATCH failed: %s", e.what());
+                for (size_t position : positions) {
+                    items[position].error = "An error occurred while updating asset. " + std::string(e.what());
+                }
+            }
+        }
+
+        // deactivations first, they free license for the activations; assets are already written non active
+        std::vector<AssetImpl*> toDeactivate;
+        for (auto& item : items) {
+            if (item.error.empty() && item.requestDeactivation) {
+                toDeactivate.push_back(&item.asset);
+            }
+        }
+        AssetImpl::deactivateBatch(toDeactivate);
+
+        // assets refused by the license are written back as they were, failed activations stay non active
+        std::vector<BatchItem*> refused;
+        std::vector<BatchItem*> failed;
+        activateBatchItems(items, tryActivate, refused, failed);
+        for (auto* item : refused) {
+            try {
+                item->current.update();
+            } catch (const std::exception& e) {
+                log_error("Restore of %s failed: %s", item->current.getInternalName().c_str(), e.what());
+            }
+        }
+
+        reloadBatch(items);
+
+        response = assetutils::createMessage(FTY_ASSET_SUBJECT_UPDATE_BATCH,
+            value(msg.metaData(), messagebus::Message::CORRELATION_ID), m_agentNameNg,
+            value(msg.metaData(), messagebus::Message::FROM), messagebus::STATUS_OK, serializeBatchStatus(items));
+
+        // notifications of the updated assets, once the whole batch is written
+        std::vector<AssetNotification> notifications;
+        for (const auto& item : items) {
+            if (item.error.empty()) {
+                notifications.push_back(AssetNotification::updated(item.current, item.asset));
+            }
+        }
+        try {
+            sendNotifications(notifications);
+        } catch (const std::exception& e) {
+            log_error(e.what());
+        }
+    } catch (const std::exception& e) {
+        log_error(e.what());
+        response = assetutils::createMessage(FTY_ASSET_SUBJECT_UPDATE_BATCH,
+            value(msg.metaData(), messagebus::Message::CORRELATION_ID), m_agentNameNg,
+            value(msg.metaData(), messagebus::Message::FROM), messagebus::STATUS_KO,
+            "An error occurred while updating assets. " + std::string(e.what()));
+    }
+
+    log_debug("sending response to %s", value(msg.metaData(), messagebus::Message::FROM).c_str());
+    m_assetMsgQueue->sendReply(value(msg.metaData(), messagebus::Message::REPLY_TO), response);
+}
+
 static std::string serializeDeleteStatus(DeleteStatus statusList)
 {
     cxxtools::SerializationInfo si;
@@ -596,15 +1066,7 @@ void AssetServer::deleteAsset(const messagebus::Message& msg)
         // send one notification for each asset deleted
         for (const auto& status : deleted) {
             if (status.second == "OK") {
-                // full notification
-                messagebus::Message notification = assetutils::createMessage(FTY_ASSET_SUBJECT_DELETED, "",
-                    m_agentNameNg, "", messagebus::STATUS_OK, fty::Asset::toJson(status.first));
-                sendNotification(notification);
-
-                // light notification
-                messagebus::Message notification_l = assetutils::createMessage(FTY_ASSET_SUBJECT_DELETED_L,
-                    "", m_agentNameNg, "", messagebus::STATUS_OK, status.first.getInternalName());
-                sendNotification(notification_l);
+                sendNotification(AssetNotification::deleted(status.first));
             }
         }
     } catch (const std::exception& e) {
@@ -658,6 +1120,83 @@ void AssetServer::getAsset(const messagebus::Message& msg, bool getFromUuid)
     }
 }
 
+void AssetServer::getAssets(const messagebus::Message& msg)
+{
+    log_debug("subject GET_MANY");
+
+    messagebus::Message response;
+    try {
+        cxxtools::SerializationInfo si;
+        JSON::readFromString(msg.userData().front(), si);
+
+        std::vector<std::string> ids;
+        si >>= ids;
+
+        // inames, empty if the uuid is unknown
+        std::vector<std::string> inames = ids;
+        if (value(msg.metaData(), METADATA_BY_UUID) == "true") {
+            auto byUuid = AssetImpl::getInamesFromUuids(ids);
+            for (auto& iname : inames) {
+                auto it = byUuid.find(iname);
+                iname   = it == byUuid.end() ? "" : it->second;
+            }
+        }
+
+        std::vector<std::string> toLoad;
+        for (const auto& iname : inames) {
+            if (!iname.empty()) {
+                toLoad.push_back(iname);
+            }
+        }
+
+        std::map<std::string, AssetImpl> loaded;
+        for (auto& asset : AssetImpl::loadList(toLoad)) {
+            loaded.emplace(asset.getInternalName(), asset);
+        }
+
+        if (value(msg.metaData(), METADATA_WITH_PARENTS_LIST) == "true") {
+            std::vector<AssetImpl> assets;
+            for (const auto& it : loaded) {
+                assets.push_back(it.second);
+            }
+            ParentsCache parentsCache;
+            AssetImpl::loadParents(assets, parentsCache);
+            for (auto& it : loaded) {
+                try {
+                    it.second.updateParentsList(parentsCache);
+                } catch (const std::exception& e) {
+                    log_error("Could not retrieve parents of %s: %s", it.first.c_str(), e.what());
+                }
+            }
+        }
+
+        std::vector<BatchItem> items(ids.size());
+        for (size_t i = 0; i < ids.size(); i++) {
+            auto it = loaded.find(inames[i]);
+            if (it == loaded.end()) {
+                items[i].error = "Asset " + ids[i] + " not found";
+            } else {
+                items[i].asset = it->second;
+            }
+        }
+
+        response = assetutils::createMessage(FTY_ASSET_SUBJECT_GET_MANY,
+            value(msg.metaData(), messagebus::Message::CORRELATION_ID), m_agentNameNg,
+            value(msg.metaData(), messagebus::Message::FROM), messagebus::STATUS_OK, serializeBatchStatus(items));
+    } catch (const std::exception& e) {
+        log_error(e.what());
+        response = assetutils::createMessage(FTY_ASSET_SUBJECT_GET_MANY,
+            value(msg.metaData(), messagebus::Message::CORRELATION_ID), m_agentNameNg,
+            value(msg.metaData(), messagebus::Message::FROM), messagebus::STATUS_KO, TRANSLATE_ME(e.what()));
+    }
+
+    log_debug("sending response to %s", value(msg.metaData(), messagebus::Message::FROM).c_str());
+    m_assetMsgQueue->sendReply(value(msg.metaData(), messagebus::Message::REPLY_TO), response);
+}
+
+// assets per frame of a LIST reply in stream mode
+static constexpr size_t LIST_STREAM_CHUNK = 100;
+
 void AssetServer::listAsset(const messagebus::Message& msg)
 {
     log_debug("subject LIST");
@@ -685,36 +1224,67 @@ void AssetServer::listAsset(const messagebus::Message& msg)
         if (value(msg.metaData(), METADATA_ID_ONLY) == "false") {
             idOnly = false;
         }
-
-        std::vector<std::string>    inameList = fty::AssetImpl::list(filters);
-        cxxtools::SerializationInfo si;
-
-        if (idOnly) {
-            si <<= inameList;
+        bool withParentsList = value(msg.metaData(), METADATA_WITH_PARENTS_LIST) == "true";
+        bool stream          = value(msg.metaData(), METADATA_STREAM) == "true";
+
+        // whole list unless a page is requested
+        std::vector<std::string> inameList;
+        uint32_t                 nextCursor = 0;
+        const std::string&       pageSize   = value(msg.metaData(), METADATA_PAGE_SIZE);
+        if (pageSize.empty()) {
+            inameList = fty::AssetImpl::list(filters);
         } else {
-            bool withParentsList = value(msg.metaData(), METADATA_WITH_PARENTS_LIST) == "true";
+            const std::string& cursor = value(msg.metaData(), METADATA_CURSOR);
+            size_t             limit  = fty::convert<size_t>(pageSize);
+            if (limit == 0) {
+                throw std::runtime_error("Invalid page size " + pageSize);
+            }
+            inameList = fty::AssetImpl::list(
+                filters, cursor.empty() ? 0 : fty::convert<uint32_t>(cursor), limit, nextCursor);
+        }
 
-            for (const auto& iname : inameList) {
-                try {
-                    fty::AssetImpl asset(iname);
-                    if (withParentsList) {
-                        asset.updateParentsList();
+        // assets are loaded and serialized by chunks, so only one chunk is in memory as objects;
+        // the JSON of all the chunks is kept until the reply, which is one message
+        std::vector<std::string> frames;
+        // ancestors are shared by many assets (same rack, room...), load each of them once
+        fty::ParentsCache parentsCache;
+        size_t                   chunk = stream ? LIST_STREAM_CHUNK : std::max(inameList.size(), size_t(1));
+        for (size_t begin = 0; begin < inameList.size() || frames.empty(); begin += chunk) {
+            size_t                   end = std::min(begin + chunk, inameList.size());
+            std::vector<std::string> inames(inameList.begin() + begin, inameList.begin() + end);
+
+            cxxtools::SerializationInfo si;
+            if (idOnly) {
+                si <<= inames;
+            } else {
+                std::vector<fty::AssetImpl> assets = fty::AssetImpl::loadList(inames);
+                if (withParentsList) {
+                    fty::AssetImpl::loadParents(assets, parentsCache);
+                }
+                for (auto& asset : assets) {
+                    try {
+                        if (withParentsList) {
+                            asset.updateParentsList(parentsCache);
+                        }
+                        cxxtools::SerializationInfo& data = si.addMember("");
+                        data <<= asset;
+                        data.setCategory(cxxtools::SerializationInfo::Category::Object);
+                    } catch (std::exception& e) {
+                        log_error("Could not retrieve asset %s: %s", asset.getInternalName().c_str(), e.what());
                     }
-                    cxxtools::SerializationInfo& data = si.addMember("");
-                    data <<= asset;
-                    data.setCategory(cxxtools::SerializationInfo::Category::Object);
-                } catch (std::exception& e) {
-                    log_error("Could not retrieve asset %s: %s", iname.c_str(), e.what());
                 }
+                si.setCategory(cxxtools::SerializationInfo::Category::Array);
             }
-            si.setCategory(cxxtools::SerializationInfo::Category::Array);
+            frames.push_back(JSON::writeToString(si, false));
         }
 
         // create response (ok)
         auto response = assetutils::createMessage(FTY_ASSET_SUBJECT_LIST,
             msg.metaData().find(messagebus::Message::CORRELATION_ID)->second, m_agentNameNg,
-            msg.metaData().find(messagebus::Message::FROM)->second, messagebus::STATUS_OK,
-            JSON::writeToString(si, false));
+            msg.metaData().find(messagebus::Message::FROM)->second, messagebus::STATUS_OK, frames);
+        if (nextCursor != 0) {
+            response.metaData().emplace(METADATA_CURSOR, std::to_string(nextCursor));
+        }
 
         // send response
         log_debug("sending response to %s", msg.metaData().find(messagebus::Message::FROM)->second.c_str());
@@ -860,16 +1430,8 @@ void AssetServer::notifyAsset(const messagebus::Message& msg)
 
         log_debug("Sending notification for asset %s", newAsset.getInternalName().c_str());
 
-        // full notification
-        messagebus::Message notification = assetutils::createMessage(FTY_ASSET_SUBJECT_UPDATED, "",
-            m_agentNameNg, "", messagebus::STATUS_OK, JSON::writeToString(si, false));
-        sendNotification(notification);
-
-        // light notification
-        messagebus::Message notification_l = assetutils::createMessage(FTY_ASSET_SUBJECT_UPDATED_L, "",
-            m_agentNameNg, "", messagebus::STATUS_OK, newAsset.getInternalName());
-        sendNotification(notification_l);
-
+        // payload is forwarded as received
+        sendNotification(AssetNotification::updated(json, oldAsset, newAsset));
 
     } catch (std::exception& e) {
         log_error(e.what());
@@ -879,106 +1441,18 @@ void AssetServer::notifyAsset(const messagebus::Message& msg)
 void AssetServer::notifyAssetUpdate(const Asset& before, const Asset& after)
 {
     try {
-
-        cxxtools::SerializationInfo si;
-
-        // before update
-        cxxtools::SerializationInfo tmpSi;
-        tmpSi <<= before;
-
-        cxxtools::SerializationInfo& beforeSi = si.addMember("");
-        beforeSi.setCategory(cxxtools::SerializationInfo::Category::Object);
-        beforeSi = tmpSi;
-        beforeSi.setName("before");
-
-        // after update
-        tmpSi.clear();
-        tmpSi <<= after;
-
-        cxxtools::SerializationInfo& afterSi = si.addMember("");
-        afterSi.setCategory(cxxtools::SerializationInfo::Category::Object);
-        afterSi = tmpSi;
-        afterSi.setName("after");
-
-        // full notification
-        messagebus::Message notification = assetutils::createMessage(FTY_ASSET_SUBJECT_UPDATED, "",
-            m_agentNameNg, "", messagebus::STATUS_OK, JSON::writeToString(si, false));
-        sendNotification(notification);
-
-        // light notification
-        messagebus::Message notification_l = assetutils::createMessage(FTY_ASSET_SUBJECT_UPDATED_L, "",
-            m_agentNameNg, "", messagebus::STATUS_OK, after.getInternalName());
-        sendNotification(notification_l);
-
+        sendNotification(AssetNotification::updated(before, after));
     } catch (std::exception& e) {
         log_error(e.what());
     }
 }
 
 // SRR
-cxxtools::SerializationInfo AssetServer::saveAssets(bool saveVirtualAssets)
-{
-    std::vector<std::string> assets = AssetImpl::listAll();
-
-    cxxtools::SerializationInfo si;
-
-    si.addMember("version") <<= SRR_ACTIVE_VERSION;
-
-    cxxtools::SerializationInfo& data = si.addMember("data");
-
-    for (const std::string assetName : assets) {
-        AssetImpl a(assetName);
-
-        if (a.isVirtual() && !saveVirtualAssets) {
-            log_info("Asset %s is virtual, will not be saved", a.getInternalName().c_str());
-            continue;
-        }
-
-        log_debug("Saving asset %s...", a.getInternalName().c_str());
-
-        cxxtools::SerializationInfo& siAsset = data.addMember("");
-        AssetImpl::assetToSrr(a, siAsset);
-    }
-
-    data.setCategory(cxxtools::SerializationInfo::Array);
-
-    return si;
-}
-
-static void buildRestoreTree(std::vector<AssetImpl>& v)
+void AssetServer::saveAssets(std::ostream& out, bool saveVirtualAssets)
 {
-    std::map<std::string, std::vector<std::string>> ancestorMatrix;
-
-    for (const AssetImpl& a : v) {
-        // create node if doesn't exist
-        ancestorMatrix[a.getInternalName()];
-        if (!a.getParentIname().empty()) {
-            ancestorMatrix[a.getParentIname()].push_back(a.getInternalName());
-        }
-    }
-
-    // iterate on each asset
-    for (const auto& a : ancestorMatrix) {
-        std::string id       = a.first;
-        const auto& children = a.second;
-
-        // find ancestors of asset a
-        for (auto& x : ancestorMatrix) {
-            auto& parentOf = x.second;
-
-            auto found = std::find(parentOf.begin(), parentOf.end(), id);
-            // if x is parent of a, x inherits all children of a
-            if (found != parentOf.end()) {
-                for (const auto& child : children) {
-                    parentOf.push_back(child);
-                }
-            }
-        }
-    }
-
-    std::sort(v.begin(), v.end(), [&](const AssetImpl& l, const AssetImpl& r) {
-        return ancestorMatrix[l.getInternalName()].size() > ancestorMatrix[r.getInternalName()].size();
-    });
+    out << "{\"version\":\"" << SRR_ACTIVE_VERSION << "\",\"data\":";
+    AssetImpl::assetsToSrr(AssetImpl::listAll(), out, saveVirtualAssets);
+    out << "}";
 }
 
 void AssetServer::restoreAssets(const cxxtools::SerializationInfo& si, bool tryActivate)
@@ -1000,52 +1474,57 @@ void AssetServer::restoreAssets(const cxxtools::SerializationInfo& si, bool tryA
         assetsToRestore.push_back(a);
     }
 
-    buildRestoreTree(assetsToRestore);
+    AssetImpl::sortParentsFirst(assetsToRestore);
 
+    // assets are inserted non active, then activated together
+    std::vector<bool> requestActivation;
     for (AssetImpl& a : assetsToRestore) {
-        log_debug("Restoring asset %s...", a.getInternalName().c_str());
-
-        try {
-            bool requestActivation = (a.getAssetStatus() == AssetStatus::Active);
-
-            if (requestActivation && !a.isActivable()) {
-                if (tryActivate) {
-                    a.setAssetStatus(fty::AssetStatus::Nonactive);
-                    requestActivation = false;
-                } else {
-                    throw std::runtime_error(
-                        "Licensing limitation hit - maximum amount of active power devices allowed in "
-                        "license reached.");
-                }
-            }
+        requestActivation.push_back(a.getAssetStatus() == AssetStatus::Active);
+        a.setAssetStatus(fty::AssetStatus::Nonactive);
+    }
 
-            // restore asset to db
-            a.restore();
+    std::vector<bool>       restored = AssetImpl::restoreBatch(assetsToRestore);
+    std::vector<AssetImpl*> toActivate;
+    std::vector<AssetImpl*> toLink;
+    for (size_t i = 0; i < assetsToRestore.size(); i++) {
+        if (restored[i] && requestActivation[i]) {
+            toActivate.push_back(&assetsToRestore[i]);
+        }
+    }
 
-            // activate asset
-            if (requestActivation) {
-                try {
-                    a.activate();
-                } catch (std::exception& e) {
-                    // if activation fails, delete asset
-                    AssetImpl::deleteList({a.getInternalName()}, false);
-                    throw std::runtime_error(e.what());
-                }
+    // as for CREATE_BATCH, each device is checked just before its activation, once the previous ones
+    // are active, so that the restored devices count against the license
+    std::set<AssetImpl*>     removed;
+    std::vector<std::string> refused;
+    for (AssetImpl* a : toActivate) {
+        if (!a->isActivable()) {
+            if (!tryActivate) {
+                // asset is not restored
+                log_error("Asset %s is not restored: licensing limitation hit - maximum amount of active power "
+                          "devices allowed in license reached.",
+                    a->getInternalName().c_str());
+                removed.insert(a);
+                refused.push_back(a->getInternalName());
             }
-        } catch (std::exception& e) {
-            log_error(e.what());
+            continue;
         }
+        if (!AssetImpl::activateBatch({a})[0]) {
+            log_error("Asset %s is restored non active, activation failed", a->getInternalName().c_str());
+        }
+    }
+    if (!refused.empty()) {
+        AssetImpl::deleteList(refused, false);
     }
 
     // restore links
-    for (AssetImpl& a : assetsToRestore) {
-        try {
-            // save links
-            a.update();
-        } catch (std::exception& e) {
-            log_error(e.what());
+    for (size_t i = 0; i < assetsToRestore.size(); i++) {
+        if (restored[i] && !removed.count(&assetsToRestore[i])) {
+            toLink.push_back(&assetsToRestore[i]);
         }
     }
+    AssetImpl::restoreLinksBatch(toLink);
+
+    m_msgCache.clear();
 }
 
 } // namespace fty
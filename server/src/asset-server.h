@@ -21,18 +21,30 @@
 
 #pragma once
 #include "asset/asset.h"
+#include "asset-msg-cache.h"
+#include "asset-notification.h"
+#include "request-stats.h"
 #include <fty_srr_dto.h>
+#include <cstdint>
 #include <memory>
 #include <mutex>
+#include <set>
+#include <unordered_map>
+#include <vector>
 
 static constexpr const char* FTY_ASSET_MAILBOX = "FTY.Q.ASSET.QUERY";
 // new interface mailbox subjects
 static constexpr const char* FTY_ASSET_SUBJECT_CREATE      = "CREATE";
 static constexpr const char* FTY_ASSET_SUBJECT_UPDATE      = "UPDATE";
+// JSON array of assets, written in one transaction; reply has the status of each asset, in order
+static constexpr const char* FTY_ASSET_SUBJECT_CREATE_BATCH = "CREATE_BATCH";
+static constexpr const char* FTY_ASSET_SUBJECT_UPDATE_BATCH = "UPDATE_BATCH";
 static constexpr const char* FTY_ASSET_SUBJECT_DELETE      = "DELETE";
 static constexpr const char* FTY_ASSET_SUBJECT_DELETE_LIST = "DELETE_LIST";
 static constexpr const char* FTY_ASSET_SUBJECT_GET         = "GET";
 static constexpr const char* FTY_ASSET_SUBJECT_GET_BY_UUID = "GET_BY_UUID";
+// JSON array of inames (or uuids with BY_UUID), reply has the asset or the error of each one, in order
+static constexpr const char* FTY_ASSET_SUBJECT_GET_MANY    = "GET_MANY";
 static constexpr const char* FTY_ASSET_SUBJECT_LIST        = "LIST";
 static constexpr const char* FTY_ASSET_SUBJECT_GET_ID      = "GET_ID";
 static constexpr const char* FTY_ASSET_SUBJECT_GET_INAME   = "GET_INAME";
@@ -46,6 +58,8 @@ static constexpr const char* FTY_ASSET_TOPIC_UPDATED   = "FTY.T.ASSET.UPDATED";
 static constexpr const char* FTY_ASSET_TOPIC_UPDATED_L = "FTY.T.ASSET_LIGHT.UPDATED";
 static constexpr const char* FTY_ASSET_TOPIC_DELETED   = "FTY.T.ASSET.DELETED";
 static constexpr const char* FTY_ASSET_TOPIC_DELETED_L = "FTY.T.ASSET_LIGHT.DELETED";
+// changed fields only, see fty::AssetDelta
+static constexpr const char* FTY_ASSET_TOPIC_UPDATED_D = "FTY.T.ASSET_DELTA.UPDATED";
 
 // new interface topic subjects
 static constexpr const char* FTY_ASSET_SUBJECT_CREATED   = "CREATED";
@@ -54,12 +68,21 @@ static constexpr const char* FTY_ASSET_SUBJECT_UPDATED   = "UPDATED";
 static constexpr const char* FTY_ASSET_SUBJECT_UPDATED_L = "UPDATED_LIGHT";
 static constexpr const char* FTY_ASSET_SUBJECT_DELETED   = "DELETED";
 static constexpr const char* FTY_ASSET_SUBJECT_DELETED_L = "DELETED_LIGHT";
+static constexpr const char* FTY_ASSET_SUBJECT_UPDATED_D = "UPDATED_DELTA";
 
 
 static constexpr const char* METADATA_TRY_ACTIVATE      = "TRY_ACTIVATE";
 static constexpr const char* METADATA_NO_ERROR_IF_EXIST = "NO_ERROR_IF_EXIST";
 static constexpr const char* METADATA_ID_ONLY           = "ID_ONLY";
 static constexpr const char* METADATA_WITH_PARENTS_LIST = "WITH_PARENTS_LIST";
+// GET_MANY request lists uuids instead of inames
+static constexpr const char* METADATA_BY_UUID           = "BY_UUID";
+// LIST pagination: request at most PAGE_SIZE assets following CURSOR, reply CURSOR is set if there are more
+static constexpr const char* METADATA_PAGE_SIZE         = "PAGE_SIZE";
+static constexpr const char* METADATA_CURSOR            = "CURSOR";
+// LIST reply is split in several frames, each a JSON array; they are still sent in one reply message,
+// PAGE_SIZE bounds the size of a reply
+static constexpr const char* METADATA_STREAM            = "STREAM";
 
 // SRR
 static constexpr const char* SRR_ACTIVE_VERSION  = "1.0";
@@ -183,8 +206,43 @@ public:
     void resetPublisherClientNg();
     void connectPublisherClientNg();
 
-    // notifications
-    void sendNotification(const messagebus::Message&) const;
+    // notifications, on the full topic, on the light one if light is true, on the delta one for updates,
+    // and on the ASSETS stream
+    void sendNotification(const AssetNotification& notification, bool light = true) const;
+    // same for the assets of a batch: one message per asset on the topics, the ASSETS stream messages
+    // are built with a few queries for all of them
+    void sendNotifications(const std::vector<AssetNotification>& notifications, bool light = true) const;
+
+    // ASSETS stream periodic republish
+    int getRepeatFullCycle() const
+    {
+        return m_repeatFullCycle;
+    }
+
+    void setRepeatFullCycle(int cycle)
+    {
+        m_repeatFullCycle = cycle;
+    }
+
+    // encoded ASSETS stream messages
+    AssetMsgCache& getMsgCache() const
+    {
+        return m_msgCache;
+    }
+
+    // latencies of handled requests, by subject
+    RequestStats& getStats() const
+    {
+        return m_stats;
+    }
+
+    bool     nextRepeatIsFull();
+    bool     updatePublishedHash(const std::string& assetName, size_t hash) const;
+    bool     isPublishedHash(const std::string& assetName, size_t hash) const;
+    void     retainPublishedHashes(const std::set<std::string>& assetNames) const;
+    uint64_t getPublishSequence() const;
+    bool     publishedSince(const std::string& assetName, uint64_t sequence) const;
+    void     publishedDeleted(const std::string& assetName) const;
 
     // SRR
     void initSrr(const std::string& queue);
@@ -193,8 +251,11 @@ public:
 private:
     void createAsset(const messagebus::Message& msg);
     void updateAsset(const messagebus::Message& msg);
+    void createAssetBatch(const messagebus::Message& msg);
+    void updateAssetBatch(const messagebus::Message& msg);
     void deleteAsset(const messagebus::Message& msg);
     void getAsset(const messagebus::Message& msg, bool getFromUuid = false);
+    void getAssets(const messagebus::Message& msg);
     void listAsset(const messagebus::Message& msg);
     void getAssetID(const messagebus::Message& msg);
     void getAssetIname(const messagebus::Message& msg);
@@ -205,8 +266,9 @@ private:
     void notifyAssetUpdate(const Asset& before, const Asset& after);
 
     // SRR
-    cxxtools::SerializationInfo saveAssets(bool saveVirtualAssets = false);
-    void                        restoreAssets(const cxxtools::SerializationInfo& si, bool tryActivate = true);
+    // writes the SRR document of all assets to out, without building it as one SerializationInfo
+    void saveAssets(std::ostream& out, bool saveVirtualAssets = false);
+    void restoreAssets(const cxxtools::SerializationInfo& si, bool tryActivate = true);
 
 private:
     static void destroyMlmClient(mlm_client_t* client);
@@ -224,6 +286,21 @@ private:
     MlmClientPtr m_mailboxClient;
     MlmClientPtr m_streamClient;
 
+    // ASSETS stream: hash of the last published message of each asset
+    struct Published
+    {
+        size_t   hash;
+        uint64_t sequence; // value of m_publishSequence when published
+        bool     deleted;
+    };
+    int                                                m_repeatFullCycle = 24;
+    int                                                m_repeatCycle     = 0;
+    mutable std::mutex                                 m_publishedLock;
+    mutable uint64_t                                   m_publishSequence = 0;
+    mutable std::unordered_map<std::string, Published> m_publishedHash;
+    mutable AssetMsgCache                              m_msgCache;
+    mutable RequestStats                               m_stats;
+
     // new generation interface
     std::string m_agentNameNg = "asset-agent-ng";
     MsgBusPtr   m_assetMsgQueue;
@@ -233,6 +310,7 @@ private:
     MsgBusPtr   m_publisherUpdateLight;
     MsgBusPtr   m_publisherDelete;
     MsgBusPtr   m_publisherDeleteLight;
+    MsgBusPtr   m_publisherUpdateDelta;
 
     // topic handlers
     void handleAssetManipulationReq(const messagebus::Message& msg);
@@ -0,0 +1,224 @@
+/*  =========================================================================
+    asset-stream-data - content of ASSETS stream messages read from the database
+
+    Copyright (C) 2014 - 2020 Eaton
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+    =========================================================================
+*/
+
+#include "asset-stream-data.h"
+#include "asset/dbhelpers.h"
+
+#include <algorithm>
+#include <fty_log.h>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <tntdb/row.h>
+
+void fill_asset_stream_basic(AssetStreamData& data, const tntdb::Row& row)
+{
+    // NULL columns are kept to 0 as in original per-asset callback
+    row["priority"].get(data.priority);
+    row["id_type"].get(data.typeId);
+    row["subtype_id"].get(data.subtypeId);
+    row["id_parent"].get(data.parentId);
+    row["status"].get(data.status);
+    row["id"].get(data.id);
+    data.found = true;
+}
+
+int select_all_assets_stream_data(
+    const std::string& client_name, std::vector<AssetStreamData>& assets, bool test_mode)
+{
+    std::map<uint32_t, size_t> index; // asset id -> position in assets
+
+    std::function<void(const tntdb::Row&)> cb1 = [&assets, &index](const tntdb::Row& row) {
+        AssetStreamData data;
+        row["name"].get(data.name);
+        fill_asset_stream_basic(data, row);
+        index[data.id] = assets.size();
+        assets.push_back(std::move(data));
+    };
+
+    if (select_asset_element_basic_all(cb1, test_mode) != 0) {
+        log_warning("%s:\tCannot list all assets", client_name.c_str());
+        return -1;
+    }
+
+    std::function<void(const tntdb::Row&)> cb2 = [&assets, &index](const tntdb::Row& row) {
+        uint32_t id = 0;
+        row["id_asset_element"].get(id);
+        auto it = index.find(id);
+        if (it == index.end()) {
+            return;
+        }
+        std::string keytag;
+        row["keytag"].get(keytag);
+        std::string value;
+        row["value"].get(value);
+        assets[it->second].ext.emplace_back(keytag, value);
+    };
+
+    if (select_ext_attributes_all(cb2, test_mode) != 0) {
+        log_warning("%s:\tCannot select ext attributes of all assets", client_name.c_str());
+        return -1;
+    }
+
+    // same as v_bios_asset_element_super_parent: up to 10 ancestors, nearest first
+    for (auto& data : assets) {
+        data.parents.assign(ASSET_STREAM_MAX_PARENTS, "");
+        int parentId = data.parentId;
+        for (size_t level = 0; level < ASSET_STREAM_MAX_PARENTS && parentId != 0; ++level) {
+            auto it = index.find(static_cast<uint32_t>(parentId));
+            if (it == index.end()) {
+                break;
+            }
+            const AssetStreamData& parent = assets[it->second];
+            data.parents[level]           = parent.name;
+            parentId                      = parent.parentId;
+        }
+    }
+
+    return 0;
+}
+
+int select_assets_stream_data(const std::string& client_name, const std::set<std::string>& names,
+    std::vector<AssetStreamData>& assets, bool test_mode)
+{
+    std::map<uint32_t, size_t> index; // asset id -> position in assets
+
+    std::function<void(const tntdb::Row&)> cb1 = [&assets, &index](const tntdb::Row& row) {
+        AssetStreamData data;
+        row["name"].get(data.name);
+        fill_asset_stream_basic(data, row);
+        index[data.id] = assets.size();
+        assets.push_back(std::move(data));
+    };
+
+    if (select_asset_element_basic_by_names(names, cb1, test_mode) != 0) {
+        log_warning("%s:\tCannot select %zu assets", client_name.c_str(), names.size());
+        return -1;
+    }
+    // batches are ordered by name
+    std::sort(assets.begin(), assets.end(), [](const AssetStreamData& a, const AssetStreamData& b) {
+        return a.id < b.id;
+    });
+    index.clear();
+    for (size_t i = 0; i < assets.size(); i++) {
+        index[assets[i].id] = i;
+    }
+
+    std::set<uint32_t> ids;
+    for (const auto& it : index) {
+        ids.insert(it.first);
+    }
+
+    std::function<void(const tntdb::Row&)> cb2 = [&assets, &index](const tntdb::Row& row) {
+        uint32_t id = 0;
+        row["id_asset_element"].get(id);
+        auto it = index.find(id);
+        if (it == index.end()) {
+            return;
+        }
+        std::string keytag;
+        row["keytag"].get(keytag);
+        std::string value;
+        row["value"].get(value);
+        assets[it->second].ext.emplace_back(keytag, value);
+    };
+
+    if (!ids.empty() && select_ext_attributes_by_ids(ids, cb2, test_mode) != 0) {
+        log_warning("%s:\tCannot select ext attributes of %zu assets", client_name.c_str(), ids.size());
+        return -1;
+    }
+
+    // name and parent of the assets and of their ancestors
+    std::map<uint32_t, std::pair<std::string, int>> nodes;
+    for (const auto& data : assets) {
+        nodes[data.id] = {data.name, data.parentId};
+    }
+
+    std::function<void(const tntdb::Row&)> cb3 = [&nodes](const tntdb::Row& row) {
+        AssetStreamData data;
+        row["name"].get(data.name);
+        fill_asset_stream_basic(data, row);
+        nodes[data.id] = {data.name, data.parentId};
+    };
+
+    std::set<uint32_t> level = ids;
+    for (size_t depth = 0; depth < ASSET_STREAM_MAX_PARENTS && !level.empty(); ++depth) {
+        std::set<uint32_t> parents;
+        for (uint32_t id : level) {
+            int parentId = nodes[id].second;
+            if (parentId != 0 && !nodes.count(static_cast<uint32_t>(parentId))) {
+                parents.insert(static_cast<uint32_t>(parentId));
+            }
+        }
+        if (!parents.empty() && select_asset_element_basic_by_ids(parents, cb3, test_mode) != 0) {
+            log_warning("%s:\tCannot select parents of %zu assets", client_name.c_str(), level.size());
+            return -1;
+        }
+        // parents read now are the next level, the known ones were already walked
+        level.clear();
+        for (uint32_t id : parents) {
+            if (nodes.count(id)) {
+                level.insert(id);
+            }
+        }
+    }
+
+    for (auto& data : assets) {
+        data.parents.assign(ASSET_STREAM_MAX_PARENTS, "");
+        int parentId = data.parentId;
+        for (size_t depth = 0; depth < ASSET_STREAM_MAX_PARENTS && parentId != 0; ++depth) {
+            auto it = nodes.find(static_cast<uint32_t>(parentId));
+            if (it == nodes.end()) {
+                break;
+            }
+            data.parents[depth] = it->second.first;
+            parentId            = it->second.second;
+        }
+    }
+
+    return 0;
+}
+
+static std::mutex            s_loaderLock;
+static AssetStreamDataLoader s_loader;
+
+void set_assets_stream_data_loader(AssetStreamDataLoader loader)
+{
+    std::unique_lock<std::mutex> lock(s_loaderLock);
+    s_loader = loader;
+}
+
+int load_assets_stream_data(const std::string& client_name, const std::set<std::string>* names,
+    std::vector<AssetStreamData>& assets, bool test_mode)
+{
+    AssetStreamDataLoader loader;
+    {
+        std::unique_lock<std::mutex> lock(s_loaderLock);
+        loader = s_loader;
+    }
+    if (loader) {
+        return loader(client_name, names, assets, test_mode);
+    }
+    if (names) {
+        return select_assets_stream_data(client_name, *names, assets, test_mode);
+    }
+    return select_all_assets_stream_data(client_name, assets, test_mode);
+}
@@ -0,0 +1,76 @@
+/*  =========================================================================
+    asset-stream-data - content of ASSETS stream messages read from the database
+
+    Copyright (C) 2014 - 2020 Eaton
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+    =========================================================================
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace tntdb {
+class Row;
+}
+
+// Content of an ASSETS stream message, as read from the database
+struct AssetStreamData
+{
+    bool                                             found = false; // basic row was selected
+    uint32_t                                         id    = 0;
+    std::string                                      name;
+    int                                              priority  = 0;
+    int                                              typeId    = 0;
+    int                                              subtypeId = 0;
+    int                                              parentId  = 0;
+    std::string                                      status;
+    std::vector<std::pair<std::string, std::string>> ext;     // keytag/value, in DB order
+    std::vector<std::string>                         parents; // parent_name.1 ... parent_name.10, may be empty
+};
+
+static const size_t ASSET_STREAM_MAX_PARENTS = 10;
+
+// Fills basic info from a row of select_asset_element_basic() and similar queries
+void fill_asset_stream_basic(AssetStreamData& data, const tntdb::Row& row);
+
+// Loads stream data of all assets with a constant number of queries:
+// basic rows, ext attributes, ancestry resolved in memory from id_parent.
+int select_all_assets_stream_data(
+    const std::string& client_name, std::vector<AssetStreamData>& assets, bool test_mode);
+
+// Loads the given assets only, as select_all_assets_stream_data(): basic rows and ext attributes
+// are read by batches of names/ids, ancestors level by level, so the cost depends on the number of
+// assets requested and not on the size of the DB. Unknown assets are ignored.
+int select_assets_stream_data(const std::string& client_name, const std::set<std::string>& names,
+    std::vector<AssetStreamData>& assets, bool test_mode);
+
+// Reads the stream data of all assets (names NULL) or of the given ones, for republishing
+using AssetStreamDataLoader = std::function<int(const std::string& client_name, const std::set<std::string>* names,
+    std::vector<AssetStreamData>& assets, bool test_mode)>;
+
+// Loader used by load_assets_stream_data(), the database by default (also when loader is empty);
+// tests and benchmarks set theirs before the asset server actor republishes
+void set_assets_stream_data_loader(AssetStreamDataLoader loader);
+
+int load_assets_stream_data(const std::string& client_name, const std::set<std::string>* names,
+    std::vector<AssetStreamData>& assets, bool test_mode);
@@ -0,0 +1,735 @@
+/*  =========================================================================
+    asset_asset_db_cache - asset/asset-db-cache
+
+    Copyright (C) 2016 - 2020 Eaton
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+    =========================================================================
+*/
+
+/*
+@header
+    asset_asset_db_cache - asset/asset-db-cache
+@discuss
+@end
+*/
+
+#include "asset-db-cache.h"
+#include <set>
+
+namespace fty {
+
+// transaction of the calling thread and assets it wrote
+static thread_local size_t                   t_depth = 0;
+static thread_local std::vector<std::string> t_written;
+static thread_local bool                     t_rolledBack = false;
+
+// per entry overhead of the hash maps and of the lru list
+static constexpr size_t NODE_BYTES = 64;
+
+static void copyBase(const Asset& from, Asset& to)
+{
+    to.setInternalName(from.getInternalName());
+    to.setAssetType(from.getAssetType());
+    to.setAssetSubtype(from.getAssetSubtype());
+    to.setParentIname(from.getParentIname());
+    to.setAssetStatus(from.getAssetStatus());
+    to.setPriority(from.getPriority());
+    to.setAssetTag(from.getAssetTag());
+    to.setSecondaryID(from.getSecondaryID());
+}
+
+static void copyAll(const Asset& from, Asset& to)
+{
+    copyBase(from, to);
+    to.setExtMap(from.getExt());
+    to.setLinkedAssets(from.getLinkedAssets());
+}
+
+static size_t extBytes(const std::map<std::string, ExtMapElement>& ext)
+{
+    size_t bytes = 0;
+    for (const auto& it : ext) {
+        bytes += NODE_BYTES + sizeof(ExtMapElement) + it.first.capacity() + it.second.getValue().capacity();
+    }
+    return bytes;
+}
+
+// approximate memory used by a cached asset
+static size_t footprint(const Asset& asset)
+{
+    size_t bytes = sizeof(Asset) + 2 * (NODE_BYTES + asset.getInternalName().capacity());
+
+    bytes += asset.getAssetType().capacity() + asset.getAssetSubtype().capacity();
+    bytes += asset.getParentIname().capacity() + asset.getAssetTag().capacity() + asset.getSecondaryID().capacity();
+    bytes += extBytes(asset.getExt());
+    for (const auto& link : asset.getLinkedAssets()) {
+        bytes += sizeof(AssetLink) + link.sourceId().capacity() + link.srcOut().capacity() +
+                 link.destIn().capacity() + link.secondaryID().capacity() + extBytes(link.ext());
+    }
+    return bytes;
+}
+
+static size_t indexBytes(const std::string& key, const std::string& value)
+{
+    return 2 * (NODE_BYTES + key.capacity() + value.capacity());
+}
+
+CachedStorage::CachedStorage(AssetStorage& backend, size_t budget, std::chrono::seconds ttl)
+    : m_backend(backend)
+    , m_budget(budget)
+    , m_ttl(ttl)
+{
+}
+
+void CachedStorage::setBudget(size_t bytes)
+{
+    std::unique_lock<std::mutex> lock(m_lock);
+    m_budget = bytes;
+    trim();
+}
+
+void CachedStorage::setTtl(std::chrono::seconds ttl)
+{
+    std::unique_lock<std::mutex> lock(m_lock);
+    m_ttl = ttl;
+}
+
+void CachedStorage::invalidate(const std::string& iname)
+{
+    std::unique_lock<std::mutex> lock(m_lock);
+    forget(iname);
+    m_generation++;
+}
+
+void CachedStorage::clear()
+{
+    std::unique_lock<std::mutex> lock(m_lock);
+    m_assets.clear();
+    m_lru.clear();
+    m_ids.clear();
+    m_inames.clear();
+    m_uuids.clear();
+    m_uuidOf.clear();
+    m_bytes      = 0;
+    m_indexBytes = 0;
+    m_generation++;
+}
+
+uint64_t CachedStorage::hits() const
+{
+    std::unique_lock<std::mutex> lock(m_lock);
+    return m_hits;
+}
+
+uint64_t CachedStorage::misses() const
+{
+    std::unique_lock<std::mutex> lock(m_lock);
+    return m_misses;
+}
+
+size_t CachedStorage::size() const
+{
+    std::unique_lock<std::mutex> lock(m_lock);
+    return m_assets.size();
+}
+
+size_t CachedStorage::bytes() const
+{
+    std::unique_lock<std::mutex> lock(m_lock);
+    return m_bytes + m_indexBytes;
+}
+
+//============================================================================================================
+
+void CachedStorage::loadAsset(const std::string& nameId, Asset& asset)
+{
+    Asset cached;
+    if (!find(nameId, cached) && !hydrate(nameId, cached)) {
+        // reports missing assets as the backend does
+        m_backend.loadAsset(nameId, asset);
+        return;
+    }
+    copyBase(cached, asset);
+}
+
+void CachedStorage::loadExtMap(Asset& asset)
+{
+    Asset cached;
+    if (!find(asset.getInternalName(), cached) && !hydrate(asset.getInternalName(), cached)) {
+        m_backend.loadExtMap(asset);
+        return;
+    }
+    asset.setExtMap(cached.getExt());
+}
+
+void CachedStorage::loadLinkedAssets(Asset& asset)
+{
+    Asset cached;
+    if (!find(asset.getInternalName(), cached) && !hydrate(asset.getInternalName(), cached)) {
+        m_backend.loadLinkedAssets(asset);
+        return;
+    }
+    asset.setLinkedAssets(cached.getLinkedAssets());
+}
+
+std::vector<bool> CachedStorage::loadAssets(const std::vector<Asset*>& assets)
+{
+    std::vector<bool>   found(assets.size(), false);
+    std::vector<Asset*> missing;
+    std::vector<size_t> positions;
+
+    for (size_t i = 0; i < assets.size(); i++) {
+        Asset cached;
+        if (find(assets[i]->getInternalName(), cached)) {
+            copyAll(cached, *assets[i]);
+            found[i] = true;
+        } else {
+            missing.push_back(assets[i]);
+            positions.push_back(i);
+        }
+    }
+    if (missing.empty()) {
+        return found;
+    }
+
+    uint64_t          gen    = generation();
+    std::vector<bool> loaded = m_backend.loadAssets(missing);
+    for (size_t i = 0; i < missing.size(); i++) {
+        if (loaded[i]) {
+            put(*missing[i], gen);
+            found[positions[i]] = true;
+        }
+    }
+    return found;
+}
+
+std::vector<std::string> CachedStorage::getChildren(const Asset& asset)
+{
+    return m_backend.getChildren(asset);
+}
+
+std::map<std::string, int> CachedStorage::getDepths(const std::vector<std::string>& inames)
+{
+    return m_backend.getDepths(inames);
+}
+
+fty::Expected<uint32_t> CachedStorage::getID(const std::string& internalName)
+{
+    uint64_t gen;
+    {
+        std::unique_lock<std::mutex> lock(m_lock);
+        auto                         it = m_ids.find(internalName);
+        if (it != m_ids.end()) {
+            m_hits++;
+            return it->second;
+        }
+        m_misses++;
+        gen = m_generation;
+    }
+
+    auto id = m_backend.getID(internalName);
+    if (id) {
+        putId(internalName, *id, gen);
+    }
+    return id;
+}
+
+std::string CachedStorage::inameById(uint32_t id)
+{
+    uint64_t gen;
+    {
+        std::unique_lock<std::mutex> lock(m_lock);
+        auto                         it = m_inames.find(id);
+        if (it != m_inames.end()) {
+            m_hits++;
+            return it->second;
+        }
+        m_misses++;
+        gen = m_generation;
+    }
+
+    std::string iname = m_backend.inameById(id);
+    if (!iname.empty()) {
+        putId(iname, id, gen);
+    }
+    return iname;
+}
+
+std::string CachedStorage::inameByUuid(const std::string& uuid)
+{
+    uint64_t gen;
+    {
+        std::unique_lock<std::mutex> lock(m_lock);
+        auto                         it = m_uuids.find(uuid);
+        if (it != m_uuids.end()) {
+            m_hits++;
+            return it->second;
+        }
+        m_misses++;
+        gen = m_generation;
+    }
+
+    std::string iname = m_backend.inameByUuid(uuid);
+    if (!iname.empty()) {
+        putUuid(uuid, iname, gen);
+    }
+    return iname;
+}
+
+std::map<std::string, std::string> CachedStorage::inamesByUuids(const std::vector<std::string>& uuids)
+{
+    std::map<std::string, std::string> inames;
+    std::vector<std::string>           missing;
+    uint64_t                           gen;
+    {
+        std::unique_lock<std::mutex> lock(m_lock);
+        for (const auto& uuid : uuids) {
+            auto it = m_uuids.find(uuid);
+            if (it != m_uuids.end()) {
+                m_hits++;
+                inames[uuid] = it->second;
+            } else {
+                m_misses++;
+                missing.push_back(uuid);
+            }
+        }
+        gen = m_generation;
+    }
+    if (missing.empty()) {
+        return inames;
+    }
+
+    for (const auto& it : m_backend.inamesByUuids(missing)) {
+        putUuid(it.first, it.second, gen);
+        inames[it.first] = it.second;
+    }
+    return inames;
+}
+
+uint32_t CachedStorage::getTypeID(const std::string& type)
+{
+    return m_backend.getTypeID(type);
+}
+
+uint32_t CachedStorage::getSubtypeID(const std::string& subtype)
+{
+    return m_backend.getSubtypeID(subtype);
+}
+
+bool CachedStorage::verifyID(std::string& id)
+{
+    return m_backend.verifyID(id);
+}
+
+std::vector<bool> CachedStorage::verifyIDs(const std::vector<std::string>& ids)
+{
+    return m_backend.verifyIDs(ids);
+}
+
+bool CachedStorage::hasLinkedAssets(const Asset& asset)
+{
+    return m_backend.hasLinkedAssets(asset);
+}
+
+bool CachedStorage::isLastDataCenter(Asset& asset)
+{
+    return m_backend.isLastDataCenter(asset);
+}
+
+std::map<std::string, int> CachedStorage::countChildren(const std::vector<std::string>& inames)
+{
+    return m_backend.countChildren(inames);
+}
+
+std::set<std::string> CachedStorage::getLinkSources(const std::vector<std::string>& inames)
+{
+    return m_backend.getLinkSources(inames);
+}
+
+int CachedStorage::countDataCenters()
+{
+    return m_backend.countDataCenters();
+}
+
+std::vector<std::string> CachedStorage::listAssets(std::map<std::string, std::vector<std::string>> filters)
+{
+    return m_backend.listAssets(filters);
+}
+
+std::vector<std::string> CachedStorage::listAllAssets()
+{
+    return m_backend.listAllAssets();
+}
+
+std::vector<std::pair<uint32_t, std::string>> CachedStorage::listAssetsPage(
+    std::map<std::string, std::vector<std::string>> filters, uint32_t afterId, size_t limit)
+{
+    return m_backend.listAssetsPage(filters, afterId, limit);
+}
+
+//============================================================================================================
+
+void CachedStorage::unlinkAll(Asset& dest)
+{
+    m_backend.unlinkAll(dest);
+    written(dest.getInternalName());
+}
+
+// groups and relations are not part of cached assets
+void CachedStorage::clearGroup(Asset& asset)
+{
+    m_backend.clearGroup(asset);
+}
+
+void CachedStorage::removeFromRelations(Asset& asset)
+{
+    m_backend.removeFromRelations(asset);
+}
+
+void CachedStorage::removeFromGroups(Asset& asset)
+{
+    m_backend.removeFromGroups(asset);
+}
+
+void CachedStorage::removeAsset(Asset& asset)
+{
+    m_backend.removeAsset(asset);
+    removed({asset.getInternalName()});
+}
+
+void CachedStorage::removeExtMap(Asset& asset)
+{
+    m_backend.removeExtMap(asset);
+    written(asset.getInternalName());
+}
+
+void CachedStorage::unlinkAssets(const std::vector<std::string>& inames)
+{
+    m_backend.unlinkAssets(inames);
+    written(inames);
+}
+
+void CachedStorage::removeAssets(const std::vector<std::string>& inames)
+{
+    m_backend.removeAssets(inames);
+    removed(inames);
+}
+
+void CachedStorage::beginTransaction()
+{
+    m_backend.beginTransaction();
+    t_depth++;
+}
+
+void CachedStorage::rollbackTransaction()
+{
+    try {
+        m_backend.rollbackTransaction();
+    } catch (...) {
+        endTransaction(true);
+        throw;
+    }
+    endTransaction(true);
+}
+
+void CachedStorage::commitTransaction()
+{
+    try {
+        m_backend.commitTransaction();
+    } catch (...) {
+        endTransaction(true);
+        throw;
+    }
+    endTransaction(false);
+}
+
+void CachedStorage::update(Asset& asset)
+{
+    m_backend.update(asset);
+    written(asset.getInternalName());
+}
+
+void CachedStorage::insert(Asset& asset)
+{
+    m_backend.insert(asset);
+    written(asset.getInternalName());
+}
+
+void CachedStorage::insertAssets(const std::vector<Asset*>& assets, bool saveLinks)
+{
+    m_backend.insertAssets(assets, saveLinks);
+    written(assets);
+}
+
+void CachedStorage::insertLinks(const std::vector<Asset*>& assets)
+{
+    m_backend.insertLinks(assets);
+    written(assets);
+}
+
+void CachedStorage::updateStatus(const std::vector<std::string>& inames, AssetStatus status)
+{
+    m_backend.updateStatus(inames, status);
+    written(inames);
+}
+
+void CachedStorage::saveLinkedAssets(Asset& asset)
+{
+    m_backend.saveLinkedAssets(asset);
+    written(asset.getInternalName());
+}
+
+void CachedStorage::saveExtMap(Asset& asset)
+{
+    m_backend.saveExtMap(asset);
+    written(asset.getInternalName());
+}
+
+//============================================================================================================
+
+uint64_t CachedStorage::generation() const
+{
+    std::unique_lock<std::mutex> lock(m_lock);
+    return m_generation;
+}
+
+bool CachedStorage::find(const std::string& iname, Asset& asset)
+{
+    std::unique_lock<std::mutex> lock(m_lock);
+
+    auto it = m_assets.find(iname);
+    if (it == m_assets.end()) {
+        m_misses++;
+        return false;
+    }
+    if (Clock::now() - it->second.loaded > m_ttl) {
+        erase(iname);
+        m_misses++;
+        return false;
+    }
+    m_hits++;
+    m_lru.splice(m_lru.begin(), m_lru, it->second.lru);
+    copyAll(it->second.asset, asset);
+    return true;
+}
+
+bool CachedStorage::hydrate(const std::string& iname, Asset& asset)
+{
+    uint64_t gen = generation();
+
+    asset.setInternalName(iname);
+    if (!m_backend.loadAssets({&asset})[0]) {
+        return false;
+    }
+    put(asset, gen);
+    return true;
+}
+
+void CachedStorage::put(const Asset& asset, uint64_t gen)
+{
+    // only what the storage loads is kept
+    Asset copy;
+    copyAll(asset, copy);
+    size_t bytes = footprint(copy);
+
+    std::unique_lock<std::mutex> lock(m_lock);
+
+    // asset may have been written while it was loaded
+    if (gen != m_generation) {
+        return;
+    }
+    const std::string& iname = copy.getInternalName();
+    erase(iname);
+
+    m_lru.push_front(iname);
+    m_assets.emplace(iname, Entry{copy, bytes, Clock::now(), m_lru.begin()});
+    m_bytes += bytes;
+
+    const std::string& uuid = copy.getUuid();
+    if (!uuid.empty()) {
+        auto prev = m_uuidOf.find(iname);
+        if (prev != m_uuidOf.end() && prev->second != uuid) {
+            m_uuids.erase(prev->second);
+        }
+        auto it = m_uuids.emplace(uuid, iname);
+        if (it.second) {
+            m_indexBytes += indexBytes(uuid, iname);
+        } else {
+            it.first->second = iname;
+        }
+        m_uuidOf[iname] = uuid;
+    }
+    trim();
+}
+
+void CachedStorage::putId(const std::string& iname, uint32_t id, uint64_t gen)
+{
+    std::unique_lock<std::mutex> lock(m_lock);
+
+    if (gen != m_generation) {
+        return;
+    }
+    if (m_ids.emplace(iname, id).second) {
+        m_inames[id] = iname;
+        m_indexBytes += indexBytes(iname, std::string());
+    }
+    trim();
+}
+
+void CachedStorage::putUuid(const std::string& uuid, const std::string& iname, uint64_t gen)
+{
+    std::unique_lock<std::mutex> lock(m_lock);
+
+    if (gen != m_generation) {
+        return;
+    }
+    if (m_uuids.emplace(uuid, iname).second) {
+        m_uuidOf[iname] = uuid;
+        m_indexBytes += indexBytes(uuid, iname);
+    }
+    trim();
+}
+
+void CachedStorage::written(const std::string& iname)
+{
+    written(std::vector<std::string>{iname});
+}
+
+void CachedStorage::written(const std::vector<Asset*>& assets)
+{
+    std::vector<std::string> inames;
+    for (const auto asset : assets) {
+        inames.push_back(asset->getInternalName());
+    }
+    written(inames);
+}
+
+void CachedStorage::written(const std::vector<std::string>& inames)
+{
+    std::unique_lock<std::mutex> lock(m_lock);
+
+    for (const auto& iname : inames) {
+        forget(iname);
+        if (t_depth > 0) {
+            t_written.push_back(iname);
+        }
+    }
+    m_generation++;
+}
+
+// cached assets in the hierarchy or linked to removed assets changed too
+void CachedStorage::removed(const std::vector<std::string>& inames)
+{
+    std::set<std::string> gone(inames.begin(), inames.end());
+
+    std::vector<std::string> related;
+    {
+        std::unique_lock<std::mutex> lock(m_lock);
+        for (const auto& it : m_assets) {
+            bool linked = gone.count(it.second.asset.getParentIname()) > 0;
+            for (const auto& link : it.second.asset.getLinkedAssets()) {
+                linked = linked || gone.count(link.sourceId()) > 0;
+            }
+            if (linked) {
+                related.push_back(it.first);
+            }
+        }
+        for (const auto& iname : inames) {
+            eraseIndex(iname);
+        }
+    }
+    related.insert(related.end(), inames.begin(), inames.end());
+    written(related);
+}
+
+void CachedStorage::erase(const std::string& iname)
+{
+    auto it = m_assets.find(iname);
+    if (it == m_assets.end()) {
+        return;
+    }
+    m_bytes -= it->second.bytes;
+    m_lru.erase(it->second.lru);
+    m_assets.erase(it);
+}
+
+// id of an asset never changes, its uuid may
+void CachedStorage::forget(const std::string& iname)
+{
+    erase(iname);
+    auto uuid = m_uuidOf.find(iname);
+    if (uuid != m_uuidOf.end()) {
+        m_uuids.erase(uuid->second);
+        m_uuidOf.erase(uuid);
+    }
+}
+
+void CachedStorage::eraseIndex(const std::string& iname)
+{
+    auto id = m_ids.find(iname);
+    if (id != m_ids.end()) {
+        m_inames.erase(id->second);
+        m_ids.erase(id);
+    }
+    auto uuid = m_uuidOf.find(iname);
+    if (uuid != m_uuidOf.end()) {
+        m_uuids.erase(uuid->second);
+        m_uuidOf.erase(uuid);
+    }
+}
+
+// assets not used for longest go first, indexes are small and dropped at once over a quarter of the budget
+void CachedStorage::trim()
+{
+    while (m_bytes > m_budget && !m_lru.empty()) {
+        erase(m_lru.back());
+    }
+    if (m_indexBytes > m_budget / 4) {
+        m_ids.clear();
+        m_inames.clear();
+        m_uuids.clear();
+        m_uuidOf.clear();
+        m_indexBytes = 0;
+    }
+}
+
+void CachedStorage::endTransaction(bool rolledBack)
+{
+    if (rolledBack) {
+        t_rolledBack = true;
+    }
+    if (t_depth == 0 || --t_depth > 0) {
+        return;
+    }
+
+    // values read while the transaction was running may be the ones it changed or the ones it replaced
+    std::vector<std::string> inames;
+    inames.swap(t_written);
+    rolledBack   = t_rolledBack;
+    t_rolledBack = false;
+
+    std::unique_lock<std::mutex> lock(m_lock);
+    for (const auto& iname : inames) {
+        forget(iname);
+        // ids of assets inserted by a rolled back transaction do not exist anymore
+        if (rolledBack) {
+            eraseIndex(iname);
+        }
+    }
+    m_generation++;
+}
+
+} // namespace fty
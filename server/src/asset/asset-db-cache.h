@@ -0,0 +1,164 @@
+/*  =========================================================================
+    asset_asset_db_cache - asset/asset-db-cache
+
+    Copyright (C) 2016 - 2020 Eaton
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+    =========================================================================
+*/
+
+#pragma once
+#include "asset-storage.h"
+#include <chrono>
+#include <cstdint>
+#include <fty_asset_dto.h>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace fty {
+
+// Read-through cache in front of another storage. Keeps fully loaded assets (with ext attributes
+// and links), iname <-> id and uuid -> iname in memory; everything else goes to the backend.
+// Writes go to the backend and drop the written assets, again when their transaction ends so that
+// values read in the meantime are not kept. Assets not used for longest are dropped over the budget,
+// and assets older than ttl are loaded again, so that changes made by other processes are seen.
+class CachedStorage : public AssetStorage
+{
+public:
+    explicit CachedStorage(AssetStorage& backend, size_t budget = 32 * 1024 * 1024,
+        std::chrono::seconds ttl = std::chrono::seconds(300));
+
+    CachedStorage(const CachedStorage&) = delete;
+    CachedStorage& operator=(const CachedStorage&) = delete;
+
+    // approximate memory used by cached data, in bytes
+    void setBudget(size_t bytes);
+    void setTtl(std::chrono::seconds ttl);
+
+    // asset changed outside of this storage
+    void invalidate(const std::string& iname);
+    void clear();
+
+    uint64_t hits() const;
+    uint64_t misses() const;
+    // number of cached assets and memory they use
+    size_t size() const;
+    size_t bytes() const;
+
+    void loadAsset(const std::string& nameId, Asset& asset);
+
+    void                       loadExtMap(Asset& asset);
+    void                       loadLinkedAssets(Asset& asset);
+    std::vector<std::string>   getChildren(const Asset& asset);
+    std::map<std::string, int> getDepths(const std::vector<std::string>& inames);
+    std::vector<bool>          loadAssets(const std::vector<Asset*>& assets);
+
+    fty::Expected<uint32_t> getID(const std::string& internalName);
+    uint32_t                getTypeID(const std::string& type);
+    uint32_t                getSubtypeID(const std::string& subtype);
+    bool                    verifyID(std::string& id);
+    std::vector<bool>       verifyIDs(const std::vector<std::string>& ids);
+
+    bool hasLinkedAssets(const Asset& asset);
+    void unlinkAll(Asset& dest);
+    void clearGroup(Asset& asset);
+    void removeAsset(Asset& asset);
+    void removeFromRelations(Asset& asset);
+    void removeFromGroups(Asset& asset);
+    void removeExtMap(Asset& asset);
+    bool isLastDataCenter(Asset& asset);
+
+    void                       unlinkAssets(const std::vector<std::string>& inames);
+    std::map<std::string, int> countChildren(const std::vector<std::string>& inames);
+    std::set<std::string>      getLinkSources(const std::vector<std::string>& inames);
+    int                        countDataCenters();
+    void                       removeAssets(const std::vector<std::string>& inames);
+
+    void beginTransaction();
+    void rollbackTransaction();
+    void commitTransaction();
+
+    void update(Asset& asset);
+    void insert(Asset& asset);
+    void insertAssets(const std::vector<Asset*>& assets, bool saveLinks = true);
+    void insertLinks(const std::vector<Asset*>& assets);
+    void updateStatus(const std::vector<std::string>& inames, AssetStatus status);
+
+    void                               saveLinkedAssets(Asset& asset);
+    void                               saveExtMap(Asset& asset);
+    std::string                        inameById(uint32_t id);
+    std::string                        inameByUuid(const std::string& uuid);
+    std::map<std::string, std::string> inamesByUuids(const std::vector<std::string>& uuids);
+
+    std::vector<std::string> listAssets(std::map<std::string, std::vector<std::string>> filters);
+    std::vector<std::string> listAllAssets();
+    std::vector<std::pair<uint32_t, std::string>> listAssetsPage(
+        std::map<std::string, std::vector<std::string>> filters, uint32_t afterId, size_t limit);
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Entry
+    {
+        Asset                            asset;
+        size_t                           bytes;
+        Clock::time_point                loaded;
+        std::list<std::string>::iterator lru;
+    };
+
+    AssetStorage&        m_backend;
+    size_t               m_budget;
+    std::chrono::seconds m_ttl;
+
+    mutable std::mutex                           m_lock;
+    std::unordered_map<std::string, Entry>       m_assets;
+    std::list<std::string>                       m_lru; // most recently used first
+    std::unordered_map<std::string, uint32_t>    m_ids;
+    std::unordered_map<uint32_t, std::string>    m_inames;
+    std::unordered_map<std::string, std::string> m_uuids;     // uuid -> iname
+    std::unordered_map<std::string, std::string> m_uuidOf;    // iname -> uuid, to drop m_uuids entries
+    size_t                                       m_bytes      = 0;
+    size_t                                       m_indexBytes = 0;
+    // incremented on every invalidation, values loaded across an invalidation are not kept
+    uint64_t m_generation = 0;
+    uint64_t m_hits       = 0;
+    uint64_t m_misses     = 0;
+
+    uint64_t generation() const;
+    // copy of the cached asset, false if not cached or expired
+    bool find(const std::string& iname, Asset& asset);
+    void put(const Asset& asset, uint64_t generation);
+    void putId(const std::string& iname, uint32_t id, uint64_t generation);
+    void putUuid(const std::string& uuid, const std::string& iname, uint64_t generation);
+    // loads the whole asset from backend and keeps it, false if it does not exist
+    bool hydrate(const std::string& iname, Asset& asset);
+
+    // asset written, dropped now and when the transaction of the calling thread ends
+    void written(const std::string& iname);
+    void written(const std::vector<std::string>& inames);
+    void written(const std::vector<Asset*>& assets);
+    void removed(const std::vector<std::string>& inames);
+    // called locked
+    void erase(const std::string& iname);
+    void forget(const std::string& iname);
+    void eraseIndex(const std::string& iname);
+    void trim();
+    void endTransaction(bool rolledBack);
+};
+
+} // namespace fty
@@ -68,6 +68,19 @@ std::vector<std::string> DBTest::getChildren(const Asset& /*asset*/)
     return children;
 }
 
+std::map<std::string, int> DBTest::getDepths(const std::vector<std::string>& inames)
+{
+    std::cout << "DBTest::getDepths" << std::endl;
+    std::map<std::string, int> depths;
+
+    // children returned by getChildren are one level below the other assets
+    for (const auto& iname : inames) {
+        depths[iname] = iname.compare(0, 6, "child-") == 0 ? 1 : 0;
+    }
+
+    return depths;
+}
+
 void DBTest::loadLinkedAssets(Asset& asset)
 {
     std::cout << "DBTest::loadLinkedAssets" << std::endl;
@@ -80,12 +93,59 @@ void DBTest::loadLinkedAssets(Asset& asset)
 }
 
 
+std::vector<bool> DBTest::loadAssets(const std::vector<Asset*>& assets)
+{
+    std::cout << "DBTest::loadAssets" << std::endl;
+
+    for (auto asset : assets) {
+        loadAsset(asset->getInternalName(), *asset);
+        loadExtMap(*asset);
+        loadLinkedAssets(*asset);
+    }
+    return std::vector<bool>(assets.size(), true);
+}
+
 bool DBTest::isLastDataCenter(Asset& asset)
 {
     std::cout << "DBTest::isLastDataCenter" << std::endl;
     return asset.getInternalName() == "dc-0";
 }
 
+void DBTest::unlinkAssets(const std::vector<std::string>& inames)
+{
+    std::cout << "DBTest::unlinkAssets " << inames.size() << std::endl;
+}
+
+std::map<std::string, int> DBTest::countChildren(const std::vector<std::string>& inames)
+{
+    std::cout << "DBTest::countChildren" << std::endl;
+    std::map<std::string, int> children;
+
+    // as getChildren
+    for (const auto& iname : inames) {
+        children[iname] = 2;
+    }
+
+    return children;
+}
+
+std::set<std::string> DBTest::getLinkSources(const std::vector<std::string>& /*inames*/)
+{
+    std::cout << "DBTest::getLinkSources" << std::endl;
+    return {};
+}
+
+int DBTest::countDataCenters()
+{
+    std::cout << "DBTest::countDataCenters" << std::endl;
+    return 1;
+}
+
+void DBTest::removeAssets(const std::vector<std::string>& inames)
+{
+    std::cout << "DBTest::removeAssets " << inames.size() << std::endl;
+}
+
 void DBTest::removeFromGroups(Asset& /*asset*/)
 {
     std::cout << "DBTest::removeFromGroups" << std::endl;
@@ -135,6 +195,12 @@ bool DBTest::verifyID(std::string& id)
     return true;
 }
 
+std::vector<bool> DBTest::verifyIDs(const std::vector<std::string>& ids)
+{
+    std::cout << "DBTest::verifyIDs " << ids.size() << std::endl;
+    return std::vector<bool>(ids.size(), true);
+}
+
 bool DBTest::hasLinkedAssets(const Asset& /*asset*/)
 {
     std::cout << "DBTest::hasLinkedAssets" << std::endl;
@@ -171,6 +237,21 @@ void DBTest::insert(Asset& /*asset*/)
     std::cout << "DBTest::insert" << std::endl;
 }
 
+void DBTest::insertAssets(const std::vector<Asset*>& assets, bool /*saveLinks*/)
+{
+    std::cout << "DBTest::insertAssets " << assets.size() << std::endl;
+}
+
+void DBTest::insertLinks(const std::vector<Asset*>& assets)
+{
+    std::cout << "DBTest::insertLinks " << assets.size() << std::endl;
+}
+
+void DBTest::updateStatus(const std::vector<std::string>& inames, AssetStatus /*status*/)
+{
+    std::cout << "DBTest::updateStatus " << inames.size() << std::endl;
+}
+
 std::string DBTest::inameById(uint32_t /*id*/)
 {
     std::cout << "DBTest::inameById" << std::endl;
@@ -183,6 +264,16 @@ std::string DBTest::inameByUuid(const std::string& /*uuid*/)
     return "DC-1";
 }
 
+std::map<std::string, std::string> DBTest::inamesByUuids(const std::vector<std::string>& uuids)
+{
+    std::cout << "DBTest::inamesByUuids" << std::endl;
+    std::map<std::string, std::string> inames;
+    for (const auto& uuid : uuids) {
+        inames[uuid] = inameByUuid(uuid);
+    }
+    return inames;
+}
+
 void DBTest::saveLinkedAssets(Asset& /*asset*/)
 {
     std::cout << "DBTest::saveLinkedAssets" << std::endl;
@@ -225,4 +316,20 @@ std::vector<std::string> DBTest::listAllAssets()
     return assetList;
 }
 
+std::vector<std::pair<uint32_t, std::string>> DBTest::listAssetsPage(
+    std::map<std::string, std::vector<std::string>> filters, uint32_t afterId, size_t limit)
+{
+    std::cout << "DBTest::listAssetsPage" << std::endl;
+
+    // ids are the positions in listAssets()
+    std::vector<std::pair<uint32_t, std::string>> assetList;
+    uint32_t                                      id = 0;
+    for (const auto& name : listAssets(filters)) {
+        if (++id > afterId && assetList.size() < limit) {
+            assetList.emplace_back(id, name);
+        }
+    }
+    return assetList;
+}
+
 } // namespace fty
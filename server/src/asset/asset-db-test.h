@@ -41,11 +41,14 @@ public:
     void                     loadExtMap(Asset& asset) override;
     void                     loadLinkedAssets(Asset& asset) override;
     std::vector<std::string> getChildren(const Asset& asset) override;
+    std::map<std::string, int> getDepths(const std::vector<std::string>& inames) override;
+    std::vector<bool>        loadAssets(const std::vector<Asset*>& assets) override;
 
     fty::Expected<uint32_t> getID(const std::string& internalName) override;
     uint32_t getTypeID(const std::string& type);
     uint32_t getSubtypeID(const std::string& subtype);
     bool verifyID(std::string& id);
+    std::vector<bool> verifyIDs(const std::vector<std::string>& ids) override;
 
     bool hasLinkedAssets(const Asset& asset) override;
     void unlinkAll(Asset& dest) override;
@@ -56,20 +59,32 @@ public:
     void removeExtMap(Asset& asset) override;
     bool isLastDataCenter(Asset& asset) override;
 
+    void                       unlinkAssets(const std::vector<std::string>& inames) override;
+    std::map<std::string, int> countChildren(const std::vector<std::string>& inames) override;
+    std::set<std::string>      getLinkSources(const std::vector<std::string>& inames) override;
+    int                        countDataCenters() override;
+    void                       removeAssets(const std::vector<std::string>& inames) override;
+
     void beginTransaction() override;
     void rollbackTransaction() override;
     void commitTransaction() override;
 
     void update(Asset& asset) override;
     void insert(Asset& asset) override;
+    void insertAssets(const std::vector<Asset*>& assets, bool saveLinks = true) override;
+    void insertLinks(const std::vector<Asset*>& assets) override;
+    void updateStatus(const std::vector<std::string>& inames, AssetStatus status) override;
 
     void        saveLinkedAssets(Asset& asset) override;
     void        saveExtMap(Asset& asset) override;
     std::string inameById(uint32_t id) override;
     std::string inameByUuid(const std::string& uuid) override;
+    std::map<std::string, std::string> inamesByUuids(const std::vector<std::string>& uuids) override;
 
     std::vector<std::string> listAssets(std::map<std::string, std::vector<std::string>> filters) override;
     std::vector<std::string> listAllAssets() override;
+    std::vector<std::pair<uint32_t, std::string>> listAssetsPage(
+        std::map<std::string, std::vector<std::string>> filters, uint32_t afterId, size_t limit) override;
 
 private:
     DBTest();
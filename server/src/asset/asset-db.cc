@@ -26,38 +26,161 @@
 #include <sstream>
 #include <tntdb.h>
 #include <map>
+#include <set>
+#include <tuple>
 #include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <iterator>
 
 #include <cassert>
 
-#include "fty-lock.h"
+#include "request-stats.h"
 namespace fty {
 
 // static helpers
 
+// max number of values bound in one IN (...) clause of the bulk loaders, a power of two (see listArity)
+static constexpr size_t IN_BATCH_SIZE = 512;
+
+// unknown type names do not read the types again more often, so that a client sending them does not
+// cost a query each time
+static constexpr std::chrono::seconds TYPES_REFRESH_INTERVAL(10);
+
+// number of placeholders of a list of count values: the next power of two, so that a few statements
+// are prepared (and cached by the connection) whatever the number of values; lists are padded with
+// their last value, which does not change the result of IN or OR
+static size_t listArity(size_t count)
+{
+    size_t arity = 1;
+    while (arity < count) {
+        arity *= 2;
+    }
+    return arity;
+}
+
+// ":v0, :v1, ..." placeholders of an IN clause of count values
+static std::string inPlaceholders(size_t count)
+{
+    std::string placeholders;
+    for (size_t i = 0; i < count; i++) {
+        placeholders.append(i ? ", :v" : ":v").append(std::to_string(i));
+    }
+    return placeholders;
+}
+
+// names of types and subtypes are compared case insensitively by the database
+static std::string lowerName(const std::string& name)
+{
+    std::string lower(name);
+    std::transform(lower.begin(), lower.end(), lower.begin(), [](unsigned char c) {
+        return std::tolower(c);
+    });
+    return lower;
+}
+
+// asset names as compared by the database: case insensitive, trailing spaces ignored
+static std::string comparedName(const std::string& name)
+{
+    std::string compared = lowerName(name);
+    compared.erase(compared.find_last_not_of(' ') + 1);
+    return compared;
+}
+
+// id of name in a dictionary sorted by name, 0 if unknown
+static uint32_t findName(const std::vector<std::pair<std::string, uint32_t>>& dictionary, const std::string& name)
+{
+    std::string lower = lowerName(name);
+    auto        it    = std::lower_bound(dictionary.begin(), dictionary.end(), lower,
+        [](const std::pair<std::string, uint32_t>& entry, const std::string& key) {
+            return entry.first < key;
+        });
+    return (it != dictionary.end() && it->first == lower) ? it->second : 0;
+}
+
+// row of the loadAsset query
+static void fillAsset(const tntdb::Row& row, Asset& asset)
+{
+    asset.setInternalName(row.getString("name"));
+    asset.setAssetType(row.getString("type"));
+    asset.setAssetSubtype(row.getString("subType"));
+    if (!row.isNull("parentName")) {
+        asset.setParentIname(row.getString("parentName"));
+    }
+    asset.setAssetStatus(stringToAssetStatus(row.getString("status")));
+    asset.setPriority(row.getInt("priority"));
+    if (!row.isNull("tag")) {
+        asset.setAssetTag(row.getString("tag"));
+    }
+    if (!row.isNull("idSecondary")) {
+        asset.setSecondaryID(row.getString("idSecondary"));
+    }
+}
+
+// row of the loadLinkedAssets query
+static AssetLink linkFromRow(const tntdb::Row& row)
+{
+    std::string srcOut, destIn;
+    // may be NULL
+    if (!row.isNull("srcOut")) {
+        row.getString("srcOut", srcOut);
+    }
+    if (!row.isNull("destIn")) {
+        row.getString("destIn", destIn);
+    }
+    return AssetLink(row.getString("name"), srcOut, destIn, row.getInt("linkType"));
+}
+
 // DB
 DB::DB()
+    : m_pool(
+          [] {
+              return tntdb::connect(DBConn::url);
+          },
+          4,
+          [](tntdb::Connection& conn) {
+              return conn.ping();
+          })
+{
+    // reference data, read once at start-up; if the database is not ready yet, it is read on first use
+    try {
+        refreshTypes();
+    } catch (const std::exception& e) {
+        log_warning("Asset types not loaded: %s", e.what());
+    }
+}
+
+CountedStatement DB::prepare(const std::string& query)
+{
+    // statements are cached by the connection
+    return CountedStatement(m_pool.current().prepareCached(query));
+}
+
+CountedStatement DB::prepareOnce(const std::string& query)
 {
-    // m_conn = tntdb::connectCached(DBConn::url);
+    return CountedStatement(m_pool.current().prepare(query));
 }
 
 DB& DB::getInstance()
 {
     static DB m_instance;
 
-    // fetches connection from pool, if exists
-    // creates a new connection otherwise
-    m_instance.m_conn = tntdb::connectCached(DBConn::url);
-
     return m_instance;
 }
 
+void DB::setPoolSize(size_t size)
+{
+    m_pool.setSize(size);
+}
+
 void DB::loadAsset(const std::string& nameId, Asset& asset)
 {
+    Lease lease(m_pool);
+
     tntdb::Row row;
 
     // clang-format off
-    auto q = m_conn.prepareCached(R"(
+    auto q = prepare(R"(
         SELECT
             a.id_asset_element AS id,
             a.name             AS name,
@@ -80,7 +203,6 @@ void DB::loadAsset(const std::string& nameId, Asset& asset)
     // clang-format on
 
     try {
-        Lock lock(m_conn_lock);
         row = q.selectRow();
 
     } catch (std::exception& e) {
@@ -88,31 +210,20 @@ void DB::loadAsset(const std::string& nameId, Asset& asset)
         throw std::runtime_error("database error - " + std::string(e.what()));
     }
 
-    asset.setInternalName(row.getString("name"));
-    asset.setAssetType(row.getString("type"));
-    asset.setAssetSubtype(row.getString("subType"));
-    if (!row.isNull("parentName")) {
-        asset.setParentIname(row.getString("parentName"));
-    }
-    asset.setAssetStatus(stringToAssetStatus(row.getString("status")));
-    asset.setPriority(row.getInt("priority"));
-    if (!row.isNull("tag")) {
-        asset.setAssetTag(row.getString("tag"));
-    }
-    if (!row.isNull("idSecondary")) {
-        asset.setSecondaryID(row.getString("idSecondary"));
-    }
+    fillAsset(row, asset);
 }
 
 void DB::loadExtMap(Asset& asset)
 {
+    Lease lease(m_pool);
+
     auto assetID = getID(asset.getInternalName());
     if(!assetID) {
         throw std::runtime_error(assetID.error());
     }
 
     // clang-format off
-    auto q = m_conn.prepareCached(R"(
+    auto q = prepare(R"(
         SELECT
             keytag,
             value,
@@ -128,7 +239,6 @@ void DB::loadExtMap(Asset& asset)
     tntdb::Result res;
 
     try {
-        Lock lock(m_conn_lock);
         res = q.select();
 
     } catch (std::exception& e) {
@@ -145,13 +255,15 @@ void DB::loadExtMap(Asset& asset)
 
 std::vector<std::string> DB::getChildren(const Asset& asset)
 {
+    Lease lease(m_pool);
+
     auto assetID = getID(asset.getInternalName());
     if(!assetID) {
         throw std::runtime_error(assetID.error());
     }
 
     // clang-format off
-    auto q = m_conn.prepareCached(R"(
+    auto q = prepare(R"(
         SELECT
             name
         FROM
@@ -165,7 +277,6 @@ std::vector<std::string> DB::getChildren(const Asset& asset)
     tntdb::Result res;
 
     try {
-        Lock lock(m_conn_lock);
         res = q.select();
 
     } catch (std::exception& e) {
@@ -184,8 +295,10 @@ std::vector<std::string> DB::getChildren(const Asset& asset)
 // returns fty::unexpected if internal name is not found, the integer ID otherwise
 fty::Expected<uint32_t> DB::getID(const std::string& internalName)
 {
+    Lease lease(m_pool);
+
     // clang-format off
-    auto q = m_conn.prepareCached(R"(
+    auto q = prepare(R"(
         SELECT
             id_asset_element
         FROM
@@ -199,7 +312,6 @@ fty::Expected<uint32_t> DB::getID(const std::string& internalName)
     uint32_t assetID = 0;
 
     try {
-        Lock lock(m_conn_lock);
         auto v = q.selectValue();
 
 
@@ -215,85 +327,115 @@ fty::Expected<uint32_t> DB::getID(const std::string& internalName)
     return assetID;
 }
 
-uint32_t DB::getTypeID(const std::string& type)
+void DB::refreshTypes()
 {
+    Lease lease(m_pool);
+
+    auto types = std::make_shared<Types>();
+
     // clang-format off
-    auto q = m_conn.prepareCached(R"(
+    auto typesQuery = prepare(R"(
         SELECT
-            id_asset_element_type
+            id_asset_element_type AS id,
+            name
         FROM
             t_bios_asset_element_type
-        WHERE
-            name = :type_name
+    )");
+    auto subtypesQuery = prepare(R"(
+        SELECT
+            id_asset_device_type AS id,
+            name
+        FROM
+            t_bios_asset_device_type
     )");
     // clang-format on
-    q.set("type_name", type);
-
-    uint32_t typeID = 0;
 
     try {
-        Lock lock(m_conn_lock);
-        auto v = q.selectValue();
-
-
-        typeID = static_cast<uint32_t>(v.getInt32());
-    } catch (tntdb::NotFound&) {
-
+        for (const auto& row : typesQuery.select()) {
+            types->types.emplace_back(lowerName(row.getString("name")), static_cast<uint32_t>(row.getInt32("id")));
+        }
+        for (const auto& row : subtypesQuery.select()) {
+            types->subtypes.emplace_back(lowerName(row.getString("name")), static_cast<uint32_t>(row.getInt32("id")));
+        }
     } catch (std::exception& e) {
 
         throw std::runtime_error("database error - " + std::string(e.what()));
     }
 
-    return typeID;
-}
-uint32_t DB::getSubtypeID(const std::string& subtype)
-{
-    // clang-format off
-    auto q = m_conn.prepareCached(R"(
-        SELECT
-            id_asset_device_type
-        FROM
-            t_bios_asset_device_type
-        WHERE
-            name = :subtype_name
-    )");
-    // clang-format on
-    q.set("subtype_name", subtype);
-
-    uint32_t subtypeID = 0;
+    std::sort(types->types.begin(), types->types.end());
+    std::sort(types->subtypes.begin(), types->subtypes.end());
+    types->loaded = std::chrono::steady_clock::now();
 
-    try {
-        Lock lock(m_conn_lock);
-        auto v = q.selectValue();
+    std::unique_lock<std::mutex> lock(m_typesLock);
+    m_types = types;
+}
 
+std::shared_ptr<const DB::Types> DB::types()
+{
+    {
+        std::unique_lock<std::mutex> lock(m_typesLock);
+        if (m_types) {
+            return m_types;
+        }
+    }
+    refreshTypes();
 
-        subtypeID = static_cast<uint32_t>(v.getInt32());
-    } catch (tntdb::NotFound&) {
+    std::unique_lock<std::mutex> lock(m_typesLock);
+    return m_types;
+}
 
-    } catch (std::exception& e) {
+std::shared_ptr<const DB::Types> DB::typesAfterMiss()
+{
+    auto current = types();
+    if (std::chrono::steady_clock::now() - current->loaded < TYPES_REFRESH_INTERVAL) {
+        return current;
+    }
+    refreshTypes();
+    return types();
+}
 
-        throw std::runtime_error("database error - " + std::string(e.what()));
+// types are reference data, read again only when a name is unknown, in case it was added since
+uint32_t DB::getTypeID(const std::string& type)
+{
+    if (type.empty()) {
+        return 0;
     }
+    uint32_t typeID = findName(types()->types, type);
+    if (typeID == 0) {
+        typeID = findName(typesAfterMiss()->types, type);
+    }
+    return typeID;
+}
 
+uint32_t DB::getSubtypeID(const std::string& subtype)
+{
+    if (subtype.empty()) {
+        return 0;
+    }
+    uint32_t subtypeID = findName(types()->subtypes, subtype);
+    if (subtypeID == 0) {
+        subtypeID = findName(typesAfterMiss()->subtypes, subtype);
+    }
     return subtypeID;
 }
 
 bool DB::verifyID(std::string& id) {
+    Lease lease(m_pool);
+
     // clang-format off
-    auto q = m_conn.prepare(R"(
+    CountedStatement q(m_pool.current().prepare(R"(
         SELECT
             COUNT(id_asset_element)
         FROM
             t_bios_asset_element
         WHERE
             name like :name
-    )");
+    )"));
     // clang-format on
     q.set("name", "%" + id);
 
     int res;
     try {
-        Lock lock(m_conn_lock);
         res = q.selectValue().getInt();
 
     } catch (std::exception& e) {
@@ -306,6 +448,8 @@ bool DB::verifyID(std::string& id) {
 
 uint32_t DB::getLinkID(const uint32_t destId, const AssetLink& l)
 {
+    Lease lease(m_pool);
+
     uint32_t linkID = 0;
 
     auto srcId = getID(l.sourceId());
@@ -315,7 +459,7 @@ uint32_t DB::getLinkID(const uint32_t destId, const AssetLink& l)
 
     assert(destId);
 
-    tntdb::Statement q;
+    CountedStatement q;
 
     std::stringstream qs;
 
@@ -352,7 +496,7 @@ uint32_t DB::getLinkID(const uint32_t destId, const AssetLink& l)
         "    id_asset_link_type = :linkType";
     // clang-format off
 
-    q = m_conn.prepareCached(qs.str().c_str());
+    q = prepare(qs.str().c_str());
 
     q.set("src", *srcId);
     q.set("dest", destId);
@@ -365,7 +509,6 @@ uint32_t DB::getLinkID(const uint32_t destId, const AssetLink& l)
     q.set("linkType", l.linkType());
 
     try {
-        Lock lock(m_conn_lock);
         auto v = q.selectValue();
 
 
@@ -382,10 +525,12 @@ uint32_t DB::getLinkID(const uint32_t destId, const AssetLink& l)
 
 void DB::loadLinkExtMap(const uint32_t linkID, AssetLink& link)
 {
+    Lease lease(m_pool);
+
     assert(linkID);
 
     // clang-format off
-    auto q = m_conn.prepareCached(R"(
+    auto q = prepare(R"(
         SELECT
             keytag,
             value,
@@ -401,7 +546,6 @@ void DB::loadLinkExtMap(const uint32_t linkID, AssetLink& link)
     tntdb::Result res;
 
     try {
-        Lock lock(m_conn_lock);
         res = q.select();
 
     } catch (std::exception& e) {
@@ -418,6 +562,8 @@ void DB::loadLinkExtMap(const uint32_t linkID, AssetLink& link)
 
 void DB::saveLinkExtMap(const uint32_t linkID, const AssetLink& link)
 {
+    Lease lease(m_pool);
+
     /*
      * Here is the strategy to save the external attributes:
      * 1. We insert, update or remove only the external attribute which has been modified.
@@ -429,7 +575,7 @@ void DB::saveLinkExtMap(const uint32_t linkID, const AssetLink& link)
     }
 
     // clang-format off
-    auto q = m_conn.prepareCached(R"(
+    auto q = prepare(R"(
         SELECT
             id_asset_link_attribute AS id,
             keytag                  AS keytag,
@@ -446,7 +592,6 @@ void DB::saveLinkExtMap(const uint32_t linkID, const AssetLink& link)
     tntdb::Result res;
 
     try {
-        Lock lock(m_conn_lock);
         res = q.select();
 
     } catch (std::exception& e) {
@@ -483,7 +628,7 @@ void DB::saveLinkExtMap(const uint32_t linkID, const AssetLink& link)
 
             if (!it.second.getValue().empty()) {
                 // clang-format off
-                auto q_ext_link = m_conn.prepareCached(R"(
+                auto q_ext_link = prepare(R"(
                     INSERT INTO t_bios_asset_link_attributes (keytag, value, id_link, read_only)
                     VALUES (:key, :value, :linkId, :readOnly)
                 )");
@@ -493,7 +638,6 @@ void DB::saveLinkExtMap(const uint32_t linkID, const AssetLink& link)
                 q_ext_link.set("readOnly", it.second.isReadOnly());
                 q_ext_link.set("linkId", linkID);
                 try {
-                    Lock lock(m_conn_lock);
                     q_ext_link.execute();
 
                 } catch (std::exception& e) {
@@ -508,7 +652,7 @@ void DB::saveLinkExtMap(const uint32_t linkID, const AssetLink& link)
 
             if (!it.second.getValue().empty()) {
                 // clang-format off
-                auto q_ext_link = m_conn.prepareCached(R"(
+                auto q_ext_link = prepare(R"(
                     UPDATE t_bios_asset_link_attributes
                     SET
                         value = :value,
@@ -521,7 +665,6 @@ void DB::saveLinkExtMap(const uint32_t linkID, const AssetLink& link)
                 q_ext_link.set("extId", std::get<0>(*found));
 
                 try {
-                    Lock lock(m_conn_lock);
                     q_ext_link.execute();
 
                 } catch (std::exception& e) {
@@ -536,7 +679,7 @@ void DB::saveLinkExtMap(const uint32_t linkID, const AssetLink& link)
 
     for (const auto& toRem : toBeRemoved) {
         // clang-format off
-        auto q_ext_link = m_conn.prepareCached(R"(
+        auto q_ext_link = prepare(R"(
             DELETE FROM t_bios_asset_link_attributes
             WHERE id_asset_link_attribute = :extId
         )");
@@ -544,7 +687,6 @@ void DB::saveLinkExtMap(const uint32_t linkID, const AssetLink& link)
         q_ext_link.set("extId", std::get<0>(toRem));
 
         try {
-            Lock lock(m_conn_lock);
             q_ext_link.execute();
 
         } catch (std::exception& e) {
@@ -556,13 +698,15 @@ void DB::saveLinkExtMap(const uint32_t linkID, const AssetLink& link)
 
 void DB::loadLinkedAssets(Asset& asset)
 {
+    Lease lease(m_pool);
+
     auto assetID = getID(asset.getInternalName());
     if(!assetID) {
         throw std::runtime_error(assetID.error());
     };
 
     // clang-format off
-    auto q = m_conn.prepareCached(R"(
+    auto q = prepare(R"(
         SELECT
             l.id_link               AS link_id,
             e.name                  AS name,
@@ -582,7 +726,6 @@ void DB::loadLinkedAssets(Asset& asset)
     tntdb::Result res;
 
     try {
-        Lock lock(m_conn_lock);
         res = q.select();
 
     } catch (std::exception& e) {
@@ -592,17 +735,8 @@ void DB::loadLinkedAssets(Asset& asset)
 
     std::vector<AssetLink> links;
     for (const auto& row : res) {
-        uint32_t    linkID = row.getUnsigned32("link_id");
-        std::string srcOut, destIn;
-        // may be NULL
-        if (!row.isNull("srcOut")) {
-            row.getString("srcOut", srcOut);
-        }
-        if (!row.isNull("destIn")) {
-            row.getString("destIn", destIn);
-        }
-
-        AssetLink l(row.getString("name"), srcOut, destIn, row.getInt("linkType"));
+        uint32_t  linkID = row.getUnsigned32("link_id");
+        AssetLink l      = linkFromRow(row);
         loadLinkExtMap(linkID, l);
 
         links.push_back(l);
@@ -610,8 +744,214 @@ void DB::loadLinkedAssets(Asset& asset)
     asset.setLinkedAssets(links);
 }
 
+template <typename Values, typename Callback>
+void DB::selectIn(const std::string& query, const Values& values, const Callback& cb)
+{
+    auto it = values.begin();
+    while (it != values.end()) {
+        size_t count = std::min(IN_BATCH_SIZE, static_cast<size_t>(std::distance(it, values.end())));
+
+        size_t      arity = listArity(count);
+        std::string sql   = query;
+        sql.replace(sql.find("%s"), 2, inPlaceholders(arity));
+        auto q    = prepare(sql);
+        auto last = it;
+        for (size_t i = 0; i < count; ++i, ++it) {
+            q.set("v" + std::to_string(i), *it);
+            last = it;
+        }
+        for (size_t i = count; i < arity; ++i) {
+            q.set("v" + std::to_string(i), *last);
+        }
+
+        tntdb::Result res;
+        try {
+            res = q.select();
+
+        } catch (std::exception& e) {
+
+            throw std::runtime_error("database error - " + std::string(e.what()));
+        }
+        for (const auto& row : res) {
+            cb(row);
+        }
+    }
+}
+
+template <typename Values>
+void DB::executeIn(const std::string& query, const Values& values)
+{
+    auto it = values.begin();
+    while (it != values.end()) {
+        size_t count = std::min(IN_BATCH_SIZE, static_cast<size_t>(std::distance(it, values.end())));
+
+        size_t      arity = listArity(count);
+        std::string sql   = query;
+        sql.replace(sql.find("%s"), 2, inPlaceholders(arity));
+        auto q    = prepare(sql);
+        auto last = it;
+        for (size_t i = 0; i < count; ++i, ++it) {
+            q.set("v" + std::to_string(i), *it);
+            last = it;
+        }
+        for (size_t i = count; i < arity; ++i) {
+            q.set("v" + std::to_string(i), *last);
+        }
+
+        try {
+            q.execute();
+
+        } catch (std::exception& e) {
+
+            throw std::runtime_error("database error - " + std::string(e.what()));
+        }
+    }
+}
+
+std::vector<uint32_t> DB::getIDs(const std::vector<std::string>& inames)
+{
+    Lease lease(m_pool);
+
+    std::vector<uint32_t> ids;
+    selectIn("SELECT id_asset_element AS id FROM t_bios_asset_element WHERE name IN (%s)", inames,
+        [&ids](const tntdb::Row& row) {
+            ids.push_back(row.getUnsigned32("id"));
+        });
+    return ids;
+}
+
+std::vector<bool> DB::loadAssets(const std::vector<Asset*>& assets)
+{
+    Lease lease(m_pool);
+
+    std::vector<bool> found(assets.size(), false);
+
+    // names are compared as the database does, so that a row is matched with the inames it was selected for
+    std::map<std::string, std::vector<size_t>> byName; // compared iname -> positions in assets
+    std::set<std::string>                       names;
+    for (size_t i = 0; i < assets.size(); i++) {
+        byName[comparedName(assets[i]->getInternalName())].push_back(i);
+        names.insert(assets[i]->getInternalName());
+    }
+
+    // clang-format off
+    std::map<uint32_t, std::vector<size_t>> byId; // asset id -> positions in assets
+    selectIn(R"(
+        SELECT
+            a.id_asset_element AS id,
+            a.name             AS name,
+            e.name             AS type,
+            d.name             AS subType,
+            p.name             AS parentName,
+            a.status           AS status,
+            a.priority         AS priority,
+            a.asset_tag        AS tag,
+            a.id_secondary     AS idSecondary
+        FROM t_bios_asset_element AS a
+            INNER JOIN t_bios_asset_device_type AS d
+            INNER JOIN t_bios_asset_element_type AS e
+            ON a.id_type = e.id_asset_element_type AND a.id_subtype = d.id_asset_device_type
+            LEFT JOIN t_bios_asset_element AS p
+            ON a.id_parent = p.id_asset_element
+        WHERE a.name IN (%s)
+    )", names, [&](const tntdb::Row& row) {
+        auto it = byName.find(comparedName(row.getString("name")));
+        if (it == byName.end()) {
+            return;
+        }
+        for (size_t pos : it->second) {
+            fillAsset(row, *assets[pos]);
+            assets[pos]->clearExtMap();
+            found[pos] = true;
+        }
+        byId[row.getUnsigned32("id")] = it->second;
+    });
+    // clang-format on
+
+    std::set<uint32_t> ids;
+    for (const auto& it : byId) {
+        ids.insert(it.first);
+    }
+
+    // clang-format off
+    selectIn(R"(
+        SELECT
+            id_asset_element,
+            keytag,
+            value,
+            read_only
+        FROM
+            t_bios_asset_ext_attributes
+        WHERE
+            id_asset_element IN (%s)
+        ORDER BY id_asset_element, id_asset_ext_attribute
+    )", ids, [&](const tntdb::Row& row) {
+        for (size_t pos : byId[row.getUnsigned32("id_asset_element")]) {
+            assets[pos]->setExtEntry(row.getString("keytag"), row.getString("value"), row.getBool("read_only"), true);
+        }
+    });
+
+    std::map<uint32_t, std::vector<std::pair<uint32_t, AssetLink>>> links; // asset id -> (link id, link)
+    std::set<uint32_t>                                                linkIds;
+    selectIn(R"(
+        SELECT
+            l.id_link               AS link_id,
+            l.id_asset_device_dest  AS dest_id,
+            e.name                  AS name,
+            l.src_out               AS srcOut,
+            l.dest_in               AS destIn,
+            l.id_asset_link_type    AS linkType
+        FROM
+            t_bios_asset_link AS l
+        INNER JOIN
+            t_bios_asset_element AS e ON l.id_asset_device_src = e.id_asset_element
+        WHERE
+            l.id_asset_device_dest IN (%s)
+        ORDER BY l.id_asset_device_dest, l.id_link
+    )", ids, [&](const tntdb::Row& row) {
+        uint32_t linkID = row.getUnsigned32("link_id");
+        links[row.getUnsigned32("dest_id")].emplace_back(linkID, linkFromRow(row));
+        linkIds.insert(linkID);
+    });
+
+    std::map<uint32_t, std::vector<std::tuple<std::string, std::string, bool>>> linkExt; // link id -> attributes
+    selectIn(R"(
+        SELECT
+            id_link,
+            keytag,
+            value,
+            read_only
+        FROM
+            t_bios_asset_link_attributes
+        WHERE
+            id_link IN (%s)
+    )", linkIds, [&](const tntdb::Row& row) {
+        linkExt[row.getUnsigned32("id_link")].emplace_back(
+            row.getString("keytag"), row.getString("value"), row.getBool("read_only"));
+    });
+    // clang-format on
+
+    for (const auto& it : byId) {
+        std::vector<AssetLink> assetLinks;
+        for (auto& link : links[it.first]) {
+            link.second.clearExtMap();
+            for (const auto& ext : linkExt[link.first]) {
+                link.second.setExtEntry(std::get<0>(ext), std::get<1>(ext), std::get<2>(ext), true);
+            }
+            assetLinks.push_back(link.second);
+        }
+        for (size_t pos : it.second) {
+            assets[pos]->setLinkedAssets(assetLinks);
+        }
+    }
+
+    return found;
+}
+
 void DB::saveLinkedAssets(Asset& asset)
 {
+    Lease lease(m_pool);
+
     auto assetID = getID(asset.getInternalName());
 
     if (!assetID) {
@@ -619,7 +959,7 @@ void DB::saveLinkedAssets(Asset& asset)
     }
 
     // clang-format off
-    auto q = m_conn.prepareCached(R"(
+    auto q = prepare(R"(
         SELECT
             e.id_asset_element   AS srcId,
             e.name               AS srcName,
@@ -638,7 +978,6 @@ void DB::saveLinkedAssets(Asset& asset)
 
     tntdb::Result res;
     try {
-        Lock lock(m_conn_lock);
         res = q.select();
 
     } catch (std::exception& e) {
@@ -692,26 +1031,27 @@ void DB::saveLinkedAssets(Asset& asset)
 
 bool DB::hasLinkedAssets(const Asset& asset)
 {
+    Lease lease(m_pool);
+
     auto assetID = getID(asset.getInternalName());
     if(!assetID) {
         throw std::runtime_error(assetID.error());
     }
 
     // clang-format off
-    auto q = m_conn.prepare(R"(
+    CountedStatement q(m_pool.current().prepare(R"(
         SELECT
             COUNT(id_link)
         FROM
             t_bios_asset_link
         WHERE
             id_asset_device_src = :src
-    )");
+    )"));
     // clang-format on
     q.set("src", *assetID);
 
     int linkedAssets;
     try {
-        Lock lock(m_conn_lock);
         linkedAssets = q.selectValue().getInt();
 
     } catch (std::exception& e) {
@@ -724,6 +1064,8 @@ bool DB::hasLinkedAssets(const Asset& asset)
 
 void DB::saveLink(const uint32_t destId, const AssetLink& l)
 {
+    Lease lease(m_pool);
+
     auto srcId = getID(l.sourceId());
     if(!srcId) {
         throw std::runtime_error(srcId.error());
@@ -734,7 +1076,7 @@ void DB::saveLink(const uint32_t destId, const AssetLink& l)
     uint32_t linkId = 0;
 
     // clang-format off
-    auto q1 = m_conn.prepareCached(R"(
+    auto q1 = prepare(R"(
         INSERT INTO
             t_bios_asset_link
             (id_asset_device_src, src_out, id_asset_device_dest, dest_in, id_asset_link_type)
@@ -757,9 +1099,8 @@ void DB::saveLink(const uint32_t destId, const AssetLink& l)
     q1.set("linkType", l.linkType());
 
     try {
-        Lock lock(m_conn_lock);
         q1.execute();
-        linkId = static_cast<uint32_t>(m_conn.lastInsertId());
+        linkId = static_cast<uint32_t>(m_pool.current().lastInsertId());
 
     } catch (std::exception& e) {
 
@@ -773,13 +1114,15 @@ void DB::saveLink(const uint32_t destId, const AssetLink& l)
 
 void DB::removeLink(const uint32_t destId, const AssetLink& l)
 {
+    Lease lease(m_pool);
+
     assert(destId);
 
     uint32_t linkId = getLinkID(destId, l);
 
     if (linkId) {
         // clang-format off
-        auto q_ext_attrib = m_conn.prepareCached(R"(
+        auto q_ext_attrib = prepare(R"(
             DELETE FROM
                 t_bios_asset_link_attributes
             WHERE
@@ -790,7 +1133,6 @@ void DB::removeLink(const uint32_t destId, const AssetLink& l)
         q_ext_attrib.set("link_id", linkId);
 
         try {
-            Lock lock(m_conn_lock);
             q_ext_attrib.execute();
 
         } catch (std::exception& e) {
@@ -799,7 +1141,7 @@ void DB::removeLink(const uint32_t destId, const AssetLink& l)
         }
 
         // clang-format off
-        auto q_link = m_conn.prepareCached(R"(
+        auto q_link = prepare(R"(
             DELETE FROM
                 t_bios_asset_link
             WHERE
@@ -810,7 +1152,6 @@ void DB::removeLink(const uint32_t destId, const AssetLink& l)
         q_link.set("link_id", linkId);
 
         try {
-            Lock lock(m_conn_lock);
             q_link.execute();
 
         } catch (std::exception& e) {
@@ -822,6 +1163,8 @@ void DB::removeLink(const uint32_t destId, const AssetLink& l)
 
 void DB::unlinkAll(Asset& dest)
 {
+    Lease lease(m_pool);
+
     auto destID = getID(dest.getInternalName());
     if(!destID) {
         throw std::runtime_error(destID.error());
@@ -834,13 +1177,15 @@ void DB::unlinkAll(Asset& dest)
 
 bool DB::isLastDataCenter(Asset& asset)
 {
+    Lease lease(m_pool);
+
     auto assetID = getID(asset.getInternalName());
     if(!assetID) {
         throw std::runtime_error(assetID.error());
     }
 
     // clang-format off
-    auto q = m_conn.prepare(R"(
+    CountedStatement q(m_pool.current().prepare(R"(
         SELECT
             COUNT(id_asset_element)
         FROM
@@ -852,14 +1197,13 @@ bool DB::isLastDataCenter(Asset& asset)
                 WHERE  name = 'datacenter'
             )
             AND id_asset_element != :asset_id
-    )");
+    )"));
     // clang-format on
     q.set("asset_id", *assetID);
 
     int numDatacentersAfterDelete = -1;
 
     try {
-        Lock lock(m_conn_lock);
         numDatacentersAfterDelete = q.selectValue().getInt();
 
     } catch (std::exception& e) {
@@ -870,25 +1214,145 @@ bool DB::isLastDataCenter(Asset& asset)
     return numDatacentersAfterDelete == 0;
 }
 
-void DB::removeFromGroups(Asset& asset)
+void DB::unlinkAssets(const std::vector<std::string>& inames)
 {
-    auto assetID = getID(asset.getInternalName());
-    if(!assetID) {
-        throw std::runtime_error(assetID.error());
-    }
+    Lease lease(m_pool);
+
+    auto ids = getIDs(inames);
 
     // clang-format off
-    auto q = m_conn.prepareCached(R"(
+    executeIn(R"(
         DELETE FROM
-            t_bios_asset_group_relation
+            t_bios_asset_link_attributes
         WHERE
-            id_asset_element = :asset_id
-    )");
+            id_link IN (SELECT id_link FROM t_bios_asset_link WHERE id_asset_device_dest IN (%s))
+    )", ids);
+    executeIn(R"(
+        DELETE FROM
+            t_bios_asset_link
+        WHERE
+            id_asset_device_dest IN (%s)
+    )", ids);
     // clang-format on
-    q.set("asset_id", *assetID);
+}
+
+std::map<std::string, int> DB::countChildren(const std::vector<std::string>& inames)
+{
+    Lease lease(m_pool);
+
+    std::map<std::string, int> children;
+
+    // clang-format off
+    selectIn(R"(
+        SELECT
+            p.name                     AS name,
+            COUNT(c.id_asset_element)  AS children
+        FROM
+            t_bios_asset_element AS c
+        INNER JOIN
+            t_bios_asset_element AS p
+            ON p.id_asset_element = c.id_parent
+        WHERE
+            p.name IN (%s)
+        GROUP BY
+            p.name
+    )", inames, [&children](const tntdb::Row& row) {
+        children[row.getString("name")] = row.getInt("children");
+    });
+    // clang-format on
+
+    return children;
+}
+
+std::set<std::string> DB::getLinkSources(const std::vector<std::string>& inames)
+{
+    Lease lease(m_pool);
+
+    std::set<std::string> sources;
+
+    // clang-format off
+    selectIn(R"(
+        SELECT DISTINCT
+            e.name AS name
+        FROM
+            t_bios_asset_link AS l
+        INNER JOIN
+            t_bios_asset_element AS e
+            ON e.id_asset_element = l.id_asset_device_src
+        WHERE
+            e.name IN (%s)
+    )", inames, [&sources](const tntdb::Row& row) {
+        sources.insert(row.getString("name"));
+    });
+    // clang-format on
+
+    return sources;
+}
+
+int DB::countDataCenters()
+{
+    Lease lease(m_pool);
+
+    // clang-format off
+    auto q = prepare(R"(
+        SELECT
+            COUNT(id_asset_element)
+        FROM
+            t_bios_asset_element
+        WHERE
+            id_type = (
+                SELECT id_asset_element_type
+                FROM   t_bios_asset_element_type
+                WHERE  name = 'datacenter'
+            )
+    )");
+    // clang-format on
+
+    try {
+        return q.selectValue().getInt();
+
+    } catch (std::exception& e) {
+
+        throw std::runtime_error("database error - " + std::string(e.what()));
+    }
+}
+
+void DB::removeAssets(const std::vector<std::string>& inames)
+{
+    Lease lease(m_pool);
+
+    auto ids = getIDs(inames);
+
+    executeIn("DELETE FROM t_bios_asset_group_relation WHERE id_asset_element IN (%s)", ids);
+    executeIn("DELETE FROM t_bios_asset_group_relation WHERE id_asset_group IN (%s)", ids);
+    executeIn("DELETE FROM t_bios_monitor_asset_relation WHERE id_asset_element IN (%s)", ids);
+    executeIn("DELETE FROM t_bios_asset_ext_attributes WHERE id_asset_element IN (%s)", ids);
+
+    // parents and children are removed together, detach them first so that no batch depends on another
+    executeIn("UPDATE t_bios_asset_element SET id_parent = NULL WHERE id_asset_element IN (%s)", ids);
+    executeIn("DELETE FROM t_bios_asset_element WHERE id_asset_element IN (%s)", ids);
+}
+
+void DB::removeFromGroups(Asset& asset)
+{
+    Lease lease(m_pool);
+
+    auto assetID = getID(asset.getInternalName());
+    if(!assetID) {
+        throw std::runtime_error(assetID.error());
+    }
+
+    // clang-format off
+    auto q = prepare(R"(
+        DELETE FROM
+            t_bios_asset_group_relation
+        WHERE
+            id_asset_element = :asset_id
+    )");
+    // clang-format on
+    q.set("asset_id", *assetID);
 
     try {
-        Lock lock(m_conn_lock);
         q.execute();
 
     } catch (std::exception& e) {
@@ -899,13 +1363,15 @@ void DB::removeFromGroups(Asset& asset)
 
 void DB::removeFromRelations(Asset& asset)
 {
+    Lease lease(m_pool);
+
     auto assetID = getID(asset.getInternalName());
     if(!assetID) {
         throw std::runtime_error(assetID.error());
     }
 
     // clang-format off
-    auto q = m_conn.prepareCached(R"(
+    auto q = prepare(R"(
         DELETE FROM
             t_bios_monitor_asset_relation
         WHERE
@@ -915,7 +1381,6 @@ void DB::removeFromRelations(Asset& asset)
     q.set("asset_id", *assetID);
 
     try {
-        Lock lock(m_conn_lock);
         q.execute();
 
     } catch (std::exception& e) {
@@ -926,13 +1391,15 @@ void DB::removeFromRelations(Asset& asset)
 
 void DB::removeAsset(Asset& asset)
 {
+    Lease lease(m_pool);
+
     auto assetID = getID(asset.getInternalName());
     if(!assetID) {
         throw std::runtime_error(assetID.error());
     }
 
     // clang-format off
-    auto q = m_conn.prepareCached(R"(
+    auto q = prepare(R"(
         DELETE FROM
             t_bios_asset_element
         WHERE
@@ -942,7 +1409,6 @@ void DB::removeAsset(Asset& asset)
     q.set("asset_id", *assetID);
 
     try {
-        Lock lock(m_conn_lock);
         q.execute();
 
     } catch (std::exception& e) {
@@ -953,13 +1419,15 @@ void DB::removeAsset(Asset& asset)
 
 void DB::removeExtMap(Asset& asset)
 {
+    Lease lease(m_pool);
+
     auto assetID = getID(asset.getInternalName());
     if(!assetID) {
         throw std::runtime_error(assetID.error());
     }
 
     // clang-format off
-    auto q = m_conn.prepareCached(R"(
+    auto q = prepare(R"(
         DELETE FROM
             t_bios_asset_ext_attributes
         WHERE
@@ -969,7 +1437,6 @@ void DB::removeExtMap(Asset& asset)
     q.set("assetId", *assetID);
 
     try {
-        Lock lock(m_conn_lock);
         q.execute();
 
     } catch (std::exception& e) {
@@ -980,13 +1447,15 @@ void DB::removeExtMap(Asset& asset)
 
 void DB::clearGroup(Asset& asset)
 {
+    Lease lease(m_pool);
+
     auto assetID = getID(asset.getInternalName());
     if(!assetID) {
         throw std::runtime_error(assetID.error());
     }
 
     // clang-format off
-    auto q = m_conn.prepareCached(R"(
+    auto q = prepare(R"(
         DELETE FROM
             t_bios_asset_group_relation
         WHERE
@@ -996,7 +1465,6 @@ void DB::clearGroup(Asset& asset)
     q.set("grp", *assetID);
 
     try {
-        Lock lock(m_conn_lock);
         q.execute();
 
     } catch (std::exception& e) {
@@ -1007,27 +1475,37 @@ void DB::clearGroup(Asset& asset)
 
 void DB::beginTransaction()
 {
-    Lock lock(m_conn_lock);
-    m_conn.beginTransaction();
-
+    // the connection is kept until the end of the transaction
+    m_pool.borrow();
+    try {
+        m_pool.current().beginTransaction();
+    } catch (...) {
+        m_pool.giveBack();
+        throw;
+    }
 }
 
 void DB::rollbackTransaction()
 {
-    Lock lock(m_conn_lock);
-    m_conn.rollbackTransaction();
+    // lease of the call takes over the one of the transaction
+    Lease lease(m_pool);
 
+    m_pool.giveBack();
+    m_pool.current().rollbackTransaction();
 }
 
 void DB::commitTransaction()
 {
-    Lock lock(m_conn_lock);
-    m_conn.commitTransaction();
+    Lease lease(m_pool);
 
+    m_pool.giveBack();
+    m_pool.current().commitTransaction();
 }
 
 void DB::update(Asset& asset)
 {
+    Lease lease(m_pool);
+
     if (asset.getInternalName().empty()) {
         log_error("Asset iname is empty");
         throw std::runtime_error("Asset iname is empty");
@@ -1072,7 +1550,7 @@ void DB::update(Asset& asset)
     }
 
     // clang-format off
-    auto q = m_conn.prepareCached(R"(
+    auto q = prepare(R"(
         UPDATE
             t_bios_asset_element
         SET
@@ -1109,7 +1587,6 @@ void DB::update(Asset& asset)
     else q.set("idSecondary", asset.getSecondaryID());
 
     try {
-        Lock lock(m_conn_lock);
         q.execute();
     }
     catch (std::exception& e) {
@@ -1119,6 +1596,8 @@ void DB::update(Asset& asset)
 
 void DB::insert(Asset& asset)
 {
+    Lease lease(m_pool);
+
     if (asset.getInternalName().empty()) {
         log_error("Asset iname is empty");
         throw std::runtime_error("Asset iname is empty");
@@ -1141,14 +1620,14 @@ void DB::insert(Asset& asset)
     }
 
     // clang-format off
-    auto q = m_conn.prepareCached(R"(
+    auto q = prepare(R"(
         INSERT INTO
             t_bios_asset_element
             (name, id_type, id_subtype, id_parent, status, priority, asset_tag, id_secondary)
         VALUES (
             :name,
-            (SELECT id_asset_element_type FROM t_bios_asset_element_type WHERE name = :type),
-            (SELECT id_asset_device_type FROM t_bios_asset_device_type WHERE name = :subtype),
+            :type_id,
+            :subtype_id,
             :parent_id,
             :status,
             :priority,
@@ -1159,8 +1638,14 @@ void DB::insert(Asset& asset)
     // clang-format on
 
     q.set("name", asset.getInternalName());
-    q.set("type", asset.getAssetType());
-    q.set("subtype", asset.getAssetSubtype());
+
+    // unknown type or subtype is refused by the database
+    uint32_t typeId    = getTypeID(asset.getAssetType());
+    uint32_t subtypeId = getSubtypeID(asset.getAssetSubtype());
+    if (typeId == 0) q.setNull("type_id");
+    else q.set("type_id", typeId);
+    if (subtypeId == 0) q.setNull("subtype_id");
+    else q.set("subtype_id", subtypeId);
 
     // name field can't be null, parent id is set to NULL if parentIname is empty
     if (parentId == 0) {
@@ -1184,7 +1669,6 @@ void DB::insert(Asset& asset)
     else q.set("idSecondary", asset.getSecondaryID());
 
     try {
-        Lock lock(m_conn_lock);
         q.execute();
     }
     catch (std::exception& e) {
@@ -1192,19 +1676,370 @@ void DB::insert(Asset& asset)
     }
 }
 
+// rows of one multi-row INSERT
+static constexpr size_t INSERT_BATCH_SIZE = 100;
+
+// rows cannot be padded: the statement of full batches is cached, the one of the last batch is not,
+// so that a statement is not kept for each number of rows
+static bool fullInsertBatch(size_t begin, size_t end)
+{
+    return end - begin == INSERT_BATCH_SIZE;
+}
+
+std::vector<bool> DB::verifyIDs(const std::vector<std::string>& ids)
+{
+    Lease lease(m_pool);
+
+    std::vector<bool> valid(ids.size(), true);
+
+    // same match as verifyID, one scan for a batch of ids
+    for (size_t begin = 0; begin < ids.size(); begin += IN_BATCH_SIZE) {
+        size_t      end   = std::min(begin + IN_BATCH_SIZE, ids.size());
+        size_t      arity = listArity(end - begin);
+        std::string sql   = "SELECT name FROM t_bios_asset_element WHERE ";
+        for (size_t i = 0; i < arity; i++) {
+            sql.append(i ? " OR " : "").append("name LIKE :v" + std::to_string(i));
+        }
+
+        auto q = prepare(sql);
+        for (size_t i = 0; i < arity; i++) {
+            q.set("v" + std::to_string(i), "%" + ids[std::min(begin + i, end - 1)]);
+        }
+
+        tntdb::Result res;
+        try {
+            res = q.select();
+
+        } catch (std::exception& e) {
+
+            throw std::runtime_error("database error - " + std::string(e.what()));
+        }
+
+        for (const auto& row : res) {
+            std::string name = row.getString("name");
+            for (size_t i = begin; i < end; i++) {
+                const std::string& id = ids[i];
+                if (name.size() >= id.size() && name.compare(name.size() - id.size(), id.size(), id) == 0) {
+                    valid[i] = false;
+                }
+            }
+        }
+    }
+
+    return valid;
+}
+
+void DB::insertAssets(const std::vector<Asset*>& assets, bool saveLinks)
+{
+    Lease lease(m_pool);
+
+    std::set<std::string> names;
+    for (const auto& asset : assets) {
+        if (asset->getInternalName().empty()) {
+            log_error("Asset iname is empty");
+            throw std::runtime_error("Asset iname is empty");
+        }
+        if (asset->getInternalName() == asset->getParentIname()) {
+            log_error("Asset iname is same as parent iname (iname: %s)", asset->getInternalName().c_str());
+            throw std::runtime_error("Asset iname is same as parent iname");
+        }
+        names.insert(asset->getInternalName());
+    }
+
+    // ids of the parents already in database, then of the inserted assets
+    std::map<std::string, uint32_t> ids;
+    auto addIds = [&ids](const tntdb::Row& row) {
+        ids[row.getString("name")] = row.getUnsigned32("id");
+    };
+    const std::string idsQuery = "SELECT id_asset_element AS id, name FROM t_bios_asset_element WHERE name IN (%s)";
+
+    std::set<std::string> parents;
+    for (const auto& asset : assets) {
+        if (!asset->getParentIname().empty() && names.count(asset->getParentIname()) == 0) {
+            parents.insert(asset->getParentIname());
+        }
+    }
+    selectIn(idsQuery, parents, addIds);
+    for (const auto& parent : parents) {
+        if (ids.count(parent) == 0) {
+            log_error("Error getting id of %s", parent.c_str());
+            throw std::runtime_error("Internal name " + parent + " not found");
+        }
+    }
+
+    // parents in the batch are inserted before their children
+    std::vector<Asset*> pending(assets);
+    while (!pending.empty()) {
+        std::vector<Asset*> level;
+        std::vector<Asset*> next;
+        for (const auto& asset : pending) {
+            const std::string& parent = asset->getParentIname();
+            if (parent.empty() || ids.count(parent)) {
+                level.push_back(asset);
+            } else {
+                next.push_back(asset);
+            }
+        }
+        if (level.empty()) {
+            throw std::runtime_error("Loop in parents of " + next.front()->getInternalName());
+        }
+
+        for (size_t begin = 0; begin < level.size(); begin += INSERT_BATCH_SIZE) {
+            size_t end = std::min(begin + INSERT_BATCH_SIZE, level.size());
+
+            std::string sql = R"(
+                INSERT INTO
+                    t_bios_asset_element
+                    (name, id_type, id_subtype, id_parent, status, priority, asset_tag, id_secondary)
+                VALUES )";
+            for (size_t i = 0; i < end - begin; i++) {
+                std::string n = std::to_string(i);
+                sql.append(i ? ", (" : "(");
+                sql.append(":name" + n + ", ");
+                sql.append(":type_id" + n + ", :subtype_id" + n + ", ");
+                sql.append(":parent_id" + n + ", :status" + n + ", :priority" + n + ", ");
+                sql.append(":assetTag" + n + ", :idSecondary" + n + ")");
+            }
+
+            auto q = fullInsertBatch(begin, end) ? prepare(sql) : prepareOnce(sql);
+            for (size_t i = begin; i < end; i++) {
+                const Asset&      asset = *level[i];
+                const std::string n     = std::to_string(i - begin);
+
+                q.set("name" + n, asset.getInternalName());
+
+                uint32_t typeId    = getTypeID(asset.getAssetType());
+                uint32_t subtypeId = getSubtypeID(asset.getAssetSubtype());
+                if (typeId == 0) q.setNull("type_id" + n);
+                else q.set("type_id" + n, typeId);
+                if (subtypeId == 0) q.setNull("subtype_id" + n);
+                else q.set("subtype_id" + n, subtypeId);
+
+                if (asset.getParentIname().empty()) q.setNull("parent_id" + n);
+                else q.set("parent_id" + n, ids[asset.getParentIname()]);
+
+                // always insert as non active, update after activation
+                q.set("status" + n, assetStatusToString(fty::AssetStatus::Nonactive));
+                q.set("priority" + n, asset.getPriority());
+
+                if (asset.getAssetTag().empty()) q.setNull("assetTag" + n);
+                else q.set("assetTag" + n, asset.getAssetTag());
+
+                if (asset.getSecondaryID().empty()) q.setNull("idSecondary" + n);
+                else q.set("idSecondary" + n, asset.getSecondaryID());
+            }
+
+            try {
+                q.execute();
+            }
+            catch (std::exception& e) {
+                throw std::runtime_error("database error - " + std::string(e.what()));
+            }
+        }
+
+        std::vector<std::string> inserted;
+        for (const auto& asset : level) {
+            inserted.push_back(asset->getInternalName());
+        }
+        selectIn(idsQuery, inserted, addIds);
+
+        pending.swap(next);
+    }
+
+    // ext attributes, same rule as saveExtMap on a new asset: updated and not empty
+    using ExtRow = std::tuple<uint32_t, std::string, const ExtMapElement*>;
+    std::vector<ExtRow> extRows;
+    for (const auto& asset : assets) {
+        for (const auto& it : asset->getExt()) {
+            if (it.second.wasUpdated() && !it.second.getValue().empty()) {
+                extRows.emplace_back(ids[asset->getInternalName()], it.first, &it.second);
+            }
+        }
+    }
+
+    for (size_t begin = 0; begin < extRows.size(); begin += INSERT_BATCH_SIZE) {
+        size_t end = std::min(begin + INSERT_BATCH_SIZE, extRows.size());
+
+        std::string sql =
+            "INSERT INTO t_bios_asset_ext_attributes (keytag, value, id_asset_element, read_only) VALUES ";
+        for (size_t i = 0; i < end - begin; i++) {
+            std::string n = std::to_string(i);
+            sql.append(i ? ", " : "").append("(:key" + n + ", :value" + n + ", :assetId" + n + ", :readOnly" + n + ")");
+        }
+
+        auto q = fullInsertBatch(begin, end) ? prepare(sql) : prepareOnce(sql);
+        for (size_t i = begin; i < end; i++) {
+            const std::string n = std::to_string(i - begin);
+            q.set("key" + n, std::get<1>(extRows[i]));
+            q.set("value" + n, std::get<2>(extRows[i])->getValue());
+            q.set("assetId" + n, std::get<0>(extRows[i]));
+            q.set("readOnly" + n, std::get<2>(extRows[i])->isReadOnly());
+        }
+
+        try {
+            q.execute();
+
+        } catch (std::exception& e) {
+
+            throw std::runtime_error("database error - " + std::string(e.what()));
+        }
+    }
+
+    if (saveLinks) {
+        insertLinks(assets);
+    }
+}
+
+void DB::insertLinks(const std::vector<Asset*>& assets)
+{
+    Lease lease(m_pool);
+
+    std::set<std::string> names;
+    for (const auto& asset : assets) {
+        if (!asset->getLinkedAssets().empty()) {
+            names.insert(asset->getInternalName());
+            for (const auto& l : asset->getLinkedAssets()) {
+                names.insert(l.sourceId());
+            }
+        }
+    }
+    if (names.empty()) {
+        return;
+    }
+
+    std::map<std::string, uint32_t> ids;
+    selectIn("SELECT id_asset_element AS id, name FROM t_bios_asset_element WHERE name IN (%s)", names,
+        [&ids](const tntdb::Row& row) {
+            ids[row.getString("name")] = row.getUnsigned32("id");
+        });
+    for (const auto& name : names) {
+        if (ids.count(name) == 0) {
+            log_error("Error getting id of %s", name.c_str());
+            throw std::runtime_error("Internal name " + name + " not found");
+        }
+    }
+
+    // links with attributes need their id, they are saved one by one
+    using LinkRow = std::pair<uint32_t, const AssetLink*>;
+    std::vector<LinkRow> linkRows;
+    for (const auto& asset : assets) {
+        for (const auto& l : asset->getLinkedAssets()) {
+            if (l.ext().empty()) {
+                linkRows.emplace_back(ids[asset->getInternalName()], &l);
+            } else {
+                saveLink(ids[asset->getInternalName()], l);
+            }
+        }
+    }
+
+    for (size_t begin = 0; begin < linkRows.size(); begin += INSERT_BATCH_SIZE) {
+        size_t end = std::min(begin + INSERT_BATCH_SIZE, linkRows.size());
+
+        std::string sql = R"(
+            INSERT INTO
+                t_bios_asset_link
+                (id_asset_device_src, src_out, id_asset_device_dest, dest_in, id_asset_link_type)
+            VALUES )";
+        for (size_t i = 0; i < end - begin; i++) {
+            std::string n = std::to_string(i);
+            sql.append(i ? ", " : "")
+                .append("(:src" + n + ", :srcOut" + n + ", :dest" + n + ", :destIn" + n + ", :linkType" + n + ")");
+        }
+
+        auto q = fullInsertBatch(begin, end) ? prepare(sql) : prepareOnce(sql);
+        for (size_t i = begin; i < end; i++) {
+            const AssetLink&  l = *linkRows[i].second;
+            const std::string n = std::to_string(i - begin);
+
+            q.set("src" + n, ids[l.sourceId()]);
+            q.set("dest" + n, linkRows[i].first);
+
+            l.srcOut().empty() ? q.setNull("srcOut" + n) : q.set("srcOut" + n, l.srcOut());
+            l.destIn().empty() ? q.setNull("destIn" + n) : q.set("destIn" + n, l.destIn());
+
+            q.set("linkType" + n, l.linkType());
+        }
+
+        try {
+            q.execute();
+
+        } catch (std::exception& e) {
+
+            throw std::runtime_error("database error - " + std::string(e.what()));
+        }
+    }
+}
+
+void DB::updateStatus(const std::vector<std::string>& inames, AssetStatus status)
+{
+    Lease lease(m_pool);
+
+    for (size_t begin = 0; begin < inames.size(); begin += IN_BATCH_SIZE) {
+        size_t end   = std::min(begin + IN_BATCH_SIZE, inames.size());
+        size_t arity = listArity(end - begin);
+
+        auto q = prepare(
+            "UPDATE t_bios_asset_element SET status = :status WHERE name IN (" + inPlaceholders(arity) + ")");
+        q.set("status", assetStatusToString(status));
+        for (size_t i = 0; i < arity; i++) {
+            q.set("v" + std::to_string(i), inames[std::min(begin + i, end - 1)]);
+        }
+
+        try {
+            q.execute();
+
+        } catch (std::exception& e) {
+
+            throw std::runtime_error("database error - " + std::string(e.what()));
+        }
+    }
+}
+
+std::map<std::string, int> DB::getDepths(const std::vector<std::string>& inames)
+{
+    Lease lease(m_pool);
+
+    std::map<std::string, int> depths;
+
+    // clang-format off
+    selectIn(R"(
+        SELECT
+            e.name AS name,
+            v.id_parent1, v.id_parent2, v.id_parent3, v.id_parent4, v.id_parent5,
+            v.id_parent6, v.id_parent7, v.id_parent8, v.id_parent9, v.id_parent10
+        FROM
+            v_bios_asset_element_super_parent AS v
+        INNER JOIN
+            t_bios_asset_element AS e
+            ON e.id_asset_element = v.id_asset_element
+        WHERE
+            e.name IN (%s)
+    )", inames, [&depths](const tntdb::Row& row) {
+        int depth = 0;
+        while (depth < 10 && !row.isNull("id_parent" + std::to_string(depth + 1))) {
+            depth++;
+        }
+        depths[row.getString("name")] = depth;
+    });
+    // clang-format on
+
+    return depths;
+}
+
 std::string DB::inameById(uint32_t id)
 {
+    Lease lease(m_pool);
+
     std::string res;
 
     // clang-format off
-    auto q = m_conn.prepareCached(R"(
+    auto q = prepare(R"(
         SELECT name FROM t_bios_asset_element WHERE id_asset_element = :assetId
     )");
     // clang-format on
     q.set("assetId", id);
 
     try {
-        Lock lock(m_conn_lock);
         res = q.selectRow().getString("name");
 
     } catch (std::exception& e) {
@@ -1217,9 +2052,11 @@ std::string DB::inameById(uint32_t id)
 
 std::string DB::inameByUuid(const std::string& uuid)
 {
+    Lease lease(m_pool);
+
     std::string res;
     // clang-format off
-    auto q = m_conn.prepareCached(R"(
+    auto q = prepare(R"(
         SELECT
             name
         FROM
@@ -1238,7 +2075,6 @@ std::string DB::inameByUuid(const std::string& uuid)
     // clang-format on
 
     try {
-        Lock lock(m_conn_lock);
         res = q.selectRow().getString("name");
 
     } catch (std::exception& e) {
@@ -1249,8 +2085,35 @@ std::string DB::inameByUuid(const std::string& uuid)
     return res;
 }
 
+std::map<std::string, std::string> DB::inamesByUuids(const std::vector<std::string>& uuids)
+{
+    Lease lease(m_pool);
+
+    std::map<std::string, std::string> inames;
+
+    // clang-format off
+    selectIn(R"(
+        SELECT
+            e.name  AS name,
+            a.value AS uuid
+        FROM
+            t_bios_asset_ext_attributes AS a
+        INNER JOIN
+            t_bios_asset_element AS e ON e.id_asset_element = a.id_asset_element
+        WHERE
+            a.keytag = "uuid" AND a.value IN (%s)
+    )", uuids, [&](const tntdb::Row& row) {
+        inames[row.getString("uuid")] = row.getString("name");
+    });
+    // clang-format on
+
+    return inames;
+}
+
 void DB::saveExtMap(Asset& asset)
 {
+    Lease lease(m_pool);
+
     /*
      * Here is the strategy to save the external attributes:
      * 1. We insert, update or remove only the external attribute which has been modified.
@@ -1263,7 +2126,7 @@ void DB::saveExtMap(Asset& asset)
     }
 
     // clang-format off
-    auto q = m_conn.prepareCached(R"(
+    auto q = prepare(R"(
         SELECT
             id_asset_ext_attribute AS id,
             keytag                 AS akey,
@@ -1279,7 +2142,6 @@ void DB::saveExtMap(Asset& asset)
     tntdb::Result res;
 
     try {
-        Lock lock(m_conn_lock);
         res = q.select();
 
     } catch (std::exception& e) {
@@ -1316,7 +2178,7 @@ void DB::saveExtMap(Asset& asset)
 
             if (!it.second.getValue().empty()) {
                 // clang-format off
-                auto q1 = m_conn.prepareCached(R"(
+                auto q1 = prepare(R"(
                     INSERT INTO t_bios_asset_ext_attributes (keytag, value, id_asset_element, read_only)
                     VALUES (:key, :value, :assetId, :readOnly)
                 )");
@@ -1326,7 +2188,6 @@ void DB::saveExtMap(Asset& asset)
                 q1.set("readOnly", it.second.isReadOnly());
                 q1.set("assetId", *assetID);
                 try {
-                    Lock lock(m_conn_lock);
                     q1.execute();
 
                 } catch (std::exception& e) {
@@ -1341,7 +2202,7 @@ void DB::saveExtMap(Asset& asset)
 
             if (!it.second.getValue().empty()) {
                 // clang-format off
-                auto q1 = m_conn.prepareCached(R"(
+                auto q1 = prepare(R"(
                     UPDATE t_bios_asset_ext_attributes
                     SET
                         value = :value,
@@ -1354,7 +2215,6 @@ void DB::saveExtMap(Asset& asset)
                 q1.set("extId", std::get<0>(*found));
 
                 try {
-                    Lock lock(m_conn_lock);
                     q1.execute();
 
                 } catch (std::exception& e) {
@@ -1369,7 +2229,7 @@ void DB::saveExtMap(Asset& asset)
 
     for (const auto& toRem : toBeRemoved) {
         // clang-format off
-        auto q1 = m_conn.prepareCached(R"(
+        auto q1 = prepare(R"(
             DELETE FROM t_bios_asset_ext_attributes
             WHERE id_asset_ext_attribute = :extId
         )");
@@ -1377,7 +2237,6 @@ void DB::saveExtMap(Asset& asset)
         q1.set("extId", std::get<0>(toRem));
 
         try {
-            Lock lock(m_conn_lock);
             q1.execute();
 
         } catch (std::exception& e) {
@@ -1387,58 +2246,88 @@ void DB::saveExtMap(Asset& asset)
     }
 }
 
-static void addFilter(
-    std::stringstream& qs, const std::string& filter, const std::vector<std::string>& values)
+// columns assets can be filtered on, true for the integer ones
+static const std::map<std::string, bool> FILTER_COLUMNS = {
+    {"id_parent", true}, {"id_subtype", true}, {"id_type", true}, {"priority", true}, {"status", false}};
+
+// value bound to a placeholder of the filters
+struct FilterValue
+{
+    std::string placeholder;
+    std::string value;
+    bool        numeric;
+};
+
+// "column IN (...)" conditions of filters joined with AND, values to bind are added to values;
+// lists are padded with their last value, which does not change the result
+static std::string compileFilters(
+    const std::map<std::string, std::vector<std::string>>& filters, std::vector<FilterValue>& values)
 {
-    auto value = values.begin();
-    qs << " ( ";
-    qs << filter << " = " << *value << " ";
+    std::string sql;
+    for (const auto& it : filters) {
+        auto column = FILTER_COLUMNS.find(it.first);
+        if (column == FILTER_COLUMNS.end()) {
+            throw std::runtime_error("Invalid asset filter " + it.first);
+        }
+        if (!sql.empty()) {
+            sql.append(" AND ");
+        }
+        if (it.second.empty()) {
+            sql.append("FALSE");
+            continue;
+        }
 
-    for (auto it = std::next(values.begin()); it != values.end(); it++) {
-        qs << " OR ";
-        qs << filter << " = " << *it << " ";
+        sql.append(it.first + " IN (");
+        size_t arity = listArity(it.second.size());
+        for (size_t i = 0; i < arity; i++) {
+            const std::string& value = it.second[std::min(i, it.second.size() - 1)];
+            if (column->second &&
+                (value.empty() || value.size() > 9 || value.find_first_not_of("0123456789") != std::string::npos)) {
+                throw std::runtime_error("Invalid value '" + value + "' of asset filter " + it.first);
+            }
+
+            std::string placeholder = it.first + std::to_string(i);
+            sql.append(i ? ", :" : ":").append(placeholder);
+            values.push_back({placeholder, value, column->second});
+        }
+        sql.append(")");
+    }
+    return sql;
+}
+
+static void bindFilters(CountedStatement& q, const std::vector<FilterValue>& values)
+{
+    for (const auto& value : values) {
+        if (value.numeric) {
+            q.set(value.placeholder, static_cast<uint32_t>(std::stoul(value.value)));
+        } else {
+            q.set(value.placeholder, value.value);
+        }
     }
-    qs << " ) ";
 }
 
 std::vector<std::string> DB::listAssets(std::map<std::string, std::vector<std::string>> filters)
 {
-    std::vector<std::string> assetList;
+    Lease lease(m_pool);
 
-    tntdb::Statement q;
+    std::vector<std::string> assetList;
 
-    std::stringstream qs;
+    std::vector<FilterValue> values;
 
-    qs << " SELECT "
-          " name AS name "
-          " FROM t_bios_asset_element ";
+    std::string sql = " SELECT "
+                      " name AS name "
+                      " FROM t_bios_asset_element ";
 
     if (!filters.empty()) {
-        qs << " WHERE ";
-
-        // first filter
-        auto it     = filters.begin();
-        auto filter = it->first;
-        auto values = it->second;
-
-        addFilter(qs, filter, values);
-
-        // next filters
-        for (it = std::next(filters.begin()); it != filters.end(); it++) {
-            qs << " AND ";
-            filter = it->first;
-            values = it->second;
-
-            addFilter(qs, filter, values);
-        }
+        sql.append(" WHERE " + compileFilters(filters, values));
     }
 
-    q = m_conn.prepareCached(qs.str().c_str());
+    auto q = prepare(sql);
+    bindFilters(q, values);
 
     tntdb::Result res;
 
     try {
-        Lock lock(m_conn_lock);
         res = q.select();
 
     } catch (std::exception& e) {
@@ -1457,12 +2346,59 @@ std::vector<std::string> DB::listAssets(std::map<std::string, std::vector<std::s
     return assetList;
 }
 
+std::vector<std::pair<uint32_t, std::string>> DB::listAssetsPage(
+    std::map<std::string, std::vector<std::string>> filters, uint32_t afterId, size_t limit)
+{
+    Lease lease(m_pool);
+
+    std::vector<std::pair<uint32_t, std::string>> assetList;
+
+    std::vector<FilterValue> values;
+
+    // keyset pagination, the primary key index is used whatever the page;
+    // rackcontroller 0 is discarded by the query, so that pages are not short of it
+    std::string sql = " SELECT "
+                      " id_asset_element AS id, "
+                      " name AS name "
+                      " FROM t_bios_asset_element "
+                      " WHERE id_asset_element > :after_id "
+                      " AND name <> :rc0 ";
+
+    if (!filters.empty()) {
+        sql.append(" AND " + compileFilters(filters, values));
+    }
+    sql.append(" ORDER BY id_asset_element "
+               " LIMIT :limit ");
+
+    auto q = prepare(sql);
+    q.set("after_id", afterId).set("rc0", RC0).set("limit", static_cast<uint32_t>(limit));
+    bindFilters(q, values);
+
+    tntdb::Result res;
+
+    try {
+        res = q.select();
+
+    } catch (std::exception& e) {
+
+        throw std::runtime_error("database error - " + std::string(e.what()));
+    }
+
+    for (const auto& row : res) {
+        assetList.emplace_back(row.getUnsigned32("id"), row.getString("name"));
+    }
+
+    return assetList;
+}
+
 std::vector<std::string> DB::listAllAssets()
 {
+    Lease lease(m_pool);
+
     std::vector<std::string> assetList;
 
     // clang-format off
-    auto q = m_conn.prepareCached(R"(
+    auto q = prepare(R"(
         SELECT
             name          AS name
         FROM t_bios_asset_element
@@ -1472,7 +2408,6 @@ std::vector<std::string> DB::listAllAssets()
     tntdb::Result res;
 
     try {
-        Lock lock(m_conn_lock);
         res = q.select();
 
     } catch (std::exception& e) {
@@ -21,6 +21,9 @@
 
 #pragma once
 #include "asset-storage.h"
+#include "connection-pool.h"
+#include "counted-statement.h"
+#include <chrono>
 #include <map>
 #include <memory>
 #include <mutex>
@@ -35,16 +38,25 @@ class DB : public AssetStorage
 public:
     static DB& getInstance();
 
+    // number of database connections used at once
+    void setPoolSize(size_t size);
+
+    // reads again the asset types and subtypes, which are otherwise read once
+    void refreshTypes();
+
     void loadAsset(const std::string& nameId, Asset& asset);
 
     void                     loadExtMap(Asset& asset);
     void                     loadLinkedAssets(Asset& asset);
     std::vector<std::string> getChildren(const Asset& asset);
+    std::map<std::string, int> getDepths(const std::vector<std::string>& inames);
+    std::vector<bool>        loadAssets(const std::vector<Asset*>& assets);
 
     fty::Expected<uint32_t> getID(const std::string& internalName);
     uint32_t getTypeID(const std::string& type);
     uint32_t getSubtypeID(const std::string& subtype);
     bool verifyID(std::string& id);
+    std::vector<bool> verifyIDs(const std::vector<std::string>& ids);
 
     uint32_t getLinkID(const uint32_t destId, const AssetLink& l);
     void saveLink(const uint32_t destId, const AssetLink& l);
@@ -61,25 +73,69 @@ public:
     void removeExtMap(Asset& asset);
     bool isLastDataCenter(Asset& asset);
 
+    void                       unlinkAssets(const std::vector<std::string>& inames);
+    std::map<std::string, int> countChildren(const std::vector<std::string>& inames);
+    std::set<std::string>      getLinkSources(const std::vector<std::string>& inames);
+    int                        countDataCenters();
+    void                       removeAssets(const std::vector<std::string>& inames);
+
     void beginTransaction();
     void rollbackTransaction();
     void commitTransaction();
 
     void update(Asset& asset);
     void insert(Asset& asset);
+    void insertAssets(const std::vector<Asset*>& assets, bool saveLinks = true);
+    void insertLinks(const std::vector<Asset*>& assets);
+    void updateStatus(const std::vector<std::string>& inames, AssetStatus status);
 
     void        saveLinkedAssets(Asset& asset);
     void        saveExtMap(Asset& asset);
     std::string inameById(uint32_t id);
     std::string inameByUuid(const std::string& uuid);
+    std::map<std::string, std::string> inamesByUuids(const std::vector<std::string>& uuids);
 
     std::vector<std::string> listAssets(std::map<std::string, std::vector<std::string>> filters);
     std::vector<std::string> listAllAssets();
+    std::vector<std::pair<uint32_t, std::string>> listAssetsPage(
+        std::map<std::string, std::vector<std::string>> filters, uint32_t afterId, size_t limit);
 
 private:
     DB();
-    std::mutex                m_conn_lock;
-    mutable tntdb::Connection m_conn;
+    // statement on the connection borrowed by the thread, each execution is counted as a DB round trip
+    // of the request being handled
+    CountedStatement prepare(const std::string& query);
+    // same, not cached, for a statement whose text is seldom executed again
+    CountedStatement prepareOnce(const std::string& query);
+    // runs query, with one "%s" IN clause, on batches of values and calls cb on each row
+    template <typename Values, typename Callback>
+    void selectIn(const std::string& query, const Values& values, const Callback& cb);
+    // same for a statement without result
+    template <typename Values>
+    void executeIn(const std::string& query, const Values& values);
+    // ids of the known assets of inames
+    std::vector<uint32_t> getIDs(const std::vector<std::string>& inames);
+
+    // ids of the asset types and subtypes by lower case name, sorted by name
+    struct Types
+    {
+        std::vector<std::pair<std::string, uint32_t>> types;
+        std::vector<std::pair<std::string, uint32_t>> subtypes;
+        std::chrono::steady_clock::time_point         loaded;
+    };
+    // current dictionaries, read on first use
+    std::shared_ptr<const Types> types();
+    // dictionaries read again for an unknown name, unless they were read recently
+    std::shared_ptr<const Types> typesAfterMiss();
+
+    using Lease = ConnectionPool<tntdb::Connection>::Lease;
+
+    // every operation borrows a connection, a transaction keeps it until its end
+    ConnectionPool<tntdb::Connection> m_pool;
+
+    // replaced as a whole on refresh, so that readers keep a consistent copy
+    std::shared_ptr<const Types> m_types;
+    std::mutex                   m_typesLock;
 };
 
 } // namespace fty
@@ -21,14 +21,18 @@
 
 #pragma once
 #include <fty/expected.h>
+#include <cstdint>
 #include <map>
+#include <set>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace fty {
 
 class Asset;
 class AssetLink;
+enum class AssetStatus;
 
 class AssetStorage
 {
@@ -36,7 +40,9 @@ public:
     enum class StorageType
     {
         StorageDB,
-        StorageDBTest
+        StorageDBTest,
+        // StorageDB behind a read-through cache, see CachedStorage
+        StorageCachedDB
     };
 
     virtual ~AssetStorage() {};
@@ -46,11 +52,20 @@ public:
     virtual void                     loadExtMap(Asset& asset)        = 0;
     virtual void                     loadLinkedAssets(Asset& asset)  = 0;
     virtual std::vector<std::string> getChildren(const Asset& asset) = 0;
+    // number of ancestors of each asset, with one query per batch of assets; unknown assets are not in the result
+    virtual std::map<std::string, int> getDepths(const std::vector<std::string>& inames) = 0;
+
+    // loads assets, by their internal name, as loadAsset, loadExtMap and loadLinkedAssets do,
+    // with a few queries per batch of assets instead of several queries per asset;
+    // returns for each asset whether it was found
+    virtual std::vector<bool> loadAssets(const std::vector<Asset*>& assets) = 0;
 
     virtual fty::Expected<uint32_t> getID(const std::string& internalName) = 0;
     virtual uint32_t getTypeID(const std::string& type)       = 0;
     virtual uint32_t getSubtypeID(const std::string& subtype) = 0;
     virtual bool verifyID(std::string& id) = 0;
+    // verifyID for several ids at once, returns for each id whether it is unused
+    virtual std::vector<bool> verifyIDs(const std::vector<std::string>& ids) = 0;
 
     virtual bool hasLinkedAssets(const Asset& asset) = 0;
     virtual void unlinkAll(Asset& dest)              = 0;
@@ -61,20 +76,44 @@ public:
     virtual void removeExtMap(Asset& asset)          = 0;
     virtual bool isLastDataCenter(Asset& asset)      = 0;
 
+    // same checks and removal for several assets, with statements on the whole set
+    // links whose destination is one of the assets
+    virtual void unlinkAssets(const std::vector<std::string>& inames) = 0;
+    // number of children of each asset, assets without children are not in the result
+    virtual std::map<std::string, int> countChildren(const std::vector<std::string>& inames) = 0;
+    // assets that are the source of a link
+    virtual std::set<std::string> getLinkSources(const std::vector<std::string>& inames) = 0;
+    virtual int                   countDataCenters()                                     = 0;
+    // removes assets, their ext attributes, groups and relations; groups of assets are cleared
+    virtual void removeAssets(const std::vector<std::string>& inames) = 0;
+
     virtual void beginTransaction()    = 0;
     virtual void rollbackTransaction() = 0;
     virtual void commitTransaction()   = 0;
 
     virtual void update(Asset& asset) = 0;
     virtual void insert(Asset& asset) = 0;
+    // inserts new assets as insert, saveExtMap and saveLinkedAssets do, with multi-row inserts;
+    // parents of assets may be part of assets
+    virtual void insertAssets(const std::vector<Asset*>& assets, bool saveLinks = true) = 0;
+    // saves the links of assets that have none in database yet, with multi-row inserts
+    virtual void insertLinks(const std::vector<Asset*>& assets) = 0;
+    // sets the status of several assets at once
+    virtual void updateStatus(const std::vector<std::string>& inames, AssetStatus status) = 0;
 
     virtual void        saveLinkedAssets(Asset& asset)       = 0;
     virtual void        saveExtMap(Asset& asset)             = 0;
     virtual std::string inameById(uint32_t id)               = 0;
     virtual std::string inameByUuid(const std::string& uuid) = 0;
+    // inameByUuid for several uuids at once, unknown uuids are not in the result
+    virtual std::map<std::string, std::string> inamesByUuids(const std::vector<std::string>& uuids) = 0;
 
     virtual std::vector<std::string> listAssets(std::map<std::string, std::vector<std::string>> filters) = 0;
     virtual std::vector<std::string> listAllAssets()                                                     = 0;
+
+    // at most limit assets with an id greater than afterId, in id order (keyset pagination)
+    virtual std::vector<std::pair<uint32_t, std::string>> listAssetsPage(
+        std::map<std::string, std::vector<std::string>> filters, uint32_t afterId, size_t limit) = 0;
 };
 
 } // namespace fty
@@ -21,11 +21,13 @@
 
 #include "asset.h"
 #include "asset-cam.h"
+#include "asset-db-cache.h"
 #include "asset-db-test.h"
 #include "asset-db.h"
 #include "asset-storage.h"
 #include "asset/dbhelpers.h"
 #include <algorithm>
+#include <atomic>
 #include <fty_common_mlm.h>
 #include <fty_common.h>
 #include <fty_common_db_dbpath.h>
@@ -35,9 +37,13 @@
 #include <iostream>
 #include <map>
 #include <memory>
+#include <numeric>
 #include <openssl/sha.h>
+#include <random>
+#include <set>
 #include <sstream>
 #include <time.h>
+#include <unordered_map>
 #include <utility>
 #include <uuid/uuid.h>
 #include <fty_common_agents.h>
@@ -122,10 +128,20 @@ static std::string generateUUID(
     return uuid;
 }
 
+static std::atomic<AssetStorage::StorageType> g_storageType(AssetStorage::StorageType::StorageDB);
+
+static CachedStorage& getCachedStorage()
+{
+    static CachedStorage storage(DB::getInstance());
+    return storage;
+}
+
 static AssetStorage& getStorage()
 {
     if (g_testMode) {
         return DBTest::getInstance();
+    } else if (g_storageType == AssetStorage::StorageType::StorageCachedDB) {
+        return getCachedStorage();
     } else {
         return DB::getInstance();
     }
@@ -150,7 +166,7 @@ void operator>>=(const cxxtools::SerializationInfo& si, AssetFilters& filters)
             status >>= v;
 
             for (const std::string& val : v) {
-                filters["status"].push_back('"' + val + '"');
+                filters["status"].push_back(val);
             }
         }
     } catch (const std::exception& e) {
@@ -466,13 +482,160 @@ void AssetImpl::update()
     }
 }
 
+void AssetImpl::createBatch(std::vector<AssetImpl>& assets)
+{
+    AssetStorage& storage = getStorage();
+
+    storage.beginTransaction();
+    try {
+        if (!g_testMode) {
+            // names the assets were sent with, parents and links of the batch may refer to them
+            std::vector<std::string> requested;
+            for (const auto& asset : assets) {
+                requested.push_back(asset.getInternalName());
+            }
+
+            // one random generator for the batch, generateRandomID() seeds with the current time
+            std::mt19937                        generator(std::random_device{}());
+            std::uniform_int_distribution<long> distribution(0, 99999999);
+
+            std::set<std::string> used;
+            std::vector<size_t>   toName(assets.size());
+            std::iota(toName.begin(), toName.end(), 0);
+
+            unsigned int retry = 0;
+            while (!toName.empty()) {
+                if (retry++ > MAX_CREATE_RETRY) {
+                    throw std::runtime_error("Multiple Asset ID collisions - impossible to create asset");
+                }
+
+                std::vector<std::string> randomIds;
+                for (size_t i = 0; i < toName.size(); i++) {
+                    std::string randomId;
+                    do {
+                        randomId = std::to_string(distribution(generator));
+                        randomId = std::string(8 - randomId.length(), '0') + randomId;
+                    } while (used.count(randomId));
+                    used.insert(randomId);
+                    randomIds.push_back(randomId);
+                }
+
+                std::vector<bool>   valid = storage.verifyIDs(randomIds);
+                std::vector<size_t> collisions;
+                for (size_t i = 0; i < toName.size(); i++) {
+                    if (!valid[i]) {
+                        collisions.push_back(toName[i]);
+                        continue;
+                    }
+                    AssetImpl& asset = assets[toName[i]];
+                    asset.setInternalName(createAssetName(asset.getAssetType(), asset.getAssetSubtype(), randomIds[i]));
+                }
+                toName.swap(collisions);
+            }
+
+            // sent name -> generated name, a name sent twice is ambiguous and not renamed
+            std::map<std::string, std::string> renamed;
+            std::set<std::string>              ambiguous;
+            for (size_t i = 0; i < assets.size(); i++) {
+                if (!requested[i].empty() && !renamed.emplace(requested[i], assets[i].getInternalName()).second) {
+                    ambiguous.insert(requested[i]);
+                }
+            }
+            for (const auto& name : ambiguous) {
+                renamed.erase(name);
+            }
+
+            for (auto& asset : assets) {
+                auto parent = renamed.find(asset.getParentIname());
+                if (parent != renamed.end()) {
+                    asset.setParentIname(parent->second);
+                }
+                std::vector<AssetLink> links = asset.getLinkedAssets();
+                for (auto& link : links) {
+                    auto source = renamed.find(link.sourceId());
+                    if (source != renamed.end()) {
+                        link.setSourceId(source->second);
+                    }
+                }
+                asset.setLinkedAssets(links);
+            }
+        }
+
+        std::string         now = generateCurrentTimestamp();
+        std::vector<Asset*> toInsert;
+        for (auto& asset : assets) {
+            // set creation timestamp
+            asset.setExtEntry(fty::EXT_CREATE_TS, now, true);
+            // generate uuid if not already present in the payload
+            if (asset.getExtEntry("uuid").empty()) {
+                asset.setExtEntry(
+                    fty::EXT_UUID, generateUUID(asset.getManufacturer(), asset.getModel(), asset.getSerialNo()), true);
+            }
+            toInsert.push_back(&asset);
+        }
+
+        storage.insertAssets(toInsert);
+
+    } catch (const std::exception& e) {
+        storage.rollbackTransaction();
+        throw std::runtime_error(std::string(e.what()));
+    }
+    storage.commitTransaction();
+
+    // create CAM mappings
+    for (const auto& asset : assets) {
+        try {
+            auto credentialList = getCredentialMappings(asset.getExt());
+            createMappings(asset.getInternalName(), credentialList);
+        } catch (const std::exception& e) {
+            log_error("Failed to update CAM: %s", e.what());
+        }
+    }
+}
+
+void AssetImpl::updateBatch(std::vector<AssetImpl>& assets)
+{
+    AssetStorage& storage = getStorage();
+
+    storage.beginTransaction();
+    try {
+        std::string now = generateCurrentTimestamp();
+        for (auto& asset : assets) {
+            if (!g_testMode && !storage.getID(asset.getInternalName())) {
+                throw std::runtime_error("Update of " + asset.getInternalName() + " failed, asset does not exist.");
+            }
+            // set last update timestamp
+            asset.setExtEntry(fty::EXT_UPDATE_TS, now, true);
+
+            storage.update(asset);
+            storage.saveLinkedAssets(asset);
+            storage.saveExtMap(asset);
+        }
+    } catch (const std::exception& e) {
+        storage.rollbackTransaction();
+        throw std::runtime_error(std::string(e.what()));
+    }
+    storage.commitTransaction();
+
+    // update CAM mappings
+    for (const auto& asset : assets) {
+        try {
+            deleteMappings(asset.getInternalName());
+            auto credentialList = getCredentialMappings(asset.getExt());
+            createMappings(asset.getInternalName(), credentialList);
+        } catch (const std::exception& e) {
+            log_error("Failed to update CAM: %s", e.what());
+        }
+    }
+}
+
 void AssetImpl::restore(bool restoreLinks)
 {
-    m_storage.beginTransaction();
     // restore only if asset is not already in db
     if (m_storage.getID(getInternalName())) {
         throw std::runtime_error("Asset " + getInternalName() + " already exists, restore is not possible");
     }
+    m_storage.beginTransaction();
     try {
         // set creation timestamp
         setExtEntry(fty::EXT_CREATE_TS, generateCurrentTimestamp(), true);
@@ -598,37 +761,278 @@ void AssetImpl::deactivate()
     }
 }
 
+std::vector<bool> AssetImpl::restoreBatch(std::vector<AssetImpl>& assets)
+{
+    AssetStorage& storage = getStorage();
+
+    // depth of each asset among restored ones, parents come first
+    std::map<std::string, size_t>    depth;
+    std::vector<std::vector<size_t>> levels;
+    for (size_t i = 0; i < assets.size(); i++) {
+        auto   parent = depth.find(assets[i].getParentIname());
+        size_t d      = parent == depth.end() ? 0 : parent->second + 1;
+        depth[assets[i].getInternalName()] = d;
+        if (levels.size() <= d) {
+            levels.resize(d + 1);
+        }
+        levels[d].push_back(i);
+    }
+
+    // update() of the links pass used to set the update timestamp
+    std::string now = generateCurrentTimestamp();
+    for (auto& asset : assets) {
+        asset.setExtEntry(fty::EXT_CREATE_TS, now, true);
+        asset.setExtEntry(fty::EXT_UPDATE_TS, now, true);
+    }
+
+    std::vector<bool> restored(assets.size(), false);
+    for (size_t d = 0; d < levels.size(); d++) {
+        std::vector<Asset*> toInsert;
+        for (size_t i : levels[d]) {
+            toInsert.push_back(&assets[i]);
+        }
+
+        storage.beginTransaction();
+        try {
+            storage.insertAssets(toInsert, false);
+        } catch (const std::exception& e) {
+            storage.rollbackTransaction();
+            log_warning("Restore of level %zu failed (%s), restoring its assets one by one", d, e.what());
+
+            for (size_t i : levels[d]) {
+                try {
+                    assets[i].restore();
+                    restored[i] = true;
+                } catch (const std::exception& e) {
+                    log_error("Restore of %s failed: %s", assets[i].getInternalName().c_str(), e.what());
+                } catch (const char* e) {
+                    log_error("Restore of %s failed: %s", assets[i].getInternalName().c_str(), e);
+                } catch (...) {
+                    log_error("Restore of %s failed", assets[i].getInternalName().c_str());
+                }
+            }
+            continue;
+        }
+        storage.commitTransaction();
+
+        // create CAM mappings
+        for (size_t i : levels[d]) {
+            restored[i] = true;
+            try {
+                auto credentialList = getCredentialMappings(assets[i].getExt());
+                createMappings(assets[i].getInternalName(), credentialList);
+            } catch (const std::exception& e) {
+                log_error("Failed to update CAM: %s", e.what());
+            }
+        }
+    }
+
+    return restored;
+}
+
+// sends command for each device of assets, sets status of the assets for which it succeeded
+static std::vector<bool> requestEachDevice(const std::vector<AssetImpl*>& assets, const std::string& command,
+    fty::AssetStatus status, const AssetImpl::ActivationRequest& request)
+{
+    std::vector<bool> done(assets.size(), true);
+    for (size_t i = 0; i < assets.size(); i++) {
+        AssetImpl* asset = assets[i];
+        if (request && asset->getAssetType() == TYPE_DEVICE) {
+            try {
+                request(command, {Asset::toFullAsset(*asset).toJson()});
+            } catch (const std::exception& e) {
+                log_error("%s of asset %s failed: %s", command.c_str(), asset->getInternalName().c_str(), e.what());
+                done[i] = false;
+                continue;
+            }
+        }
+        asset->setAssetStatus(status);
+    }
+    return done;
+}
+
+std::vector<bool> AssetImpl::activateBatch(const std::vector<AssetImpl*>& assets)
+{
+    // other assets are only flagged active
+    return activateBatch(assets, g_testMode ? ActivationRequest() : sendActivationReq);
+}
+
+std::vector<bool> AssetImpl::activateBatch(const std::vector<AssetImpl*>& assets, const ActivationRequest& request)
+{
+    return requestEachDevice(assets, COMMAND_ACTIVATE_ASSET, fty::AssetStatus::Active, request);
+}
+
+std::vector<bool> AssetImpl::deactivateBatch(const std::vector<AssetImpl*>& assets)
+{
+    return deactivateBatch(assets, g_testMode ? ActivationRequest() : sendActivationReq);
+}
+
+std::vector<bool> AssetImpl::deactivateBatch(const std::vector<AssetImpl*>& assets, const ActivationRequest& request)
+{
+    return requestEachDevice(assets, COMMAND_DEACTIVATE_ASSET, fty::AssetStatus::Nonactive, request);
+}
+
+void AssetImpl::updateStatusBatch(const std::vector<std::string>& inames, AssetStatus status)
+{
+    if (inames.empty()) {
+        return;
+    }
+
+    AssetStorage& storage = getStorage();
+
+    storage.beginTransaction();
+    try {
+        storage.updateStatus(inames, status);
+    } catch (const std::exception& e) {
+        storage.rollbackTransaction();
+        throw std::runtime_error(std::string(e.what()));
+    }
+    storage.commitTransaction();
+}
+
+void AssetImpl::restoreLinksBatch(const std::vector<AssetImpl*>& assets)
+{
+    AssetStorage& storage = getStorage();
+
+    std::vector<Asset*>      toLink;
+    std::vector<std::string> active;
+    for (const auto& asset : assets) {
+        toLink.push_back(asset);
+        if (asset->getAssetStatus() == fty::AssetStatus::Active) {
+            active.push_back(asset->getInternalName());
+        }
+    }
+
+    storage.beginTransaction();
+    try {
+        storage.insertLinks(toLink);
+        storage.updateStatus(active, fty::AssetStatus::Active);
+    } catch (const std::exception& e) {
+        storage.rollbackTransaction();
+        log_warning("Restore of links failed (%s), saving them asset by asset", e.what());
+
+        for (auto& asset : assets) {
+            try {
+                asset->update();
+            } catch (const std::exception& e) {
+                log_error(e.what());
+            }
+        }
+        return;
+    }
+    storage.commitTransaction();
+}
+
 void AssetImpl::unlinkAll()
 {
     m_storage.unlinkAll(*this);
 }
 
-static std::vector<fty::Asset> buildParentsList(const std::string iname)
+void AssetImpl::updateParentsList()
+{
+    ParentsCache cache;
+    updateParentsList(cache);
+}
+
+void AssetImpl::updateParentsList(ParentsCache& cache)
 {
     std::vector<fty::Asset> parents;
 
-    fty::AssetImpl a(iname);
+    const fty::Asset* a = this;
 
-    while (!a.getParentIname().empty())
+    while (!a->getParentIname().empty())
     {
-        if (a.getParentIname() == a.getInternalName()) {
-            log_error("Self parent detected (%s)", a.getInternalName().c_str());
+        if (a->getParentIname() == a->getInternalName()) {
+            log_error("Self parent detected (%s)", a->getInternalName().c_str());
             break;
         }
 
-        a = fty::AssetImpl(a.getParentIname());
-        parents.push_back(a);
+        auto it = cache.find(a->getParentIname());
+        if (it == cache.end()) {
+            it = cache.emplace(a->getParentIname(), fty::AssetImpl(a->getParentIname())).first;
+        }
+        a = &it->second;
+        parents.push_back(*a);
 
         // secure, avoid infinite loop
         if (parents.size() > 32) break;
     }
 
-    return parents;
+    m_parentsList = parents;
 }
 
-void AssetImpl::updateParentsList()
+void AssetImpl::sortParentsFirst(std::vector<AssetImpl>& assets)
+{
+    std::unordered_map<std::string, size_t> index;
+    for (size_t i = 0; i < assets.size(); i++) {
+        index.emplace(assets[i].getInternalName(), i);
+    }
+
+    // roots are assets whose parent is not in the list
+    std::unordered_map<size_t, std::vector<size_t>> children;
+    std::vector<size_t>                             order;
+    for (size_t i = 0; i < assets.size(); i++) {
+        auto parent = index.find(assets[i].getParentIname());
+        if (parent == index.end() || parent->second == i) {
+            order.push_back(i);
+        } else {
+            children[parent->second].push_back(i);
+        }
+    }
+
+    // breadth first walk, order grows while it is read
+    for (size_t next = 0; next < order.size(); next++) {
+        auto it = children.find(order[next]);
+        if (it != children.end()) {
+            order.insert(order.end(), it->second.begin(), it->second.end());
+        }
+    }
+
+    // assets in a parent cycle are never reached, keep them at the end
+    if (order.size() < assets.size()) {
+        std::vector<bool> placed(assets.size(), false);
+        for (size_t i : order) {
+            placed[i] = true;
+        }
+        for (size_t i = 0; i < assets.size(); i++) {
+            if (!placed[i]) {
+                log_warning("Asset %s is in a parent cycle", assets[i].getInternalName().c_str());
+                order.push_back(i);
+            }
+        }
+    }
+
+    std::vector<AssetImpl> sorted;
+    sorted.reserve(assets.size());
+    for (size_t i : order) {
+        sorted.push_back(std::move(assets[i]));
+    }
+    assets.swap(sorted);
+}
+
+void AssetImpl::loadParents(const std::vector<AssetImpl>& assets, ParentsCache& cache)
 {
-    m_parentsList = buildParentsList(getInternalName());
+    std::set<std::string> missing;
+    for (const auto& asset : assets) {
+        const std::string& parent = asset.getParentIname();
+        if (!parent.empty() && parent != asset.getInternalName() && cache.count(parent) == 0) {
+            missing.insert(parent);
+        }
+    }
+
+    // one level of ancestors at a time, same depth limit as updateParentsList()
+    for (int level = 0; !missing.empty() && level <= 32; level++) {
+        std::set<std::string> next;
+        for (auto& parent : loadList(std::vector<std::string>(missing.begin(), missing.end()))) {
+            const std::string& grandParent = parent.getParentIname();
+            if (!grandParent.empty() && grandParent != parent.getInternalName() && cache.count(grandParent) == 0 &&
+                missing.count(grandParent) == 0) {
+                next.insert(grandParent);
+            }
+            cache.emplace(parent.getInternalName(), parent);
+        }
+        missing.swap(next);
+    }
 }
 
 void AssetImpl::assetToSrr(const AssetImpl& asset, cxxtools::SerializationInfo& si)
@@ -694,6 +1098,40 @@ void AssetImpl::assetToSrr(const AssetImpl& asset, cxxtools::SerializationInfo&
     ext.setName("ext");
 }
 
+// assets loaded and serialized at once by assetsToSrr()
+static constexpr size_t SRR_SAVE_CHUNK = 100;
+
+void AssetImpl::assetsToSrr(const std::vector<std::string>& inames, std::ostream& out, bool saveVirtualAssets)
+{
+    bool first = true;
+
+    out << "[";
+    for (size_t begin = 0; begin < inames.size(); begin += SRR_SAVE_CHUNK) {
+        size_t                   end = std::min(begin + SRR_SAVE_CHUNK, inames.size());
+        std::vector<std::string> chunk(inames.begin() + begin, inames.begin() + end);
+
+        for (const auto& a : loadList(chunk)) {
+            if (a.isVirtual() && !saveVirtualAssets) {
+                log_info("Asset %s is virtual, will not be saved", a.getInternalName().c_str());
+                continue;
+            }
+
+            log_debug("Saving asset %s...", a.getInternalName().c_str());
+
+            cxxtools::SerializationInfo si;
+            assetToSrr(a, si);
+            si.setCategory(cxxtools::SerializationInfo::Category::Object);
+
+            if (!first) {
+                out << ",";
+            }
+            out << JSON::writeToString(si, false);
+            first = false;
+        }
+    }
+    out << "]";
+}
+
 void AssetImpl::srrToAsset(const cxxtools::SerializationInfo& si, AssetImpl& asset)
 {
     int         tmpInt = 0;
@@ -787,11 +1225,52 @@ std::vector<std::string> AssetImpl::list(const AssetFilters& filters)
     return getStorage().listAssets(filters);
 }
 
+std::vector<std::string> AssetImpl::list(
+    const AssetFilters& filters, uint32_t cursor, size_t limit, uint32_t& nextCursor)
+{
+    // one more asset tells if there is a next page
+    auto page = getStorage().listAssetsPage(filters, cursor, limit + 1);
+
+    nextCursor = 0;
+    if (page.size() > limit) {
+        page.resize(limit);
+        nextCursor = page.empty() ? cursor : page.back().first;
+    }
+
+    std::vector<std::string> inames;
+    for (const auto& it : page) {
+        inames.push_back(it.second);
+    }
+    return inames;
+}
+
 std::vector<std::string> AssetImpl::listAll()
 {
     return getStorage().listAllAssets();
 }
 
+std::vector<AssetImpl> AssetImpl::loadList(const std::vector<std::string>& inames)
+{
+    std::vector<AssetImpl> assets(inames.size());
+    std::vector<Asset*>    toLoad;
+    for (size_t i = 0; i < inames.size(); i++) {
+        assets[i].setInternalName(inames[i]);
+        toLoad.push_back(&assets[i]);
+    }
+
+    auto found = getStorage().loadAssets(toLoad);
+
+    std::vector<AssetImpl> loaded;
+    for (size_t i = 0; i < assets.size(); i++) {
+        if (found[i]) {
+            loaded.push_back(assets[i]);
+        } else {
+            log_error("Could not retrieve asset %s", inames[i].c_str());
+        }
+    }
+    return loaded;
+}
+
 void AssetImpl::load()
 {
     m_storage.loadAsset(getInternalName(), *this);
@@ -843,9 +1322,8 @@ DeleteStatus AssetImpl::deleteList(const std::vector<std::string>& assets, bool
 
     DeleteStatus deleted;
 
-    for (const std::string& iname : assets) {
+    for (const auto& a : loadList(assets)) {
         try {
-            AssetImpl a(iname);
             if(a.isVirtual() && !deleteVirtualAssets) {
                 log_info("Asset %s is virtual, skipping delete...", a.getInternalName().c_str());
                 continue;
@@ -853,71 +1331,139 @@ DeleteStatus AssetImpl::deleteList(const std::vector<std::string>& assets, bool
             toDel.push_back(a);
 
             if (recursive) {
-                addSubTree(iname, toDel);
+                addSubTree(a.getInternalName(), toDel);
             }
         } catch (std::exception& e) {
-            log_warning("Error while loading asset %s. %s", iname.c_str(), e.what());
+            log_warning("Error while loading asset %s. %s", a.getInternalName().c_str(), e.what());
         }
     }
 
-    auto isAnyParent = [&](const AssetImpl& l, const AssetImpl& r) {
-        std::vector<std::pair<std::string, int>> lTree;
-        auto                                     ptr = l;
-        // path to root of L
-        int distL = 0;
-        while (ptr.getParentIname() != "") {
-            lTree.push_back(std::make_pair(ptr.getInternalName(), distL));
-            std::string parentIname = ptr.getParentIname();
-            ptr                     = AssetImpl(parentIname);
-            distL++;
+    // an asset listed twice, or listed and in a subtree, is removed once
+    std::set<std::string>  seen;
+    std::vector<AssetImpl> unique;
+    for (auto& a : toDel) {
+        if (seen.insert(a.getInternalName()).second) {
+            unique.push_back(a);
         }
+    }
+    toDel.swap(unique);
 
-        int distR = 0;
-        ptr       = r;
-        while (ptr.getParentIname() != "") {
-            // look for LCA, if exists
-            auto found = std::find_if(lTree.begin(), lTree.end(), [&](const std::pair<std::string, int>& p) {
-                return p.first == ptr.getInternalName();
-            });
-            if (found != lTree.end()) {
-                distL = found->second; // distance of L from LCA
-                break;
-            }
-
-            ptr = AssetImpl(ptr.getParentIname());
-            distR++;
-        }
-        // farthest node from LCA gets deleted first
-        return distL > distR;
+    // deepest assets are deleted first, so that children go before their parents
+    std::vector<std::string> inames;
+    for (const auto& a : toDel) {
+        inames.push_back(a.getInternalName());
+    }
+    auto depths = getStorage().getDepths(inames);
+    auto depth  = [&depths](const AssetImpl& a) {
+        auto it = depths.find(a.getInternalName());
+        return it == depths.end() ? 0 : it->second;
     };
 
     // sort by deletion order
-    std::sort(toDel.begin(), toDel.end(), [&](const AssetImpl& l, const AssetImpl& r) {
-        return isAnyParent(l, r);
+    std::stable_sort(toDel.begin(), toDel.end(), [&](const AssetImpl& l, const AssetImpl& r) {
+        return depth(l) > depth(r);
     });
 
+    AssetStorage& storage = getStorage();
+
     // remove all links
-    for (auto& a : toDel) {
-        a.unlinkAll();
+    storage.unlinkAssets(inames);
+
+    // checks of remove(), on the state left by the assets removed before
+    auto children    = storage.countChildren(inames);
+    auto sources     = storage.getLinkSources(inames);
+    int  datacenters = storage.countDataCenters();
+
+    std::vector<std::string> errors(toDel.size());
+    std::vector<std::string> toRemove;
+    std::vector<AssetImpl*>  toDeactivate;
+    for (size_t i = 0; i < toDel.size(); i++) {
+        const AssetImpl& d = toDel[i];
+
+        bool isDC        = d.getAssetType() == TYPE_DATACENTER;
+        bool isContainer = isAnyOf(d.getAssetType(), TYPE_DATACENTER, TYPE_ROW, TYPE_ROOM, TYPE_RACK);
+
+        if (RC0 == d.getInternalName()) {
+            errors[i] = "cannot delete RC-0";
+        } else if (sources.count(d.getInternalName())) {
+            errors[i] = "it the source of a link";
+        } else if (children[d.getInternalName()] > 0) {
+            errors[i] = "it has at least one child";
+        } else if (isContainer && !removeLastDC && datacenters - (isDC ? 1 : 0) == 0) {
+            errors[i] = "cannot delete last datacenter";
+        } else {
+            toRemove.push_back(d.getInternalName());
+            if (d.getAssetStatus() == AssetStatus::Active) {
+                toDeactivate.push_back(&toDel[i]);
+            }
+            if (!d.getParentIname().empty()) {
+                children[d.getParentIname()]--;
+            }
+            if (isDC) {
+                datacenters--;
+            }
+        }
     }
 
-    for (auto& d : toDel) {
-        // after deleting assets, children list may change -> reload
-        d.load();
+    // deactivate assets
+    std::vector<bool> deactivated = deactivateBatch(toDeactivate);
 
-        try {
-            d.remove(removeLastDC);
-            deleted.push_back({d, "OK"});
+    storage.beginTransaction();
+    try {
+        storage.removeAssets(toRemove);
+    } catch (const std::exception& e) {
+        storage.rollbackTransaction();
+        log_warning("Removal of %zu assets failed (%s), removing them one by one", toRemove.size(), e.what());
+
+        // reactivate assets, remove() deactivates them again
+        std::vector<AssetImpl*> toReactivate;
+        for (size_t i = 0; i < toDeactivate.size(); i++) {
+            if (deactivated[i]) {
+                toReactivate.push_back(toDeactivate[i]);
+            }
+        }
+        activateBatch(toReactivate);
+
+        for (auto& d : toDel) {
+            // after deleting assets, children list may change -> reload
+            d.load();
 
-            // remove CAM mappings
             try {
-                deleteMappings(d.getInternalName());
-            } catch (const std::exception& e) {
-                log_error("Failed to update CAM: %s", e.what());
+                d.remove(removeLastDC);
+                deleted.push_back({d, "OK"});
+
+                // remove CAM mappings
+                try {
+                    deleteMappings(d.getInternalName());
+                } catch (const std::exception& e) {
+                    log_error("Failed to update CAM: %s", e.what());
+                }
+            } catch (std::exception& e) {
+                log_error("Asset could not be removed: %s", e.what());
+                deleted.push_back({d, "Asset could not be removed: " + std::string(e.what())});
             }
-        } catch (std::exception& e) {
-            log_error("Asset could not be removed: %s", e.what());
-            deleted.push_back({d, "Asset could not be removed: " + std::string(e.what())});
+        }
+        return deleted;
+    }
+    storage.commitTransaction();
+
+    for (size_t i = 0; i < toDel.size(); i++) {
+        const AssetImpl& d = toDel[i];
+
+        if (!errors[i].empty()) {
+            log_error("Asset could not be removed: %s", errors[i].c_str());
+            deleted.push_back({d, "Asset could not be removed: " + errors[i]});
+            continue;
+        }
+
+        log_debug("Asset %s removed", d.getInternalName().c_str());
+        deleted.push_back({d, "OK"});
+
+        // remove CAM mappings
+        try {
+            deleteMappings(d.getInternalName());
+        } catch (const std::exception& e) {
+            log_error("Failed to update CAM: %s", e.what());
         }
     }
 
@@ -936,6 +1482,39 @@ std::string AssetImpl::getInameFromUuid(const std::string& uuid)
     return getStorage().inameByUuid(uuid);
 }
 
+std::map<std::string, std::string> AssetImpl::getInamesFromUuids(const std::vector<std::string>& uuids)
+{
+    return getStorage().inamesByUuids(uuids);
+}
+
+void AssetImpl::setStorageType(AssetStorage::StorageType type)
+{
+    // the cache may hold assets written through the plain storage meanwhile
+    if (type == AssetStorage::StorageType::StorageCachedDB && g_storageType != type) {
+        getCachedStorage().clear();
+    }
+    g_storageType = type;
+}
+
+void AssetImpl::setStorageCacheBudget(size_t bytes)
+{
+    getCachedStorage().setBudget(bytes);
+}
+
+void AssetImpl::invalidateStorageCache(const std::string& iname)
+{
+    if (g_storageType == AssetStorage::StorageType::StorageCachedDB) {
+        getCachedStorage().invalidate(iname);
+    }
+}
+
+void AssetImpl::clearStorageCache()
+{
+    if (g_storageType == AssetStorage::StorageType::StorageCachedDB) {
+        getCachedStorage().clear();
+    }
+}
+
 /// get internal database index from iname
 uint32_t AssetImpl::getIDFromIname(const std::string& iname)
 {
@@ -21,8 +21,11 @@
 
 #pragma once
 
+#include "asset-storage.h"
 #include "fty_asset_dto.h"
+#include <functional>
 #include <map>
+#include <ostream>
 #include <string>
 #include <vector>
 
@@ -32,13 +35,14 @@ namespace fty {
 
 static constexpr const char* RC0 = "rackcontroller-0";
 
-class AssetStorage;
-
 using AssetFilters = std::map<std::string, std::vector<std::string>>;
 void operator>>=(const cxxtools::SerializationInfo& si, AssetFilters& filters);
 
 using DeleteStatus = std::vector<std::pair<Asset, std::string>>;
 
+// ancestors by iname, shared by the assets of a request so that each of them is loaded once
+using ParentsCache = std::map<std::string, Asset>;
+
 class AssetImpl : public Asset
 {
 public:
@@ -64,21 +68,68 @@ public:
     void unlinkAll();
 
     void updateParentsList();
+    // same, ancestors are taken from cache and the missing ones are added to it
+    void updateParentsList(ParentsCache& cache);
+
+    // create() and update() of several assets in one transaction: all assets are written or none is;
+    // created assets get new names, parents and link sources naming an asset of the batch are renamed too
+    static void createBatch(std::vector<AssetImpl>& assets);
+    static void updateBatch(std::vector<AssetImpl>& assets);
+
+    // restore() without links of assets ordered parents first, one transaction per hierarchy level,
+    // asset by asset for a level that fails; returns for each asset whether it was restored
+    static std::vector<bool> restoreBatch(std::vector<AssetImpl>& assets);
+    // request to the asset activator: command and frames, returns the reply frames or throws
+    using ActivationRequest =
+        std::function<std::vector<std::string>(const std::string& command, const std::vector<std::string>& frames)>;
+    // activation of several assets, one activation request per device as the activator takes one asset;
+    // status is set in memory only, returns for each asset whether it was activated
+    static std::vector<bool> activateBatch(const std::vector<AssetImpl*>& assets);
+    static std::vector<bool> activateBatch(const std::vector<AssetImpl*>& assets, const ActivationRequest& request);
+    // same as activateBatch() for the deactivation
+    static std::vector<bool> deactivateBatch(const std::vector<AssetImpl*>& assets);
+    static std::vector<bool> deactivateBatch(const std::vector<AssetImpl*>& assets, const ActivationRequest& request);
+    // status of several assets in one transaction, as set in memory by activateBatch() or deactivateBatch()
+    static void updateStatusBatch(const std::vector<std::string>& inames, AssetStatus status);
+    // links and status of restored assets in one transaction, update() of each asset if it fails
+    static void restoreLinksBatch(const std::vector<AssetImpl*>& assets);
 
     static void assetToSrr(const AssetImpl& asset, cxxtools::SerializationInfo& si);
     static void srrToAsset(const cxxtools::SerializationInfo& si, AssetImpl& asset);
+    // writes the JSON array of the SRR data of inames to out, loading and serializing a few assets at a time
+    static void assetsToSrr(const std::vector<std::string>& inames, std::ostream& out, bool saveVirtualAssets = false);
 
     static std::vector<std::string> list(const AssetFilters& filters);
     static std::vector<std::string> listAll();
+    // page of at most limit assets following cursor (0 for the first page), nextCursor is 0 on the last page
+    static std::vector<std::string> list(
+        const AssetFilters& filters, uint32_t cursor, size_t limit, uint32_t& nextCursor);
+
+    // loads assets as AssetImpl(iname) does, with a few queries for all of them; missing assets are skipped
+    static std::vector<AssetImpl> loadList(const std::vector<std::string>& inames);
+    // adds to cache the ancestors of assets, with one loadList() per level
+    static void loadParents(const std::vector<AssetImpl>& assets, ParentsCache& cache);
+    // reorders assets so that parents come before their children, in linear time
+    static void sortParentsFirst(std::vector<AssetImpl>& assets);
 
     static DeleteStatus deleteList(
         const std::vector<std::string>& assets, bool recursive, bool deleteVirtualAssets = true, bool removeLastDC = false);
     static DeleteStatus deleteAll(bool deleteVirtualAsset = false);
 
     static std::string getInameFromUuid(const std::string& uuid);
+    // uuid -> iname, unknown uuids are not in the result
+    static std::map<std::string, std::string> getInamesFromUuids(const std::vector<std::string>& uuids);
     static uint32_t    getIDFromIname(const std::string& iname);
     static std::string getInameFromID(const uint32_t id);
 
+    // storage of the assets created afterwards, test mode always uses StorageDBTest
+    static void setStorageType(AssetStorage::StorageType type);
+    // memory used by the StorageCachedDB cache, in bytes
+    static void setStorageCacheBudget(size_t bytes);
+    // asset changed by another agent, no-op unless StorageCachedDB is used
+    static void invalidateStorageCache(const std::string& iname);
+    static void clearStorageCache();
+
     using Asset::operator==;
 
     friend std::vector<std::string> getChildren(const AssetImpl& a);
@@ -0,0 +1,231 @@
+/*  =========================================================================
+    connection-pool - fixed size pool of database connections
+
+    Copyright (C) 2014 - 2020 Eaton
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+    =========================================================================
+*/
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+namespace fty {
+
+// Connections shared by threads. A thread borrows a connection for one operation or one transaction
+// and keeps it for itself until its outermost borrow ends, nested borrows get the same connection.
+// Connections are opened on first use and kept open, so whatever they cache (prepared statements)
+// is reused by the next borrowers; a connection failing its check is opened again, when borrowed
+// and when an operation on it throws. Threads wait when all connections are borrowed.
+// There is one pool per Connection type in a process.
+template <typename Connection>
+class ConnectionPool
+{
+public:
+    using Factory = std::function<Connection()>;
+    // false if the connection is not usable anymore (server restarted, idle timeout)
+    using Check = std::function<bool(Connection&)>;
+
+    // borrows a connection for its lifetime
+    class Lease
+    {
+    public:
+        explicit Lease(ConnectionPool& pool)
+            : m_pool(pool)
+            , m_exceptions(std::uncaught_exceptions())
+        {
+            m_pool.borrow();
+        }
+
+        ~Lease()
+        {
+            if (std::uncaught_exceptions() > m_exceptions) {
+                m_pool.failed();
+            }
+            m_pool.giveBack();
+        }
+
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+
+        Connection& connection()
+        {
+            return m_pool.current();
+        }
+
+    private:
+        ConnectionPool& m_pool;
+        int             m_exceptions;
+    };
+
+    explicit ConnectionPool(Factory factory, size_t size = 4, Check check = Check())
+        : m_factory(factory)
+        , m_check(check)
+        , m_size(size ? size : 1)
+    {
+    }
+
+    ConnectionPool(const ConnectionPool&) = delete;
+    ConnectionPool& operator=(const ConnectionPool&) = delete;
+
+    // connections opened beyond a smaller size stay open but are no longer borrowed
+    void setSize(size_t size)
+    {
+        std::unique_lock<std::mutex> lock(m_lock);
+        m_size = size ? size : 1;
+        m_free.notify_all();
+    }
+
+    size_t getSize() const
+    {
+        std::unique_lock<std::mutex> lock(m_lock);
+        return m_size;
+    }
+
+    // number of borrows which waited for a free connection
+    uint64_t waits() const
+    {
+        std::unique_lock<std::mutex> lock(m_lock);
+        return m_waits;
+    }
+
+    // Lease for a scope, borrow() and giveBack() for a transaction spanning several calls
+    void borrow()
+    {
+        if (t_depth++ > 0) {
+            return;
+        }
+
+        std::unique_lock<std::mutex> lock(m_lock);
+
+        Slot* slot = idle();
+        if (!slot) {
+            m_waits++;
+            m_free.wait(lock, [&] {
+                return (slot = idle()) != nullptr;
+            });
+        }
+        slot->busy = true;
+        t_slot     = slot;
+        lock.unlock();
+
+        try {
+            if (slot->connection && !usable(*slot->connection)) {
+                slot->connection.reset();
+            }
+            if (!slot->connection) {
+                slot->connection.reset(new Connection(m_factory()));
+            }
+        } catch (...) {
+            giveBack();
+            throw;
+        }
+    }
+
+    // an operation on the connection of the calling thread threw, it is dropped if it does not pass
+    // its check; within a transaction, only when the transaction gives it back
+    void failed()
+    {
+        if (!t_slot || !t_slot->connection || t_depth > 1) {
+            return;
+        }
+        try {
+            if (!usable(*t_slot->connection)) {
+                t_slot->connection.reset();
+            }
+        } catch (...) {
+            t_slot->connection.reset();
+        }
+    }
+
+    void giveBack()
+    {
+        // unbalanced give back, nothing is borrowed
+        if (t_depth == 0) {
+            return;
+        }
+        if (--t_depth > 0) {
+            return;
+        }
+
+        std::unique_lock<std::mutex> lock(m_lock);
+        t_slot->busy = false;
+        t_slot       = nullptr;
+        m_free.notify_one();
+    }
+
+    // connection borrowed by the calling thread
+    Connection& current()
+    {
+        if (!t_slot || !t_slot->connection) {
+            throw std::runtime_error("No database connection borrowed by this thread");
+        }
+        return *t_slot->connection;
+    }
+
+private:
+    struct Slot
+    {
+        std::unique_ptr<Connection> connection;
+        bool                        busy = false;
+    };
+
+    Factory                            m_factory;
+    Check                              m_check;
+    size_t                             m_size;
+    uint64_t                           m_waits = 0;
+    std::vector<std::unique_ptr<Slot>> m_slots;
+    mutable std::mutex                 m_lock;
+    std::condition_variable            m_free;
+
+    static thread_local Slot*  t_slot;
+    static thread_local size_t t_depth;
+
+    bool usable(Connection& connection)
+    {
+        return !m_check || m_check(connection);
+    }
+
+    // free slot among the first m_size ones, new slot if there are fewer, called locked
+    Slot* idle()
+    {
+        for (size_t i = 0; i < m_slots.size() && i < m_size; i++) {
+            if (!m_slots[i]->busy) {
+                return m_slots[i].get();
+            }
+        }
+        if (m_slots.size() < m_size) {
+            m_slots.emplace_back(new Slot);
+            return m_slots.back().get();
+        }
+        return nullptr;
+    }
+};
+
+template <typename Connection>
+thread_local typename ConnectionPool<Connection>::Slot* ConnectionPool<Connection>::t_slot = nullptr;
+
+template <typename Connection>
+thread_local size_t ConnectionPool<Connection>::t_depth = 0;
+
+} // namespace fty
@@ -0,0 +1,83 @@
+/*  =========================================================================
+    counted-statement - prepared statement counting its executions
+
+    Copyright (C) 2014 - 2020 Eaton
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+    =========================================================================
+*/
+
+#pragma once
+
+#include "request-stats.h"
+#include <string>
+#include <tntdb.h>
+
+namespace fty {
+
+// Prepared statement whose every execution is counted as a DB round trip in RequestStats,
+// so a statement executed in a loop or reused from the statement cache is counted each time it runs
+class CountedStatement
+{
+public:
+    CountedStatement() = default;
+
+    explicit CountedStatement(const tntdb::Statement& statement)
+        : m_statement(statement)
+    {
+    }
+
+    template <typename T>
+    CountedStatement& set(const std::string& col, const T& data)
+    {
+        m_statement.set(col, data);
+        return *this;
+    }
+
+    CountedStatement& setNull(const std::string& col)
+    {
+        m_statement.setNull(col);
+        return *this;
+    }
+
+    tntdb::Statement::size_type execute()
+    {
+        RequestStats::countDbQuery();
+        return m_statement.execute();
+    }
+
+    tntdb::Result select()
+    {
+        RequestStats::countDbQuery();
+        return m_statement.select();
+    }
+
+    tntdb::Row selectRow()
+    {
+        RequestStats::countDbQuery();
+        return m_statement.selectRow();
+    }
+
+    tntdb::Value selectValue()
+    {
+        RequestStats::countDbQuery();
+        return m_statement.selectValue();
+    }
+
+private:
+    tntdb::Statement m_statement;
+};
+
+} // namespace fty
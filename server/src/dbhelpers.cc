@@ -28,12 +28,18 @@
 
 
 #include "asset/dbhelpers.h"
+#include "asset/asset.h"
+#include "asset-msg-cache.h"
 
 #include "fty_proto.h"
 #include "fty_asset_dto.h"
 #include "fty_asset_server.h"
+#include "counted-statement.h"
+#include "request-stats.h"
 #include <fty_log.h>
 #include <cxxtools/jsonserializer.h>
+#include <algorithm>
+#include <iterator>
 
 #define INPUT_POWER_CHAIN     1
 #define AGENT_ASSET_ACTIVATOR "etn-licensing-credits"
@@ -57,6 +63,7 @@ int select_assets_by_container(const std::string& container_name, const std::set
 {
     if (test)
         return 0;
+    fty::RequestStats::countDbQuery();
     tntdb::Connection conn = tntdb::connectCached(DBConn::url);
     [[maybe_unused]] int rv = DBAssets::select_assets_by_container_name_filter(conn, container_name, filter, assets);
     return rv;
@@ -77,6 +84,7 @@ int select_asset_element_basic(
 {
     if (test)
         return 0;
+    fty::RequestStats::countDbQuery();
     tntdb::Connection conn = tntdb::connectCached(DBConn::url);
     int               rv   = DBAssets::select_asset_element_basic_cb(conn, asset_name, cb);
     return rv;
@@ -96,6 +104,7 @@ int select_ext_attributes(uint32_t asset_id, std::function<void(const tntdb::Row
 {
     if (test)
         return 0;
+    fty::RequestStats::countDbQuery();
     tntdb::Connection conn = tntdb::connectCached(DBConn::url);
     int               rv   = DBAssets::select_ext_attributes_cb(conn, asset_id, cb);
     return rv;
@@ -115,6 +124,7 @@ int select_asset_element_super_parent(uint32_t id, std::function<void(const tntd
 {
     if (test)
         return 0;
+    fty::RequestStats::countDbQuery();
     tntdb::Connection conn = tntdb::connectCached(DBConn::url);
     int               rv   = DBAssets::select_asset_element_super_parent(conn, id, cb);
     return rv;
@@ -131,6 +141,7 @@ int select_assets_by_filter(const std::set<std::string>& filter, std::vector<std
     if (test)
         return 0;
 
+    fty::RequestStats::countDbQuery();
     tntdb::Connection conn = tntdb::connectCached(DBConn::url);
     int               rv   = DBAssets::select_assets_by_filter(conn, filter, assets);
     return rv;
@@ -149,11 +160,308 @@ int select_assets(std::function<void(const tntdb::Row&)>& cb, bool test)
 {
     if (test)
         return 0;
+    fty::RequestStats::countDbQuery();
     tntdb::Connection conn = tntdb::connectCached(DBConn::url);
     int               rv   = DBAssets::select_assets_cb(conn, cb);
     return rv;
 }
 
+#define SQL_ASSET_ELEMENT_BASIC                                                                              \
+    " SELECT "                                                                                               \
+    "   a.id_asset_element AS id, "                                                                          \
+    "   a.name             AS name, "                                                                        \
+    "   a.id_type          AS id_type, "                                                                     \
+    "   a.id_subtype       AS subtype_id, "                                                                  \
+    "   a.id_parent        AS id_parent, "                                                                   \
+    "   a.status           AS status, "                                                                      \
+    "   a.priority         AS priority "                                                                     \
+    " FROM "                                                                                                 \
+    "   t_bios_asset_element AS a "
+
+/**
+ *  \brief Selects basic asset info for all assets in the DB at once
+ *         Columns are the same as select_asset_element_basic:
+ *         id, name, id_type, subtype_id, id_parent, status, priority
+ *
+ *  \param[in] cb - function to call on each row
+ *  \param[in] test - unit tests indicator
+ *
+ *  \return  0 - in case of success
+ *          -1 - in case of some unexpected error
+ */
+int select_asset_element_basic_all(std::function<void(const tntdb::Row&)> cb, bool test)
+{
+    if (test)
+        return 0;
+    try {
+        tntdb::Connection conn = tntdb::connectCached(DBConn::url);
+        fty::CountedStatement st(conn.prepareCached(SQL_ASSET_ELEMENT_BASIC " ORDER BY a.id_asset_element "));
+
+        for (const auto& row : st.select()) {
+            cb(row);
+        }
+    } catch (const std::exception& e) {
+        log_error("exception caught %s while selecting all assets", e.what());
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ *  \brief Selects ext attributes of all assets in the DB at once
+ *         Columns: id_asset_element, keytag, value, read_only
+ *         Rows of one asset are contiguous and in insertion order.
+ *
+ *  \param[in] cb - function to call on each row
+ *  \param[in] test - unit tests indicator
+ *
+ *  \return  0 - in case of success
+ *          -1 - in case of some unexpected error
+ */
+int select_ext_attributes_all(std::function<void(const tntdb::Row&)> cb, bool test)
+{
+    if (test)
+        return 0;
+    try {
+        tntdb::Connection conn = tntdb::connectCached(DBConn::url);
+        fty::CountedStatement st(conn.prepareCached(
+            " SELECT "
+            "   e.id_asset_element, e.keytag, e.value, e.read_only "
+            " FROM "
+            "   t_bios_asset_ext_attributes AS e "
+            " ORDER BY e.id_asset_element, e.id_asset_ext_attribute "));
+
+        for (const auto& row : st.select()) {
+            cb(row);
+        }
+    } catch (const std::exception& e) {
+        log_error("exception caught %s while selecting all ext attributes", e.what());
+        return -1;
+    }
+    return 0;
+}
+
+// max number of values bound in one IN (...) clause, a power of two
+static const size_t SQL_IN_BATCH = 128;
+
+/**
+ *  \brief Runs query once per batch of values, <query> must contain one IN (%s) clause
+ *         which is completed with placeholders bound to the values.
+ *
+ *  \return  0 - in case of success
+ *          -1 - in case of some unexpected error
+ */
+template <typename T>
+static int s_select_in_batches(const std::string& query, const std::set<T>& values,
+    std::function<void(const tntdb::Row&)>& cb, const char* what)
+{
+    try {
+        tntdb::Connection conn = tntdb::connectCached(DBConn::url);
+
+        auto it = values.begin();
+        while (it != values.end()) {
+            size_t count = std::min(SQL_IN_BATCH, static_cast<size_t>(std::distance(it, values.end())));
+            // placeholders for the next power of two, padded with the last value, so that a few
+            // statements per query are cached whatever the number of values
+            size_t arity = 1;
+            while (arity < count) {
+                arity *= 2;
+            }
+
+            std::string placeholders;
+            for (size_t i = 0; i < arity; i++) {
+                placeholders.append(i ? ", :v" : ":v").append(std::to_string(i));
+            }
+            std::string sql = query;
+            sql.replace(sql.find("%s"), 2, placeholders);
+
+            fty::CountedStatement st(conn.prepareCached(sql));
+            auto                  last = it;
+            for (size_t i = 0; i < count; i++, ++it) {
+                st.set("v" + std::to_string(i), *it);
+                last = it;
+            }
+            for (size_t i = count; i < arity; i++) {
+                st.set("v" + std::to_string(i), *last);
+            }
+            for (const auto& row : st.select()) {
+                cb(row);
+            }
+        }
+    } catch (const std::exception& e) {
+        log_error("exception caught %s while selecting %s", e.what(), what);
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ *  \brief Selects basic asset info (as select_asset_element_basic_all) of the given assets,
+ *         with one query per SQL_IN_BATCH assets. Unknown names are ignored.
+ *
+ *  \param[in] names - inames of the assets
+ *  \param[in] cb - function to call on each row
+ *  \param[in] test - unit tests indicator
+ *
+ *  \return  0 - in case of success
+ *          -1 - in case of some unexpected error
+ */
+int select_asset_element_basic_by_names(
+    const std::set<std::string>& names, std::function<void(const tntdb::Row&)> cb, bool test)
+{
+    if (test)
+        return 0;
+    return s_select_in_batches(SQL_ASSET_ELEMENT_BASIC " WHERE a.name IN (%s) ORDER BY a.id_asset_element ", names,
+        cb, "assets by name");
+}
+
+/**
+ *  \brief Selects basic asset info (as select_asset_element_basic_all) of the given assets,
+ *         with one query per SQL_IN_BATCH assets. Unknown ids are ignored.
+ *
+ *  \param[in] ids - ids of the assets
+ *  \param[in] cb - function to call on each row
+ *  \param[in] test - unit tests indicator
+ *
+ *  \return  0 - in case of success
+ *          -1 - in case of some unexpected error
+ */
+int select_asset_element_basic_by_ids(
+    const std::set<uint32_t>& ids, std::function<void(const tntdb::Row&)> cb, bool test)
+{
+    if (test)
+        return 0;
+    return s_select_in_batches(SQL_ASSET_ELEMENT_BASIC " WHERE a.id_asset_element IN (%s) "
+                               " ORDER BY a.id_asset_element ", ids, cb, "assets by id");
+}
+
+#define SQL_ASSET_ELEMENT_PARENTS                                                                            \
+    " SELECT "                                                                                               \
+    "   a.name AS name, "                                                                                    \
+    "   a.id_parent AS id_parent, "                                                                          \
+    "   p1.name AS parent_name1, "                                                                           \
+    "   p2.name AS parent_name2, "                                                                           \
+    "   p3.name AS parent_name3, "                                                                           \
+    "   p4.name AS parent_name4, "                                                                           \
+    "   p5.name AS parent_name5, "                                                                           \
+    "   p6.name AS parent_name6, "                                                                           \
+    "   p7.name AS parent_name7, "                                                                           \
+    "   p8.name AS parent_name8, "                                                                           \
+    "   p9.name AS parent_name9, "                                                                           \
+    "   p10.name AS parent_name10 "                                                                          \
+    " FROM "                                                                                                 \
+    "   t_bios_asset_element AS a "                                                                          \
+    "   LEFT JOIN t_bios_asset_element AS p1 ON p1.id_asset_element = a.id_parent "                          \
+    "   LEFT JOIN t_bios_asset_element AS p2 ON p2.id_asset_element = p1.id_parent "                         \
+    "   LEFT JOIN t_bios_asset_element AS p3 ON p3.id_asset_element = p2.id_parent "                         \
+    "   LEFT JOIN t_bios_asset_element AS p4 ON p4.id_asset_element = p3.id_parent "                         \
+    "   LEFT JOIN t_bios_asset_element AS p5 ON p5.id_asset_element = p4.id_parent "                         \
+    "   LEFT JOIN t_bios_asset_element AS p6 ON p6.id_asset_element = p5.id_parent "                         \
+    "   LEFT JOIN t_bios_asset_element AS p7 ON p7.id_asset_element = p6.id_parent "                         \
+    "   LEFT JOIN t_bios_asset_element AS p8 ON p8.id_asset_element = p7.id_parent "                         \
+    "   LEFT JOIN t_bios_asset_element AS p9 ON p9.id_asset_element = p8.id_parent "                         \
+    "   LEFT JOIN t_bios_asset_element AS p10 ON p10.id_asset_element = p9.id_parent "
+
+/**
+ *  \brief Selects the parent id and the ancestors of the given assets, with one query per
+ *         SQL_IN_BATCH assets. Columns: name, id_parent, parent_name1 ... parent_name10
+ *         (nearest first, as v_bios_asset_element_super_parent), NULL above the topmost ancestor.
+ *         Unknown names are ignored.
+ *
+ *  \param[in] names - inames of the assets
+ *  \param[in] cb - function to call on each row
+ *  \param[in] test - unit tests indicator
+ *
+ *  \return  0 - in case of success
+ *          -1 - in case of some unexpected error
+ */
+int select_asset_element_parents_by_names(
+    const std::set<std::string>& names, std::function<void(const tntdb::Row&)> cb, bool test)
+{
+    if (test)
+        return 0;
+    return s_select_in_batches(SQL_ASSET_ELEMENT_PARENTS " WHERE a.name IN (%s) ", names, cb, "parents by name");
+}
+
+/**
+ *  \brief Selects ext attributes (as select_ext_attributes_all) of the given assets,
+ *         with one query per SQL_IN_BATCH assets
+ *
+ *  \param[in] ids - ids of the assets
+ *  \param[in] cb - function to call on each row
+ *  \param[in] test - unit tests indicator
+ *
+ *  \return  0 - in case of success
+ *          -1 - in case of some unexpected error
+ */
+int select_ext_attributes_by_ids(
+    const std::set<uint32_t>& ids, std::function<void(const tntdb::Row&)> cb, bool test)
+{
+    if (test)
+        return 0;
+    return s_select_in_batches(
+        " SELECT "
+        "   e.id_asset_element, e.keytag, e.value, e.read_only "
+        " FROM "
+        "   t_bios_asset_ext_attributes AS e "
+        " WHERE e.id_asset_element IN (%s) "
+        " ORDER BY e.id_asset_element, e.id_asset_ext_attribute ",
+        ids, cb, "ext attributes by asset id");
+}
+
+#define SQL_MISSING_UUID_CREATE_TS(where)                                                                    \
+    " SELECT "                                                                                               \
+    "   e.name AS name, "                                                                                    \
+    "   MAX(a.keytag = 'uuid') AS has_uuid, "                                                                \
+    "   MAX(a.keytag = 'create_ts') AS has_create_ts, "                                                      \
+    "   MAX(CASE WHEN a.keytag = 'manufacturer' THEN a.value END) AS manufacturer, "                         \
+    "   MAX(CASE WHEN a.keytag = 'model' THEN a.value END) AS model, "                                       \
+    "   MAX(CASE WHEN a.keytag = 'serial_no' THEN a.value END) AS serial_no "                                \
+    " FROM "                                                                                                 \
+    "   t_bios_asset_element AS e "                                                                          \
+    "   LEFT JOIN t_bios_asset_ext_attributes AS a "                                                         \
+    "   ON a.id_asset_element = e.id_asset_element " where                                                   \
+    " GROUP BY e.id_asset_element, e.name "                                                                  \
+    " HAVING NOT (COALESCE(has_uuid, 0) AND COALESCE(has_create_ts, 0)) "
+
+/**
+ *  \brief Selects assets missing uuid or create_ts ext attribute, in one query
+ *         Columns: name, has_uuid, has_create_ts, manufacturer, model, serial_no
+ *
+ *  \param[in] asset_name - iname of one asset, empty for all assets
+ *  \param[in] cb - function to call on each row
+ *  \param[in] test - unit tests indicator
+ *
+ *  \return  0 - in case of success
+ *          -1 - in case of some unexpected error
+ */
+int select_assets_missing_uuid_create_ts(
+    const std::string& asset_name, std::function<void(const tntdb::Row&)> cb, bool test)
+{
+    if (test)
+        return 0;
+    try {
+        tntdb::Connection conn = tntdb::connectCached(DBConn::url);
+        fty::CountedStatement st;
+        if (asset_name.empty()) {
+            st = fty::CountedStatement(conn.prepareCached(SQL_MISSING_UUID_CREATE_TS("")));
+        } else {
+            // one asset is looked up by the unique index on name
+            st = fty::CountedStatement(
+                conn.prepareCached(SQL_MISSING_UUID_CREATE_TS(" WHERE e.name = :name ")));
+            st.set("name", asset_name);
+        }
+
+        for (const auto& row : st.select()) {
+            cb(row);
+        }
+    } catch (const std::exception& e) {
+        log_error("exception caught %s while selecting assets missing uuid or create_ts", e.what());
+        return -1;
+    }
+    return 0;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 #define SQL_EXT_ATT_INVENTORY                                                                                \
@@ -168,6 +476,13 @@ int select_assets(std::function<void(const tntdb::Row&)>& cb, bool test)
     "       value = VALUES (value),"                                                                         \
     "       read_only = :readonly,"                                                                          \
     "       id_asset_ext_attribute = LAST_INSERT_ID(id_asset_ext_attribute)"
+// cached asset and encoded messages of an asset whose ext attributes were written
+static void s_inventory_written(const std::string& iname)
+{
+    fty::AssetImpl::invalidateStorageCache(iname);
+    fty::AssetMsgCache::invalidateAll(iname);
+}
+
 /**
  *  \brief Inserts ext attributes from inventory message into DB
  *
@@ -193,7 +508,7 @@ int process_insert_inventory(
     }
 
     tntdb::Transaction trans(conn);
-    tntdb::Statement   st = conn.prepareCached(SQL_EXT_ATT_INVENTORY);
+    fty::CountedStatement st(conn.prepareCached(SQL_EXT_ATT_INVENTORY));
 
     for (void* it = zhash_first(ext_attributes); it != NULL; it = zhash_next(ext_attributes)) {
 
@@ -222,6 +537,49 @@ int process_insert_inventory(
     }
 
     trans.commit();
+    // written outside of the asset storage, its cached copies are stale
+    s_inventory_written(device_name);
+    return 0;
+}
+
+/**
+ *  \brief Inserts ext attributes of several assets into DB in a single transaction
+ *
+ *  \param[in] ext_attributes - keytag/value of ext attributes by iname of asset
+ *  \param[in] read_only - whether to insert ext attributes as readonly
+ *  \param[in] test - unit tests indicator
+ *
+ *  \return  0 - in case of success
+ *          -1 - in case of some unexpected error, nothing is inserted
+ */
+int process_insert_inventory_batch(
+    const std::map<std::string, std::map<std::string, std::string>>& ext_attributes, bool readonly, bool test)
+{
+    if (test || ext_attributes.empty())
+        return 0;
+    try {
+        tntdb::Connection  conn = tntdb::connectCached(DBConn::url);
+        tntdb::Transaction trans(conn);
+        fty::CountedStatement st(conn.prepareCached(SQL_EXT_ATT_INVENTORY));
+
+        for (const auto& asset : ext_attributes) {
+            for (const auto& it : asset.second) {
+                st.set("keytag", it.first)
+                    .set("value", it.second)
+                    .set("device_name", asset.first)
+                    .set("readonly", readonly)
+                    .execute();
+            }
+        }
+        trans.commit();
+    } catch (const std::exception& e) {
+        log_error("exception caught %s while inserting ext attributes of %zu assets", e.what(),
+            ext_attributes.size());
+        return -1;
+    }
+    for (const auto& asset : ext_attributes) {
+        s_inventory_written(asset.first);
+    }
     return 0;
 }
 
@@ -253,7 +611,7 @@ int process_insert_inventory(const std::string& device_name, zhash_t* ext_attrib
     }
 
     tntdb::Transaction trans(conn);
-    tntdb::Statement   st = conn.prepareCached(SQL_EXT_ATT_INVENTORY);
+    fty::CountedStatement st(conn.prepareCached(SQL_EXT_ATT_INVENTORY));
 
     for (void* it = zhash_first(ext_attributes); it != NULL; it = zhash_next(ext_attributes)) {
         const char* value     = static_cast<const char*>(it);
@@ -282,6 +640,7 @@ int process_insert_inventory(const std::string& device_name, zhash_t* ext_attrib
     }
 
     trans.commit();
+    s_inventory_written(device_name);
     return 0;
 }
 /**
@@ -306,13 +665,13 @@ int select_ename_from_iname(std::string& iname, std::string& ename, bool test)
     try {
 
         tntdb::Connection conn = tntdb::connectCached(DBConn::url);
-        tntdb::Statement  st   = conn.prepareCached(
+        fty::CountedStatement st(conn.prepareCached(
             "SELECT e.value FROM  t_bios_asset_ext_attributes AS e "
             "INNER JOIN t_bios_asset_element AS a "
             "ON a.id_asset_element = e.id_asset_element "
             "WHERE keytag = 'name' and a.name = :iname; "
 
-        );
+        ));
 
         tntdb::Row row = st.set("iname", iname).selectRow();
         log_debug("[s_handle_subject_ename_from_iname]: were selected %" PRIu32 " rows", 1);
@@ -345,6 +704,7 @@ int get_active_power_devices(bool test)
         }
         return count;
     }
+    fty::RequestStats::countDbQuery();
     tntdb::Connection conn = tntdb::connectCached(DBConn::url);
     return DBAssets::get_active_power_devices(conn);
 }
@@ -89,8 +89,56 @@ int main (int argc, char *argv [])
     zsock_wait (asset_server);
     zstr_sendx (asset_server, "CONSUMER", "LICENSING-ANNOUNCEMENTS", ".*", NULL);
     zsock_wait (asset_server);
+    // number of workers handling read-only mailbox requests
+    char *workers = getenv("BIOS_ASSETS_WORKERS");
+    if (workers) {
+        zstr_sendx (asset_server, "WORKERS", workers, NULL);
+        zsock_wait (asset_server);
+    }
+    // number of database connections used at once by the asset requests
+    char *db_pool = getenv("BIOS_ASSETS_DB_POOL");
+    if (db_pool) {
+        zstr_sendx (asset_server, "DB_POOL", db_pool, NULL);
+        zsock_wait (asset_server);
+    }
+    // memory in MB used to keep assets read from the database, unset or 0 disables the cache
+    char *storage_cache = getenv("BIOS_ASSETS_CACHE_MB");
+    if (storage_cache) {
+        zstr_sendx (asset_server, "STORAGE_CACHE", storage_cache, NULL);
+        zsock_wait (asset_server);
+    }
     zstr_sendx (asset_server, "CONNECTMAILBOX", endpoint, NULL);
     zsock_wait (asset_server);
+
+    // set up how ofter assets should be repeated
+    char *repeat_interval = getenv("BIOS_ASSETS_REPEAT");
+    int repeat_interval_s = repeat_interval ? std::stoi (repeat_interval) : 60*60;
+    zstr_sendx (asset_server, "REPEAT_INTERVAL", std::to_string (repeat_interval_s).c_str (), NULL);
+    zsock_wait (asset_server);
+
+    // how many assets per second are republished, 0 means as fast as possible
+    char *repeat_rate = getenv("BIOS_ASSETS_REPEAT_RATE");
+    if (repeat_rate) {
+        zstr_sendx (asset_server, "REPEAT_RATE", repeat_rate, NULL);
+        zsock_wait (asset_server);
+    }
+
+    // every Nth periodic republish sends all assets, the others only assets which changed
+    char *repeat_full_cycle = getenv("BIOS_ASSETS_REPEAT_FULL_CYCLE");
+    if (repeat_full_cycle) {
+        zstr_sendx (asset_server, "REPEAT_FULL_CYCLE", repeat_full_cycle, NULL);
+        zsock_wait (asset_server);
+    }
+
+    // how long (ms) container updates are collected before their contents are republished
+    char *topology_window = getenv("BIOS_ASSETS_TOPOLOGY_WINDOW");
+    if (topology_window) {
+        zstr_sendx (asset_server, "TOPOLOGY_WINDOW", topology_window, NULL);
+        zsock_wait (asset_server);
+    }
+    // store uuid and create_ts of assets missing them, so republishing does not write in DB
+    zstr_sendx (asset_server, "BACKFILL", NULL);
+    zsock_wait (asset_server);
     zstr_sendx (asset_server, "REPEAT_ALL", NULL);
 
     zactor_t *autoupdate_server = zactor_new (fty_asset_autoupdate_server, static_cast<void*>( const_cast<char*>("asset-autoupdate")));
@@ -101,10 +149,6 @@ int main (int argc, char *argv [])
     zstr_sendx (autoupdate_server, "ASSET_AGENT_NAME", "asset-agent", NULL);
     zstr_sendx (autoupdate_server, "WAKEUP", NULL);
 
-    // set up how ofter assets should be repeated
-    char *repeat_interval = getenv("BIOS_ASSETS_REPEAT");
-    int repeat_interval_s = repeat_interval ? std::stoi (repeat_interval) : 60*60;
-
     zactor_t *inventory_server = zactor_new (fty_asset_inventory_server, static_cast<void*>( const_cast<char*>("asset-inventory")));
     zstr_sendx (inventory_server, "CONNECT", endpoint, NULL);
     zsock_wait (inventory_server);
@@ -186,6 +186,23 @@
                  A = "ERROR" - mandatory
                  B = "BAD_COMMAND"/"INTERNAL_ERROR"/"ASSET_NOT_FOUND" - mandatory
 
+     ------------------------------------------------------------------------
+     ## STATS
+
+     request statistics of the requests handled so far:
+         subject: "STATS"
+         message: is an empty message or a string message A
+                 A = "RESET" - optional, statistics are cleared after the reply
+
+     reply:
+         subject: "STATS"
+         message: is a multipart message A/B1/.../Bn
+                 A = "OK" - mandatory
+                 B = one string per subject:
+                     "<subject> count=<n> p50=<us> p90=<us> p99=<us> max=<us> db=<n>"
+                     latencies are in microseconds (within 12.5%), db is the number of
+                     DB queries of all the requests of the subject
+
 
 @end
 */
@@ -193,10 +210,24 @@
 #include "fty_asset_autoupdate.h"
 
 #include "asset-server.h"
+#include "asset/asset-db-cache.h"
+#include "asset/asset-db-test.h"
+#include "asset/asset-db.h"
 #include "asset/asset-utils.h"
+#include "asset/connection-pool.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cinttypes>
+#include <chrono>
+#include <condition_variable>
 #include <ctime>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
 #include <string>
+#include <thread>
 
 #include <fty_asset_dto.h>
 #include <fty_common.h>
@@ -205,6 +236,9 @@
 #include <functional>
 #include <malamute.h>
 #include <mlm_client.h>
+#include <fstream>
+#include <sstream>
+#include <sys/resource.h>
 #include <sys/time.h>
 #include <tntdb/connect.h>
 #include <fty_common.h>
@@ -216,8 +250,13 @@
 #include "total_power.h"
 #include "asset/dbhelpers.h"
 
+#include "asset-stream-data.h"
 #include "topology_processor.h"
 #include "topology_power.h"
+#include "mailbox-worker-pool.h"
+#include "republish-scheduler.h"
+#include "request-stats.h"
+#include "topology-coalescer.h"
 
 #include <cassert>
 
@@ -424,6 +463,14 @@ static void s_process_TopologyInputPowerchain(
     }
 }
 
+// sends mailbox messages through client, as the workers do through the owner's client
+static fty::MailboxWorkerPool::Send s_mailbox_send(mlm_client_t* client)
+{
+    return [client](const char* address, const char* subject, zmsg_t** msg) -> int {
+        return mlm_client_sendto(client, address, subject, NULL, 5000, msg);
+    };
+}
+
 // =============================================================================
 //         Functionality for TOPOLOGY processing
 // =============================================================================
@@ -434,7 +481,8 @@ static void s_process_TopologyInputPowerchain(
 // bmsg request asset-agent TOPOLOGY REQUEST <uuid> INPUT_POWERCHAIN <assetID>
 // =============================================================================
 
-static void s_handle_subject_topology(const fty::AssetServer& server, zmsg_t* msg)
+static void s_handle_subject_topology(
+    const fty::AssetServer& server, const fty::MailboxWorkerPool::Send& send, const char* sender, zmsg_t* msg)
 {
     assert (msg);
 
@@ -502,9 +550,7 @@ static void s_handle_subject_topology(const fty::AssetServer& server, zmsg_t* ms
         }
 
         // send reply
-        int r = mlm_client_sendto(const_cast<mlm_client_t*>(server.getMailboxClient()),
-            mlm_client_sender(const_cast<mlm_client_t*>(server.getMailboxClient())), "TOPOLOGY", NULL, 5000,
-            &reply);
+        int r = send(sender, "TOPOLOGY", &reply);
         if (r != 0) {
             log_error("%s:\tTOPOLOGY %s: cannot send response message", command, client_name.c_str());
         }
@@ -516,7 +562,8 @@ static void s_handle_subject_topology(const fty::AssetServer& server, zmsg_t* ms
     zstr_free(&message_type);
 }
 
-static void s_handle_subject_assets_in_container(const fty::AssetServer& server, zmsg_t* msg)
+static void s_handle_subject_assets_in_container(
+    const fty::AssetServer& server, const fty::MailboxWorkerPool::Send& send, const char* sender, zmsg_t* msg)
 {
     assert (msg);
 
@@ -569,9 +616,7 @@ static void s_handle_subject_assets_in_container(const fty::AssetServer& server,
     }
 
     // send the reply
-    rv = mlm_client_sendto(const_cast<mlm_client_t*>(server.getMailboxClient()),
-        mlm_client_sender(const_cast<mlm_client_t*>(server.getMailboxClient())), "ASSETS_IN_CONTAINER", NULL,
-        5000, &reply);
+    rv = send(sender, "ASSETS_IN_CONTAINER", &reply);
 
     if (rv == -1) {
         log_error("%s:\tASSETS_IN_CONTAINER: mlm_client_sendto failed", client_name.c_str());
@@ -580,7 +625,8 @@ static void s_handle_subject_assets_in_container(const fty::AssetServer& server,
     zmsg_destroy(&reply);
 }
 
-static void s_handle_subject_ename_from_iname(const fty::AssetServer& server, zmsg_t* msg)
+static void s_handle_subject_ename_from_iname(
+    const fty::AssetServer& server, const fty::MailboxWorkerPool::Send& send, const char* sender, zmsg_t* msg)
 {
     assert (msg);
 
@@ -591,9 +637,7 @@ static void s_handle_subject_ename_from_iname(const fty::AssetServer& server, zm
         log_error("%s:\tENAME_FROM_INAME: incoming message have less than 1 frame", client_name.c_str());
         zmsg_addstr(reply, "ERROR");
         zmsg_addstr(reply, "MISSING_INAME");
-        mlm_client_sendto(const_cast<mlm_client_t*>(server.getMailboxClient()),
-            mlm_client_sender(const_cast<mlm_client_t*>(server.getMailboxClient())), "ENAME_FROM_INAME", NULL,
-            5000, &reply);
+        send(sender, "ENAME_FROM_INAME", &reply);
         zmsg_destroy(&reply);
         return;
     }
@@ -613,9 +657,7 @@ static void s_handle_subject_ename_from_iname(const fty::AssetServer& server, zm
         zmsg_addstr(reply, ename.c_str());
     }
 
-    [[maybe_unused]] int rv = mlm_client_sendto(const_cast<mlm_client_t*>(server.getMailboxClient()),
-        mlm_client_sender(const_cast<mlm_client_t*>(server.getMailboxClient())), "ENAME_FROM_INAME", NULL,
-        5000, &reply);
+    [[maybe_unused]] int rv = send(sender, "ENAME_FROM_INAME", &reply);
 
     if (rv == -1) {
         log_error("%s:\tENAME_FROM_INAME: mlm_client_sendto failed", client_name.c_str());
@@ -624,7 +666,8 @@ static void s_handle_subject_ename_from_iname(const fty::AssetServer& server, zm
     zmsg_destroy(&reply);
 }
 
-static void s_handle_subject_assets(const fty::AssetServer& server, zmsg_t* msg)
+static void s_handle_subject_assets(
+    const fty::AssetServer& server, const fty::MailboxWorkerPool::Send& send, const char* sender, zmsg_t* msg)
 {
     assert (msg);
 
@@ -636,9 +679,7 @@ static void s_handle_subject_assets(const fty::AssetServer& server, zmsg_t* msg)
         zmsg_addstr(reply, "0");
         zmsg_addstr(reply, "ERROR");
         zmsg_addstr(reply, "MISSING_COMMAND");
-        mlm_client_sendto(const_cast<mlm_client_t*>(server.getMailboxClient()),
-            mlm_client_sender(const_cast<mlm_client_t*>(server.getMailboxClient())), "ASSETS", NULL, 5000,
-            &reply);
+        send(sender, "ASSETS", &reply);
         zmsg_destroy(&reply);
         return;
     }
@@ -651,9 +692,7 @@ static void s_handle_subject_assets(const fty::AssetServer& server, zmsg_t* msg)
             zmsg_addstr(reply, uuid);
         zmsg_addstr(reply, "ERROR");
         zmsg_addstr(reply, "BAD_COMMAND");
-        mlm_client_sendto(const_cast<mlm_client_t*>(server.getMailboxClient()),
-            mlm_client_sender(const_cast<mlm_client_t*>(server.getMailboxClient())), "ASSETS", NULL, 5000,
-            &reply);
+        send(sender, "ASSETS", &reply);
         zstr_free(&c_command);
         zstr_free(&uuid);
         zmsg_destroy(&reply);
@@ -691,9 +730,7 @@ static void s_handle_subject_assets(const fty::AssetServer& server, zmsg_t* msg)
     }
 
     // send the reply
-    rv = mlm_client_sendto(const_cast<mlm_client_t*>(server.getMailboxClient()),
-        mlm_client_sender(const_cast<mlm_client_t*>(server.getMailboxClient())), "ASSETS", NULL, 5000,
-        &reply);
+    rv = send(sender, "ASSETS", &reply);
 
     if (rv == -1) {
         log_error("%s:\tASSETS: mlm_client_sendto failed", client_name.c_str());
@@ -703,10 +740,73 @@ static void s_handle_subject_assets(const fty::AssetServer& server, zmsg_t* msg)
     zmsg_destroy(&reply);
 }
 
-static zmsg_t* s_publish_create_or_update_asset_msg(const std::string& client_name,
-    const std::string& asset_name, const char* operation, std::string& subject, bool test_mode,
-    bool /*read_only*/)
+// uuid and create_ts of an asset missing them: uuid is calculated from manufacturer, model and serial number
+// when they are all known, random otherwise, create_ts is the current local time
+static std::map<std::string, std::string> s_generate_uuid_create_ts(
+    const std::string& mfr, const std::string& model, const std::string& serial, bool uuid, bool create_ts)
+{
+    std::map<std::string, std::string> ext;
+
+    if (uuid) {
+        fty_uuid_t* generator = fty_uuid_new();
+        if (!serial.empty() && !model.empty() && !mfr.empty()) {
+            ext["uuid"] = fty_uuid_calculate(generator, mfr.c_str(), model.c_str(), serial.c_str());
+        } else {
+            ext["uuid"] = fty_uuid_generate(generator);
+        }
+        fty_uuid_destroy(&generator);
+    }
+
+    if (create_ts) {
+        std::time_t timestamp = std::time(NULL);
+        char        mbstr[100];
+
+        std::strftime(mbstr, sizeof(mbstr), "%FT%T%z", std::localtime(&timestamp));
+        ext["create_ts"] = mbstr;
+    }
+    return ext;
+}
+
+// Stores uuid and create_ts of all assets (or of asset_name only) missing them, in one transaction.
+// Returns the number of assets updated, -1 on error.
+static int s_backfill_uuid_create_ts(const std::string& client_name, const std::string& asset_name, bool test_mode)
 {
+    std::map<std::string, std::map<std::string, std::string>> ext_new;
+
+    int rv = select_assets_missing_uuid_create_ts(asset_name,
+        [&ext_new](const tntdb::Row& row) {
+            std::string name, mfr, model, serial;
+            bool        has_uuid = false, has_create_ts = false;
+            row["name"].get(name);
+            row["has_uuid"].get(has_uuid);
+            row["has_create_ts"].get(has_create_ts);
+            row["manufacturer"].get(mfr);
+            row["model"].get(model);
+            row["serial_no"].get(serial);
+
+            ext_new[name] = s_generate_uuid_create_ts(mfr, model, serial, !has_uuid, !has_create_ts);
+        },
+        test_mode);
+    if (rv != 0) {
+        log_error("%s:\tCannot select assets missing uuid or create_ts", client_name.c_str());
+        return -1;
+    }
+
+    if (process_insert_inventory_batch(ext_new, true, test_mode) != 0) {
+        log_error("%s:\tCannot store uuid and create_ts of %zu assets", client_name.c_str(), ext_new.size());
+        return -1;
+    }
+    if (!ext_new.empty()) {
+        log_info("%s:\tuuid and create_ts stored for %zu assets", client_name.c_str(), ext_new.size());
+    }
+    return static_cast<int>(ext_new.size());
+}
+
+static zmsg_t* s_encode_asset_msg(const std::string& client_name, AssetStreamData& data, const char* operation,
+    std::string& subject, bool test_mode)
+{
+    const std::string& asset_name = data.name;
+
     zhash_t* aux = zhash_new();
     zhash_t* ext = zhash_new();
     if (!(aux && ext)) {
@@ -718,175 +818,229 @@ static zmsg_t* s_publish_create_or_update_asset_msg(const std::string& client_na
     zhash_autofree(aux);
     zhash_autofree(ext);
 
-    uint32_t asset_id = 0;
-
-    std::function<void(const tntdb::Row&)> cb1 = [aux, &asset_id, asset_name](const tntdb::Row& row) {
-        int foo_i = 0;
-        row["priority"].get(foo_i);
-        zhash_insert(aux, "priority", static_cast<void*>(const_cast<char*>(std::to_string(foo_i).c_str())));
-
-        foo_i = 0;
-        row["id_type"].get(foo_i);
-        zhash_insert(aux, "type", static_cast<void*>(const_cast<char*>(persist::typeid_to_type(static_cast<uint16_t>(foo_i)).c_str())));
+    // keep insertion order of the former per-asset callbacks, so messages stay the same
+    if (data.found) {
+        const std::string type = persist::typeid_to_type(static_cast<uint16_t>(data.typeId));
+        zhash_insert(aux, "priority", static_cast<void*>(const_cast<char*>(std::to_string(data.priority).c_str())));
+        zhash_insert(aux, "type", static_cast<void*>(const_cast<char*>(type.c_str())));
 
         // additional aux items (requiered by uptime)
-        if (streq(persist::typeid_to_type(static_cast<uint16_t>(foo_i)).c_str(), "datacenter")) {
+        if (type == "datacenter") {
             if (!DBUptime::get_dc_upses(asset_name.c_str(), aux))
                 log_error("Cannot read upses for dc with id = %s", asset_name.c_str());
         }
-        foo_i = 0;
-        row["subtype_id"].get(foo_i);
-        zhash_insert(aux, "subtype", static_cast<void*>( const_cast<char*>(persist::subtypeid_to_subtype(static_cast<uint16_t>(foo_i)).c_str())));
+        zhash_insert(aux, "subtype", static_cast<void*>(const_cast<char*>(
+            persist::subtypeid_to_subtype(static_cast<uint16_t>(data.subtypeId)).c_str())));
+        zhash_insert(aux, "parent", static_cast<void*>(const_cast<char*>(std::to_string(data.parentId).c_str())));
+        zhash_insert(aux, "status", static_cast<void*>(const_cast<char*>(data.status.c_str())));
+    }
 
-        foo_i = 0;
-        row["id_parent"].get(foo_i);
-        zhash_insert(aux, "parent", static_cast<void*>( const_cast<char*>(std::to_string(foo_i).c_str())));
+    for (const auto& it : data.ext) {
+        zhash_insert(ext, it.first.c_str(), static_cast<void*>(const_cast<char*>(it.second.c_str())));
+    }
 
-        std::string foo_s;
-        row["status"].get(foo_s);
-        zhash_insert(aux, "status", static_cast<void*>( const_cast<char*>(foo_s.c_str())));
+    // uuid and create_ts are not generated here, see s_backfill_uuid_create_ts(), publishing only reads the DB
 
-        row["id"].get(asset_id);
+    // "physical topology"
+    for (size_t i = 0; i < data.parents.size() && i < ASSET_STREAM_MAX_PARENTS; ++i) {
+        if (!data.parents[i].empty()) {
+            std::string hash_name = "parent_name." + std::to_string(i + 1);
+            zhash_insert(aux, hash_name.c_str(), static_cast<void*>(const_cast<char*>(data.parents[i].c_str())));
+        }
+    }
+
+    // other information like, groups, power chain for now are not included in the message
+    const char* type    = static_cast<const char*>(zhash_lookup(aux, "type"));
+    const char* subtype = static_cast<const char*>(zhash_lookup(aux, "subtype"));
+
+    subject = (type == NULL) ? "unknown" : type;
+    subject.append(".");
+    subject.append((subtype == NULL) ? "unknown" : subtype);
+    subject.append("@");
+    subject.append(asset_name);
+    log_debug("notifying ASSETS %s %s ..", operation, subject.c_str());
+
+    zmsg_t* msg = fty_proto_encode_asset(aux, asset_name.c_str(), operation, ext);
+
+    zhash_destroy(&ext);
+    zhash_destroy(&aux);
+
+    return msg;
+}
+
+static zmsg_t* s_publish_create_or_update_asset_msg(const std::string& client_name,
+    const std::string& asset_name, const char* operation, std::string& subject, bool test_mode,
+    bool /*read_only*/, fty::AssetMsgCache* cache = NULL)
+{
+    uint64_t generation = 0;
+    if (cache) {
+        zmsg_t* msg = cache->get(asset_name, operation, subject);
+        if (msg) {
+            return msg;
+        }
+        generation = cache->generation();
+    }
+
+    AssetStreamData data;
+    data.name = asset_name;
+
+    std::function<void(const tntdb::Row&)> cb1 = [&data](const tntdb::Row& row) {
+        fill_asset_stream_basic(data, row);
     };
 
     // select basic info
     [[maybe_unused]] int rv = select_asset_element_basic(asset_name, cb1, test_mode);
     if (rv != 0) {
         log_warning("%s:\tCannot select info about '%s'", client_name.c_str(), asset_name.c_str());
-        zhash_destroy(&aux);
-        zhash_destroy(&ext);
         return NULL;
     }
 
-    std::function<void(const tntdb::Row&)> cb2 = [ext](const tntdb::Row& row) {
+    std::function<void(const tntdb::Row&)> cb2 = [&data](const tntdb::Row& row) {
         std::string keytag;
         row["keytag"].get(keytag);
         std::string value;
         row["value"].get(value);
-        zhash_insert(ext, keytag.c_str(), static_cast<void*>( const_cast<char*>(value.c_str())));
+        data.ext.emplace_back(keytag, value);
     };
 
     // select ext attributes
-    rv = select_ext_attributes(asset_id, cb2, test_mode);
+    rv = select_ext_attributes(data.id, cb2, test_mode);
     if (rv != 0) {
         log_warning("%s:\tCannot select ext attributes for '%s'", client_name.c_str(), asset_name.c_str());
-        zhash_destroy(&aux);
-        zhash_destroy(&ext);
         return NULL;
     }
 
-    // create uuid ext attribute if missing
-    if (!zhash_lookup(ext, "uuid")) {
-        const char* serial = static_cast<const char*>(zhash_lookup(ext, "serial_no"));
-        const char* model  = static_cast<const char*>(zhash_lookup(ext, "model"));
-        const char* mfr    = static_cast<const char*>(zhash_lookup(ext, "manufacturer"));
-        const char* type   = static_cast<const char*>(zhash_lookup(aux, "type"));
-        if (!type)
-            type = "";
-
-        fty_uuid_t* uuid = fty_uuid_new();
-        zhash_t* ext_new = zhash_new();
-
-        if (serial && model && mfr) {
-            // we have all information => create uuid
-            const char* uuid_new = fty_uuid_calculate(uuid, mfr, model, serial);
-            zhash_insert(ext, "uuid", static_cast<void*>( const_cast<char*>(uuid_new)));
-            zhash_insert(ext_new, "uuid", static_cast<void*>( const_cast<char*>(uuid_new)));
-
-            process_insert_inventory(asset_name.c_str(), ext_new, true, test_mode);
-        }
-        else {
-            // generate random uuid and save it
-            const char* uuid_new = fty_uuid_generate(uuid);
-            zhash_insert(ext, "uuid", static_cast<void*>( const_cast<char*>(uuid_new)));
-            zhash_insert(ext_new, "uuid", static_cast<void*>( const_cast<char*>(uuid_new)));
-
-            process_insert_inventory(asset_name.c_str(), ext_new, true, test_mode);
-        }
-
-        fty_uuid_destroy(&uuid);
-        zhash_destroy(&ext_new);
-    }
-
-    // create timestamp ext attribute if missing
-    if (!zhash_lookup(ext, "create_ts")) {
-        zhash_t* ext_new = zhash_new();
-
-        std::time_t timestamp = std::time(NULL);
-        char        mbstr[100];
-
-        std::strftime(mbstr, sizeof(mbstr), "%FT%T%z", std::localtime(&timestamp));
-
-        zhash_insert(ext, "create_ts", static_cast<void*>( const_cast<char*>(mbstr)));
-        zhash_insert(ext_new, "create_ts", static_cast<void*>( const_cast<char*>(mbstr)));
-
-        process_insert_inventory(asset_name.c_str(), ext_new, true, test_mode);
-
-        zhash_destroy(&ext_new);
-    }
-
-    std::function<void(const tntdb::Row&)> cb3 = [aux](const tntdb::Row& row) {
+    std::function<void(const tntdb::Row&)> cb3 = [&data](const tntdb::Row& row) {
+        data.parents.clear();
         for (const auto& name :
             {"parent_name1", "parent_name2", "parent_name3", "parent_name4", "parent_name5", "parent_name6",
                 "parent_name7", "parent_name8", "parent_name9", "parent_name10"}) {
             std::string foo;
             row[name].get(foo);
-            std::string hash_name = name;
-            //                11 == strlen ("parent_name")
-            hash_name.insert(11, 1, '.');
-            if (!foo.empty())
-                zhash_insert(aux, hash_name.c_str(), static_cast<void*>( const_cast<char*>(foo.c_str())));
+            data.parents.push_back(foo);
         }
     };
 
     // select "physical topology"
-    rv = select_asset_element_super_parent(asset_id, cb3, test_mode);
+    rv = select_asset_element_super_parent(data.id, cb3, test_mode);
     if (rv != 0) {
-        zhash_destroy(&aux);
-        zhash_destroy(&ext);
         log_error(
             "%s:\tselect_asset_element_super_parent ('%s') failed.", client_name.c_str(), asset_name.c_str());
         return NULL;
     }
 
-    // other information like, groups, power chain for now are not included in the message
-    const char* type = static_cast<const char*>(zhash_lookup(aux, "type"));
-    const char* subtype = static_cast<const char*>(zhash_lookup(aux, "subtype"));
-
-    subject = (type == NULL) ? "unknown" : type;
-    subject.append(".");
-    subject.append((subtype == NULL) ? "unknown" : subtype);
-    subject.append("@");
-    subject.append(asset_name);
-    log_debug("notifying ASSETS %s %s ..", operation, subject.c_str());
-
-    zmsg_t* msg = fty_proto_encode_asset(aux, asset_name.c_str(), operation, ext);
+    zmsg_t* msg = s_encode_asset_msg(client_name, data, operation, subject, test_mode);
+    // missing assets are not cached
+    if (msg && data.found && cache) {
+        cache->put(asset_name, operation, subject, msg, generation);
+    }
+    return msg;
+}
 
-    zhash_destroy(&ext);
-    zhash_destroy(&aux);
+// Hash of an encoded ASSETS stream message, used to skip unchanged assets on periodic republish
+static size_t s_asset_msg_hash(const std::string& subject, zmsg_t* msg)
+{
+    std::string content = subject;
+    for (zframe_t* frame = zmsg_first(msg); frame != NULL; frame = zmsg_next(msg)) {
+        content.append(reinterpret_cast<const char*>(zframe_data(frame)), zframe_size(frame));
+    }
+    return std::hash<std::string>{}(content);
+}
 
-    return msg;
+// Stream data of an asset already in memory, but its parent id and ancestors
+static void s_asset_stream_data(const fty::Asset& asset, AssetStreamData& data)
+{
+    data.found     = true;
+    data.name      = asset.getInternalName();
+    data.priority  = asset.getPriority();
+    data.typeId    = persist::type_to_typeid(asset.getAssetType());
+    data.subtypeId = persist::subtype_to_subtypeid(asset.getAssetSubtype());
+    data.status    = fty::assetStatusToString(asset.getAssetStatus());
+    for (const auto& it : asset.getExt()) {
+        data.ext.emplace_back(it.first, it.second.getValue());
+    }
+    data.parents.assign(ASSET_STREAM_MAX_PARENTS, "");
 }
 
-void send_create_or_update_asset(
-    const fty::AssetServer& server, const std::string& asset_name, const char* operation, bool read_only)
+static void s_send_asset_msg(
+    const fty::AssetServer& server, const std::string& asset_name, const std::string& subject, zmsg_t* msg)
 {
-    std::string subject;
-    auto        msg = s_publish_create_or_update_asset_msg(
-        server.getAgentName(), asset_name, operation, subject, server.getTestMode(), read_only);
+    // hash is computed before sending, as sending destroys the message
+    size_t hash = msg ? s_asset_msg_hash(subject, msg) : 0;
     if (NULL == msg ||
         0 != mlm_client_send(const_cast<mlm_client_t*>(server.getStreamClient()), subject.c_str(), &msg)) {
         log_info("%s:\tmlm_client_send not sending message for asset '%s'", server.getAgentName().c_str(),
             asset_name.c_str());
+        zmsg_destroy(&msg);
+        return;
+    }
+    server.updatePublishedHash(asset_name, hash);
+}
+
+void send_create_or_update_asset(
+    const fty::AssetServer& server, const std::string& asset_name, const char* operation, bool read_only)
+{
+    std::string subject;
+    auto        msg = s_publish_create_or_update_asset_msg(server.getAgentName(), asset_name, operation, subject,
+        server.getTestMode(), read_only, &server.getMsgCache());
+    s_send_asset_msg(server, asset_name, subject, msg);
+}
+
+// Same for assets just created or updated: they are not read back from the DB, only their parent ids and
+// ancestors with one query per batch of names; their messages are cached for the ASSET_DETAIL requests
+// that usually follow a notification
+void send_create_or_update_assets(
+    const fty::AssetServer& server, const std::vector<const fty::Asset*>& assets, const char* operation)
+{
+    if (assets.empty()) {
+        return;
+    }
+
+    fty::AssetMsgCache& cache      = server.getMsgCache();
+    uint64_t            generation = cache.generation();
+
+    std::map<std::string, AssetStreamData> data;
+    std::set<std::string>                  names;
+    for (const auto* asset : assets) {
+        names.insert(asset->getInternalName());
+        s_asset_stream_data(*asset, data[asset->getInternalName()]);
+    }
+
+    std::function<void(const tntdb::Row&)> cb = [&data](const tntdb::Row& row) {
+        std::string name;
+        row["name"].get(name);
+        auto it = data.find(name);
+        if (it == data.end()) {
+            return;
+        }
+        row["id_parent"].get(it->second.parentId);
+        for (size_t i = 0; i < ASSET_STREAM_MAX_PARENTS; ++i) {
+            row["parent_name" + std::to_string(i + 1)].get(it->second.parents[i]);
+        }
+    };
+    if (select_asset_element_parents_by_names(names, cb, server.getTestMode()) != 0) {
+        log_error("%s:\tCannot select parents of %zu assets", server.getAgentName().c_str(), names.size());
+        return;
+    }
+
+    // in notification order
+    for (const auto* asset : assets) {
+        AssetStreamData& asset_data = data[asset->getInternalName()];
+        std::string      subject;
+        zmsg_t* msg = s_encode_asset_msg(server.getAgentName(), asset_data, operation, subject, server.getTestMode());
+        if (msg) {
+            cache.put(asset_data.name, operation, subject, msg, generation);
+        }
+        s_send_asset_msg(server, asset_data.name, subject, msg);
     }
 }
 
-static void s_sendto_create_or_update_asset(const fty::AssetServer& server, const std::string& asset_name,
-    const char* operation, const char* address, const char* uuid)
+static void s_sendto_create_or_update_asset(const fty::AssetServer& server, const fty::MailboxWorkerPool::Send& send,
+    const std::string& asset_name, const char* operation, const char* address, const char* uuid)
 {
     std::string subject;
-    auto        msg = s_publish_create_or_update_asset_msg(
-        server.getAgentName(), asset_name, operation, subject, server.getTestMode(), false);
+    auto        msg = s_publish_create_or_update_asset_msg(server.getAgentName(), asset_name, operation, subject,
+        server.getTestMode(), false, &server.getMsgCache());
     if (NULL == msg) {
         msg = zmsg_new();
         log_error("%s:\tASSET_DETAIL: asset not found", server.getAgentName().c_str());
@@ -894,15 +1048,15 @@ static void s_sendto_create_or_update_asset(const fty::AssetServer& server, cons
         zmsg_addstr(msg, "ASSET_NOT_FOUND");
     }
     zmsg_pushstr(msg, uuid);
-    [[maybe_unused]] int rv = mlm_client_sendto(
-        const_cast<mlm_client_t*>(server.getMailboxClient()), address, subject.c_str(), NULL, 5000, &msg);
+    [[maybe_unused]] int rv = send(address, subject.c_str(), &msg);
     if (rv != 0) {
         log_error(
             "%s:\tmlm_client_send failed for asset '%s'", server.getAgentName().c_str(), asset_name.c_str());
     }
 }
 
-static void s_handle_subject_asset_detail(const fty::AssetServer& server, zmsg_t** zmessage_p)
+static void s_handle_subject_asset_detail(
+    const fty::AssetServer& server, const fty::MailboxWorkerPool::Send& send, const char* sender, zmsg_t** zmessage_p)
 {
     if (!zmessage_p || !*zmessage_p)
         return;
@@ -918,9 +1072,7 @@ static void s_handle_subject_asset_detail(const fty::AssetServer& server, zmsg_t
             zmsg_addstr(reply, uuid);
         zmsg_addstr(reply, "ERROR");
         zmsg_addstr(reply, "BAD_COMMAND");
-        mlm_client_sendto(const_cast<mlm_client_t*>(server.getMailboxClient()),
-            mlm_client_sender(const_cast<mlm_client_t*>(server.getMailboxClient())), "ASSET_DETAIL", NULL,
-            5000, &reply);
+        send(sender, "ASSET_DETAIL", &reply);
         zstr_free(&uuid);
         zstr_free(&c_command);
         zmsg_destroy(&reply);
@@ -931,12 +1083,38 @@ static void s_handle_subject_asset_detail(const fty::AssetServer& server, zmsg_t
     // select an asset and publish it through mailbox
     char* uuid       = zmsg_popstr(zmessage);
     char* asset_name = zmsg_popstr(zmessage);
-    s_sendto_create_or_update_asset(server, asset_name, FTY_PROTO_ASSET_OP_UPDATE,
-        mlm_client_sender(const_cast<mlm_client_t*>(server.getMailboxClient())), uuid);
+    s_sendto_create_or_update_asset(server, send, asset_name, FTY_PROTO_ASSET_OP_UPDATE, sender, uuid);
     zstr_free(&asset_name);
     zstr_free(&uuid);
 }
 
+// STATS: one line per handled subject
+static void s_handle_subject_stats(const fty::AssetServer& server, mlm_client_t* client, const char* sender, zmsg_t* msg)
+{
+    zmsg_t* reply = zmsg_new();
+    zmsg_addstr(reply, "OK");
+    for (const auto& summary : server.getStats().summaries()) {
+        char* line = zsys_sprintf("%s count=%" PRIu64 " p50=%" PRIu64 " p90=%" PRIu64 " p99=%" PRIu64
+                                  " max=%" PRIu64 " db=%" PRIu64,
+            summary.subject.c_str(), summary.count, summary.p50, summary.p90, summary.p99, summary.max,
+            summary.dbQueries);
+        zmsg_addstr(reply, line);
+        zstr_free(&line);
+    }
+
+    char* command = zmsg_popstr(msg);
+    if (command && streq(command, "RESET")) {
+        server.getStats().reset();
+    }
+    zstr_free(&command);
+
+    int rv = mlm_client_sendto(client, sender, "STATS", NULL, 5000, &reply);
+    if (rv != 0) {
+        log_error("%s:\tSTATS: cannot send response message", server.getAgentName().c_str());
+        zmsg_destroy(&reply);
+    }
+}
+
 static void s_handle_subject_asset_manipulation(const fty::AssetServer& server, zmsg_t** zmessage_p)
 {
     const std::string& client_name = server.getAgentName();
@@ -1026,9 +1204,8 @@ static void s_handle_subject_asset_manipulation(const fty::AssetServer& server,
             zmsg_addstr(reply, "OK");
             zmsg_addstr(reply, asset.getInternalName().c_str());
 
-            auto notification = fty::assetutils::createMessage(FTY_ASSET_SUBJECT_CREATED, "",
-                server.getAgentNameNg(), "", messagebus::STATUS_OK, fty::Asset::toJson(asset));
-            server.sendNotification(notification);
+            // ASSET_MANIPULATION is not notified on the light topics
+            server.sendNotification(fty::AssetNotification::created(asset), false);
         } else if (streq(operation, "update")) {
             fty::AssetImpl currentAsset(asset.getInternalName());
             // on update, add link info from current asset:
@@ -1073,30 +1250,7 @@ static void s_handle_subject_asset_manipulation(const fty::AssetServer& server,
             zmsg_addstr(reply, "OK");
             zmsg_addstr(reply, asset.getInternalName().c_str());
 
-            cxxtools::SerializationInfo si;
-
-            // before update
-            cxxtools::SerializationInfo tmpSi;
-
-            tmpSi <<= currentAsset;
-
-            cxxtools::SerializationInfo& before = si.addMember("");
-            before.setCategory(cxxtools::SerializationInfo::Category::Object);
-            before = tmpSi;
-            before.setName("before");
-
-            // after update
-            tmpSi.clear();
-            tmpSi <<= asset;
-
-            cxxtools::SerializationInfo& after = si.addMember("");
-            after.setCategory(cxxtools::SerializationInfo::Category::Object);
-            after = tmpSi;
-            after.setName("after");
-
-            auto notification = fty::assetutils::createMessage(FTY_ASSET_SUBJECT_UPDATED, "",
-                server.getAgentNameNg(), "", messagebus::STATUS_OK, JSON::writeToString(si, false));
-            server.sendNotification(notification);
+            server.sendNotification(fty::AssetNotification::updated(currentAsset, asset), false);
         } else {
             // unknown op
             log_error("%s:\tASSET_MANIPULATION: asset operation %s is not implemented", client_name.c_str(),
@@ -1119,59 +1273,178 @@ static void s_handle_subject_asset_manipulation(const fty::AssetServer& server,
     zmsg_destroy(&reply);
 }
 
-static void s_update_topology(const fty::AssetServer& server, fty_proto_t* msg)
+// foreign is true when the message was not published by this agent, ie. the asset was changed
+static void s_update_topology(
+    const fty::AssetServer& server, fty::TopologyCoalescer& coalescer, fty_proto_t* msg, bool foreign)
 {
     assert (msg);
 
+    if (foreign) {
+        server.getMsgCache().invalidate(fty_proto_name(msg));
+        // assets created by other agents may lack them, see s_backfill_uuid_create_ts()
+        if (streq(fty_proto_operation(msg), FTY_PROTO_ASSET_OP_CREATE)) {
+            s_backfill_uuid_create_ts(server.getAgentName(), fty_proto_name(msg), server.getTestMode());
+        }
+    }
+    // the asset may also have been written in this process outside of the asset storage
+    fty::AssetImpl::invalidateStorageCache(fty_proto_name(msg));
+    // a running republish must not send it again
+    if (streq(fty_proto_operation(msg), FTY_PROTO_ASSET_OP_DELETE) ||
+        streq(fty_proto_operation(msg), FTY_PROTO_ASSET_OP_RETIRE)) {
+        server.publishedDeleted(fty_proto_name(msg));
+    }
+
     if (!streq(fty_proto_operation(msg), FTY_PROTO_ASSET_OP_UPDATE)) {
         log_info("%s:\tIgnore: '%s' on '%s'", server.getAgentName().c_str(), fty_proto_operation(msg),
             fty_proto_name(msg));
         return;
     }
-    // select assets, that were affected by the change
-    std::set<std::string>    empty;
-    std::vector<std::string> asset_names;
-    [[maybe_unused]] int rv = select_assets_by_container(fty_proto_name(msg), empty, asset_names, server.getTestMode());
-    if (rv != 0) {
-        log_warning("%s:\tCannot select assets in container '%s'", server.getAgentName().c_str(),
-            fty_proto_name(msg));
-        return;
+    // assets in the container are republished when the coalescing window is over
+    coalescer.add(fty_proto_name(msg), zclock_mono());
+}
+
+// Republishes assets of the updated containers, each asset once even if its container was updated several
+// times or if it belongs to several updated containers (ie. a rack and its row)
+static void s_update_topology_flush(
+    const fty::AssetServer& server, fty::TopologyCoalescer& coalescer, const fty::TopologyCoalescer::Updates& updates)
+{
+    std::set<std::string>    published;
+    std::vector<std::string> to_publish;
+    size_t                   requested = 0;
+
+    for (const auto& it : updates) {
+        // select assets, that were affected by the change
+        std::set<std::string>    empty;
+        std::vector<std::string> asset_names;
+        [[maybe_unused]] int rv = select_assets_by_container(it.first, empty, asset_names, server.getTestMode());
+        if (rv != 0) {
+            log_warning("%s:\tCannot select assets in container '%s'", server.getAgentName().c_str(),
+                it.first.c_str());
+            continue;
+        }
+
+        requested += it.second.count * asset_names.size();
+        for (const auto& asset_name : asset_names) {
+            // parents of the contained assets may have changed, whoever updated the container
+            server.getMsgCache().invalidate(asset_name);
+            if (published.insert(asset_name).second) {
+                to_publish.push_back(asset_name);
+            }
+        }
     }
 
     // For every asset we need to form new message!
-    for (const auto& asset_name : asset_names) {
+    for (const auto& asset_name : to_publish) {
         send_create_or_update_asset(server, asset_name, FTY_PROTO_ASSET_OP_UPDATE, true);
     }
+
+    coalescer.addSuppressed(requested - to_publish.size());
+    log_debug("%s:\t%zu containers updated, %zu assets republished, %zu suppressed (%" PRIu64 " in total)",
+        server.getAgentName().c_str(), updates.size(), to_publish.size(), requested - to_publish.size(),
+        coalescer.getSuppressed());
 }
 
-static void s_repeat_all(const fty::AssetServer& server, const std::set<std::string>& assets_to_publish)
+// poll timeout for the earliest of two timers, -1 means no timer
+static int s_poll_timeout(int timeout1, int timeout2)
 {
-    std::vector<std::string>               asset_names;
-    std::function<void(const tntdb::Row&)> cb = [&asset_names, &assets_to_publish](const tntdb::Row& row) {
-        std::string foo;
-        row["name"].get(foo);
-        if (assets_to_publish.size() == 0)
-            asset_names.push_back(foo);
-        else if (assets_to_publish.count(foo) == 1)
-            asset_names.push_back(foo);
-    };
+    if (timeout1 < 0) {
+        return timeout2;
+    }
+    if (timeout2 < 0) {
+        return timeout1;
+    }
+    return std::min(timeout1, timeout2);
+}
 
-    // select all assets
-    [[maybe_unused]] int rv = select_assets(cb, server.getTestMode());
-    if (rv != 0) {
-        log_warning("%s:\tCannot list all assets", server.getAgentName().c_str());
-        return;
+// Snapshot of all assets being republished, possibly slice by slice
+struct RepublishCycle
+{
+    std::vector<AssetStreamData> assets;
+    size_t                       next        = 0;
+    bool                         onlyChanged = false;
+    uint64_t                     sequence    = 0; // publish sequence when the snapshot was taken
+    size_t                       published   = 0;
+};
+
+// Loads all assets for a republish: whole DB is read with a constant number of queries instead of
+// three queries per asset, each message is then encoded from memory when sent.
+// With only_changed, assets whose message is the same as the last published one are skipped.
+static bool s_repeat_all_load(const fty::AssetServer& server, RepublishCycle& cycle, bool only_changed)
+{
+    cycle.assets.clear();
+    cycle.next        = 0;
+    cycle.published   = 0;
+    cycle.onlyChanged = only_changed;
+    cycle.sequence    = server.getPublishSequence();
+
+    if (load_assets_stream_data(server.getAgentName(), NULL, cycle.assets, server.getTestMode()) != 0) {
+        cycle.assets.clear();
+        return false;
     }
 
-    // For every asset we need to form new message!
-    for (const auto& asset_name : asset_names) {
-        send_create_or_update_asset(server, asset_name, FTY_PROTO_ASSET_OP_UPDATE, true);
+    std::set<std::string> asset_names;
+    for (const auto& data : cycle.assets) {
+        asset_names.insert(data.name);
     }
+    server.retainPublishedHashes(asset_names);
+    return true;
 }
 
+// Sends next count assets of the cycle
+static void s_repeat_all_send(const fty::AssetServer& server, RepublishCycle& cycle, size_t count)
+{
+    size_t end = std::min(cycle.next + count, cycle.assets.size());
+    for (; cycle.next < end; cycle.next++) {
+        AssetStreamData& data = cycle.assets[cycle.next];
+
+        // asset was published (created/updated) or deleted after the snapshot, do not send older content
+        if (server.publishedSince(data.name, cycle.sequence)) {
+            continue;
+        }
+
+        std::string subject;
+        zmsg_t*     msg = s_encode_asset_msg(
+            server.getAgentName(), data, FTY_PROTO_ASSET_OP_UPDATE, subject, server.getTestMode());
+        size_t hash = msg ? s_asset_msg_hash(subject, msg) : 0;
+        if (msg && cycle.onlyChanged && server.isPublishedHash(data.name, hash)) {
+            zmsg_destroy(&msg);
+            continue;
+        }
+        if (NULL == msg ||
+            0 != mlm_client_send(const_cast<mlm_client_t*>(server.getStreamClient()), subject.c_str(), &msg)) {
+            log_info("%s:\tmlm_client_send not sending message for asset '%s'", server.getAgentName().c_str(),
+                data.name.c_str());
+            zmsg_destroy(&msg);
+            continue;
+        }
+        server.updatePublishedHash(data.name, hash);
+        cycle.published++;
+    }
+
+    if (cycle.next == cycle.assets.size()) {
+        log_debug("%s:\trepublished %zu of %zu assets (%s)", server.getAgentName().c_str(), cycle.published,
+            cycle.assets.size(), cycle.onlyChanged ? "changed only" : "full");
+    }
+}
+
+// Republishes all assets at once
 static void s_repeat_all(const fty::AssetServer& server)
 {
-    return s_repeat_all(server, {});
+    RepublishCycle cycle;
+    if (s_repeat_all_load(server, cycle, false)) {
+        s_repeat_all_send(server, cycle, cycle.assets.size());
+    }
+}
+
+// Republishes the given assets at once, only they are read from the DB
+static void s_repeat_all(const fty::AssetServer& server, const std::set<std::string>& assets_to_publish)
+{
+    RepublishCycle cycle;
+    cycle.sequence = server.getPublishSequence();
+    if (load_assets_stream_data(server.getAgentName(), &assets_to_publish, cycle.assets, server.getTestMode()) != 0) {
+        return;
+    }
+    s_repeat_all_send(server, cycle, cycle.assets.size());
 }
 
 void handle_incoming_limitations(fty::AssetServer& server, fty_proto_t* metric)
@@ -1211,12 +1484,60 @@ void fty_asset_server(zsock_t* pipe, void* args)
     // set-up SRR
     server.initSrr(FTY_ASSET_SRR_QUEUE);
 
+    // periodic republish is paced, other events are handled between its slices
+    fty::RepublishScheduler scheduler;
+    RepublishCycle          cycle;
+    // first republish at start-up is sent at once, consumers wait for it
+    bool firstRepeat = true;
+
+    // updates of containers are coalesced before their contents are republished
+    fty::TopologyCoalescer coalescer;
+
+    // read-only mailbox subjects are handled by a pool of workers, writes stay serialized in this actor
+    using Send = fty::MailboxWorkerPool::Send;
+    fty::MailboxWorkerPool workers;
+    workers.addSubject("TOPOLOGY", [&server](const Send& send, const char* sender, zmsg_t* msg) {
+        fty::RequestTimer timer(server.getStats(), "TOPOLOGY");
+        s_handle_subject_topology(server, send, sender, msg);
+    });
+    workers.addSubject("ASSETS_IN_CONTAINER", [&server](const Send& send, const char* sender, zmsg_t* msg) {
+        fty::RequestTimer timer(server.getStats(), "ASSETS_IN_CONTAINER");
+        s_handle_subject_assets_in_container(server, send, sender, msg);
+    });
+    workers.addSubject("ASSETS", [&server](const Send& send, const char* sender, zmsg_t* msg) {
+        fty::RequestTimer timer(server.getStats(), "ASSETS");
+        s_handle_subject_assets(server, send, sender, msg);
+    });
+    workers.addSubject("ENAME_FROM_INAME", [&server](const Send& send, const char* sender, zmsg_t* msg) {
+        fty::RequestTimer timer(server.getStats(), "ENAME_FROM_INAME");
+        s_handle_subject_ename_from_iname(server, send, sender, msg);
+    });
+    workers.addSubject("ASSET_DETAIL", [&server](const Send& send, const char* sender, zmsg_t* msg) {
+        fty::RequestTimer timer(server.getStats(), "ASSET_DETAIL");
+        s_handle_subject_asset_detail(server, send, sender, &msg);
+    });
+    // power topology queries are the heaviest, keep some workers for the others
+    workers.setSubjectLimit("TOPOLOGY", 2);
+
     while (!zsys_interrupted) {
 
-        void* which = zpoller_wait(poller, -1);
+        size_t count = scheduler.take(zclock_mono());
+        if (count > 0) {
+            s_repeat_all_send(server, cycle, count);
+        }
+
+        auto updates = coalescer.take(zclock_mono());
+        if (!updates.empty()) {
+            s_update_topology_flush(server, coalescer, updates);
+        }
+
+        int64_t now   = zclock_mono();
+        void*   which = zpoller_wait(poller, s_poll_timeout(scheduler.timeout(now), coalescer.timeout(now)));
         if (!which) {
-            // cannot expire as waiting until infinity
-            // so it is interrupted
+            if (zpoller_expired(poller) && !zpoller_terminated(poller)) {
+                // next slice or coalesced updates are due
+                continue;
+            }
             break; // while
         }
 
@@ -1282,6 +1603,14 @@ void fty_asset_server(zsock_t* pipe, void* args)
                         server.getMailboxEndpoint().c_str());
                 }
 
+                for (zsock_t* sock : workers.sockets()) {
+                    zpoller_remove(poller, sock);
+                }
+                workers.start(const_cast<mlm_client_t*>(server.getMailboxClient()), server.getAgentName());
+                for (zsock_t* sock : workers.sockets()) {
+                    zpoller_add(poller, sock);
+                }
+
                 // new interface
                 server.createMailboxClientNg(); // queue
                 server.connectMailboxClientNg();
@@ -1289,9 +1618,130 @@ void fty_asset_server(zsock_t* pipe, void* args)
 
                 zstr_free(&endpoint);
                 zsock_signal(pipe, 0);
+            } else if (streq(cmd, "REPEAT_FULL_CYCLE")) {
+                char* cycle = zmsg_popstr(msg);
+                try {
+                    server.setRepeatFullCycle(cycle ? std::stoi(cycle) : 1);
+                } catch (const std::exception& e) {
+                    log_error("%s:\tInvalid REPEAT_FULL_CYCLE value '%s'", server.getAgentName().c_str(), cycle);
+                }
+                zstr_free(&cycle);
+                zsock_signal(pipe, 0);
+            } else if (streq(cmd, "WORKERS")) {
+                char* size = zmsg_popstr(msg);
+                try {
+                    workers.setSize(size ? std::stoul(size) : 0);
+                } catch (const std::exception& e) {
+                    log_error("%s:\tInvalid WORKERS value '%s'", server.getAgentName().c_str(), size);
+                }
+                zstr_free(&size);
+                zsock_signal(pipe, 0);
+            } else if (streq(cmd, "DB_POOL")) {
+                char* size = zmsg_popstr(msg);
+                try {
+                    fty::DB::getInstance().setPoolSize(size ? std::stoul(size) : 0);
+                } catch (const std::exception& e) {
+                    log_error("%s:\tInvalid DB_POOL value '%s'", server.getAgentName().c_str(), size);
+                }
+                zstr_free(&size);
+                zsock_signal(pipe, 0);
+            } else if (streq(cmd, "STORAGE_CACHE")) {
+                // memory budget in MB, 0 reads the database on every request
+                char* budget = zmsg_popstr(msg);
+                try {
+                    size_t mb = budget ? std::stoul(budget) : 0;
+                    if (mb > 0) {
+                        fty::AssetImpl::setStorageCacheBudget(mb * 1024 * 1024);
+                        fty::AssetImpl::setStorageType(fty::AssetStorage::StorageType::StorageCachedDB);
+                    } else {
+                        fty::AssetImpl::setStorageType(fty::AssetStorage::StorageType::StorageDB);
+                    }
+                } catch (const std::exception& e) {
+                    log_error("%s:\tInvalid STORAGE_CACHE value '%s'", server.getAgentName().c_str(), budget);
+                }
+                zstr_free(&budget);
+                zsock_signal(pipe, 0);
+            } else if (streq(cmd, "WORKER_LIMIT")) {
+                char* subject = zmsg_popstr(msg);
+                char* limit   = zmsg_popstr(msg);
+                try {
+                    workers.setSubjectLimit(subject ? subject : "", limit ? std::stoul(limit) : 0);
+                } catch (const std::exception& e) {
+                    log_error("%s:\tInvalid WORKER_LIMIT value '%s'", server.getAgentName().c_str(), limit);
+                }
+                zstr_free(&limit);
+                zstr_free(&subject);
+                zsock_signal(pipe, 0);
+            } else if (streq(cmd, "REPEAT_RATE")) {
+                char* rate = zmsg_popstr(msg);
+                try {
+                    scheduler.setRate(rate ? std::stod(rate) : 0);
+                } catch (const std::exception& e) {
+                    log_error("%s:\tInvalid REPEAT_RATE value '%s'", server.getAgentName().c_str(), rate);
+                }
+                zstr_free(&rate);
+                zsock_signal(pipe, 0);
+            } else if (streq(cmd, "REPEAT_SLICE")) {
+                char* slice = zmsg_popstr(msg);
+                try {
+                    scheduler.setSliceSize(slice ? std::stoul(slice) : 0);
+                } catch (const std::exception& e) {
+                    log_error("%s:\tInvalid REPEAT_SLICE value '%s'", server.getAgentName().c_str(), slice);
+                }
+                zstr_free(&slice);
+                zsock_signal(pipe, 0);
+            } else if (streq(cmd, "REPEAT_INTERVAL")) {
+                char* interval = zmsg_popstr(msg);
+                try {
+                    scheduler.setInterval(interval ? std::stoi(interval) : 0);
+                } catch (const std::exception& e) {
+                    log_error(
+                        "%s:\tInvalid REPEAT_INTERVAL value '%s'", server.getAgentName().c_str(), interval);
+                }
+                zstr_free(&interval);
+                zsock_signal(pipe, 0);
+            } else if (streq(cmd, "BACKFILL")) {
+                // done once at start-up, before the first republish
+                s_backfill_uuid_create_ts(server.getAgentName(), "", server.getTestMode());
+                fty::AssetImpl::clearStorageCache();
+                zsock_signal(pipe, 0);
+            } else if (streq(cmd, "TOPOLOGY_WINDOW")) {
+                char* window = zmsg_popstr(msg);
+                try {
+                    coalescer.setWindow(window ? std::stoi(window) : 0);
+                } catch (const std::exception& e) {
+                    log_error("%s:\tInvalid TOPOLOGY_WINDOW value '%s'", server.getAgentName().c_str(), window);
+                }
+                zstr_free(&window);
+                zsock_signal(pipe, 0);
             } else if (streq(cmd, "REPEAT_ALL")) {
-                s_repeat_all(server);
-                log_debug("%s:\tREPEAT_ALL end", server.getAgentName().c_str());
+                bool only_changed = !server.nextRepeatIsFull();
+                // unfinished full cycle is not downgraded to changed only
+                if (scheduler.pending() && !cycle.onlyChanged) {
+                    only_changed = false;
+                }
+                // full resync also refreshes cached messages, and stores uuid and create_ts of assets
+                // which were inserted in the DB without a CREATE on the stream (done by BACKFILL at start-up)
+                if (!only_changed) {
+                    if (!firstRepeat) {
+                        s_backfill_uuid_create_ts(server.getAgentName(), "", server.getTestMode());
+                    }
+                    log_debug("%s:\tmessage cache: %zu entries, %" PRIu64 " hits, %" PRIu64 " misses",
+                        server.getAgentName().c_str(), server.getMsgCache().size(), server.getMsgCache().hits(),
+                        server.getMsgCache().misses());
+                    server.getMsgCache().clear();
+                    fty::AssetImpl::clearStorageCache();
+                }
+                bool loaded = s_repeat_all_load(server, cycle, only_changed);
+                if (firstRepeat) {
+                    firstRepeat = false;
+                    scheduler.start(0, zclock_mono());
+                    s_repeat_all_send(server, cycle, cycle.assets.size());
+                    log_debug("%s:\tREPEAT_ALL done", server.getAgentName().c_str());
+                } else {
+                    scheduler.start(loaded ? cycle.assets.size() : 0, zclock_mono());
+                    log_debug("%s:\tREPEAT_ALL started", server.getAgentName().c_str());
+                }
             } else {
                 log_info("%s:\tUnhandled command %s", server.getAgentName().c_str(), cmd);
             }
@@ -1300,6 +1750,11 @@ void fty_asset_server(zsock_t* pipe, void* args)
             continue;
         }
 
+        // worker finished its request
+        else if (workers.onWorker(which)) {
+            continue;
+        }
+
         // This agent is a reactive agent, it reacts only on messages
         // and doesn't do anything if there are no messages
         else if (which == mlm_client_msgpipe(const_cast<mlm_client_t*>(server.getMailboxClient()))) {
@@ -1307,15 +1762,24 @@ void fty_asset_server(zsock_t* pipe, void* args)
             if (zmessage == NULL) {
                 continue;
             }
-            std::string subject = mlm_client_subject(const_cast<mlm_client_t*>(server.getMailboxClient()));
-            if (subject == "TOPOLOGY") {
-                s_handle_subject_topology(server, zmessage);
+            mlm_client_t* client  = const_cast<mlm_client_t*>(server.getMailboxClient());
+            std::string   subject = mlm_client_subject(client);
+            auto          send    = s_mailbox_send(client);
+            // requests dispatched to the workers are timed in the workers
+            std::unique_ptr<fty::RequestTimer> timer;
+            if (!workers.handles(subject)) {
+                timer.reset(new fty::RequestTimer(server.getStats(), subject));
+            }
+            if (workers.handles(subject)) {
+                workers.dispatch(subject, mlm_client_sender(client), &zmessage);
+            } else if (subject == "TOPOLOGY") {
+                s_handle_subject_topology(server, send, mlm_client_sender(client), zmessage);
             } else if (subject == "ASSETS_IN_CONTAINER") {
-                s_handle_subject_assets_in_container(server, zmessage);
+                s_handle_subject_assets_in_container(server, send, mlm_client_sender(client), zmessage);
             } else if (subject == "ASSETS") {
-                s_handle_subject_assets(server, zmessage);
+                s_handle_subject_assets(server, send, mlm_client_sender(client), zmessage);
             } else if (subject == "ENAME_FROM_INAME") {
-                s_handle_subject_ename_from_iname(server, zmessage);
+                s_handle_subject_ename_from_iname(server, send, mlm_client_sender(client), zmessage);
             } else if (subject == "REPUBLISH") {
                 zmsg_print(zmessage);
                 log_trace("REPUBLISH received from '%s'",
@@ -1336,9 +1800,12 @@ void fty_asset_server(zsock_t* pipe, void* args)
             } else if (subject == "ASSET_MANIPULATION") {
                 s_handle_subject_asset_manipulation(server, &zmessage);
             } else if (subject == "ASSET_DETAIL") {
-                s_handle_subject_asset_detail(server, &zmessage);
+                s_handle_subject_asset_detail(server, send, mlm_client_sender(client), &zmessage);
+            } else if (subject == "STATS") {
+                s_handle_subject_stats(server, client, mlm_client_sender(client), zmessage);
             } else {
                 log_info("%s:\tUnexpected subject '%s'", server.getAgentName().c_str(), subject.c_str());
+                timer->cancel();
             }
             zmsg_destroy(&zmessage);
         } else if (which == mlm_client_msgpipe(const_cast<mlm_client_t*>(server.getStreamClient()))) {
@@ -1349,7 +1816,9 @@ void fty_asset_server(zsock_t* pipe, void* args)
             if (fty_proto_is(zmessage)) {
                 fty_proto_t* bmsg = fty_proto_decode(&zmessage);
                 if (fty_proto_id(bmsg) == FTY_PROTO_ASSET) {
-                    s_update_topology(server, bmsg);
+                    const char* sender = mlm_client_sender(const_cast<mlm_client_t*>(server.getStreamClient()));
+                    bool        foreign = !sender || server.getAgentName() + "-stream" != sender;
+                    s_update_topology(server, coalescer, bmsg, foreign);
                 } else if (fty_proto_id(bmsg) == FTY_PROTO_METRIC) {
                     handle_incoming_limitations(server, bmsg);
                 }
@@ -1425,6 +1894,36 @@ static void test_asset_mailbox_handler(const messagebus::Message& msg)
     }
 }
 
+// synthetic asset ups-<n>
+static AssetStreamData s_test_bulk_asset(size_t n)
+{
+    AssetStreamData data;
+    data.found     = true;
+    data.id        = static_cast<uint32_t>(n);
+    data.name      = "ups-" + std::to_string(n);
+    data.typeId    = persist::asset_type::DEVICE;
+    data.subtypeId = persist::asset_subtype::UPS;
+    data.status    = "active";
+    data.parents.assign(ASSET_STREAM_MAX_PARENTS, "");
+    data.ext.emplace_back("uuid", "00000000-0000-0000-0000-000000000000");
+    data.ext.emplace_back("create_ts", "2020-01-01T00:00:00+0000");
+    return data;
+}
+
+// loader of count synthetic assets ups-1 ... ups-<count>
+static AssetStreamDataLoader s_test_bulk_loader(size_t count)
+{
+    return [count](const std::string& /*client_name*/, const std::set<std::string>* names,
+               std::vector<AssetStreamData>& assets, bool /*test_mode*/) {
+        for (size_t i = 1; i <= count; i++) {
+            if (!names || names->count("ups-" + std::to_string(i))) {
+                assets.push_back(s_test_bulk_asset(i));
+            }
+        }
+        return 0;
+    };
+}
+
 void fty_asset_server_test(bool /*verbose*/)
 {
     log_debug("Setting test mode to true");
@@ -2007,6 +2506,991 @@ void fty_asset_server_test(bool /*verbose*/)
         zclock_sleep(200);
     }
 
+    // Test #16: ASSETS stream message encoded from in-memory data (bulk republish)
+    {
+        log_debug("fty-asset-server-test:Test #16");
+
+        AssetStreamData data;
+        data.found     = true;
+        data.id        = 42;
+        data.name      = "ups-1";
+        data.priority  = 2;
+        data.typeId    = persist::asset_type::DEVICE;
+        data.subtypeId = persist::asset_subtype::UPS;
+        data.parentId  = 7;
+        data.status    = "active";
+        data.ext.emplace_back("name", "UPS 1");
+        data.parents.assign(ASSET_STREAM_MAX_PARENTS, "");
+        data.parents[0] = "rack-1";
+        data.parents[1] = "datacenter-1";
+
+        std::string subject;
+        zmsg_t*     zmsg = s_encode_asset_msg("test", data, FTY_PROTO_ASSET_OP_UPDATE, subject, true);
+        assert (zmsg);
+        assert (subject == "device.ups@ups-1");
+
+        fty_proto_t* proto = fty_proto_decode(&zmsg);
+        assert (proto);
+        assert (streq(fty_proto_name(proto), "ups-1"));
+        assert (streq(fty_proto_operation(proto), FTY_PROTO_ASSET_OP_UPDATE));
+        assert (streq(fty_proto_aux_string(proto, "priority", ""), "2"));
+        assert (streq(fty_proto_aux_string(proto, "parent", ""), "7"));
+        assert (streq(fty_proto_aux_string(proto, "status", ""), "active"));
+        assert (streq(fty_proto_aux_string(proto, "parent_name.1", ""), "rack-1"));
+        assert (streq(fty_proto_aux_string(proto, "parent_name.2", ""), "datacenter-1"));
+        assert (fty_proto_aux_string(proto, "parent_name.3", NULL) == NULL);
+        assert (streq(fty_proto_ext_string(proto, "name", ""), "UPS 1"));
+        // encoding does not generate missing attributes
+        assert (fty_proto_ext_string(proto, "uuid", NULL) == NULL);
+        assert (fty_proto_ext_string(proto, "create_ts", NULL) == NULL);
+        fty_proto_destroy(&proto);
+
+        log_info("fty-asset-server-test:Test #16: OK");
+    }
+
+    // Test #17: incremental republish bookkeeping
+    {
+        log_debug("fty-asset-server-test:Test #17");
+
+        fty::AssetServer s;
+        s.setRepeatFullCycle(3);
+        assert (s.nextRepeatIsFull());
+        assert (!s.nextRepeatIsFull());
+        assert (!s.nextRepeatIsFull());
+        assert (s.nextRepeatIsFull());
+
+        assert (!s.isPublishedHash("ups-1", 1));
+        assert (s.updatePublishedHash("ups-1", 1));
+        assert (s.isPublishedHash("ups-1", 1));
+        assert (!s.updatePublishedHash("ups-1", 1));
+        assert (s.updatePublishedHash("ups-1", 2));
+        s.retainPublishedHashes({"ups-2"});
+        assert (s.updatePublishedHash("ups-1", 2));
+
+        // deleted asset is skipped by a cycle started before
+        uint64_t sequence = s.getPublishSequence();
+        assert (!s.publishedSince("ups-1", sequence));
+        s.publishedDeleted("ups-1");
+        assert (s.publishedSince("ups-1", sequence));
+        assert (!s.isPublishedHash("ups-1", 2));
+        assert (s.updatePublishedHash("ups-1", 2));
+
+        log_info("fty-asset-server-test:Test #17: OK");
+    }
+
+    // Test #18: republish pacing
+    {
+        log_debug("fty-asset-server-test:Test #18");
+
+        fty::RepublishScheduler scheduler;
+        assert (!scheduler.pending());
+        assert (scheduler.timeout(0) == -1);
+
+        // 10 assets per second, slices of 4
+        scheduler.setRate(10);
+        scheduler.setSliceSize(4);
+        scheduler.start(10, 0);
+        assert (scheduler.take(0) == 4);
+        assert (scheduler.take(0) == 0);
+        assert (scheduler.timeout(0) == 400);
+        assert (scheduler.take(400) == 4);
+        // last slice is smaller
+        assert (scheduler.timeout(400) == 200);
+        assert (scheduler.take(600) == 2);
+        assert (!scheduler.pending());
+
+        // cycle must end within the interval
+        scheduler.setInterval(1);
+        scheduler.start(100, 0);
+        assert (scheduler.take(0) == 4);
+        assert (scheduler.timeout(0) == 40);
+
+        // no pacing
+        scheduler.setRate(0);
+        scheduler.start(10, 0);
+        assert (scheduler.take(0) == 4);
+        assert (scheduler.timeout(0) == 0);
+
+        log_info("fty-asset-server-test:Test #18: OK");
+    }
+
+    // Test #19: mailbox requests are answered while a republish runs in slices
+    {
+        log_debug("fty-asset-server-test:Test #19");
+
+        mlm_client_t* requester = mlm_client_new();
+        mlm_client_connect(requester, endpoint.c_str(), 5000, (client_name + "-requester").c_str());
+
+        std::atomic<int> loads{0};
+        set_assets_stream_data_loader([&loads](const std::string& client_name, const std::set<std::string>* names,
+                                          std::vector<AssetStreamData>& assets, bool test_mode) {
+            loads++;
+            return s_test_bulk_loader(200)(client_name, names, assets, test_mode);
+        });
+        zstr_sendx(asset_server, "REPEAT_RATE", "1000", NULL);
+        zsock_wait(asset_server);
+        zstr_sendx(asset_server, "REPEAT_SLICE", "10", NULL);
+        zsock_wait(asset_server);
+        zstr_sendx(asset_server, "REPEAT_ALL", NULL);
+
+        for (int i = 0; i < 5; i++) {
+            zmsg_t* msg = zmsg_new();
+            zmsg_addstr(msg, TEST_INAME);
+            [[maybe_unused]] int rv =
+                mlm_client_sendto(requester, asset_server_test_name.c_str(), "ENAME_FROM_INAME", NULL, 5000, &msg);
+            assert (rv == 0);
+            zmsg_t* reply = mlm_client_recv(requester);
+            assert (reply);
+            zmsg_destroy(&reply);
+        }
+        // the cycle is loaded once, then sent in slices
+        assert (loads <= 1);
+        set_assets_stream_data_loader(AssetStreamDataLoader());
+
+        // restore defaults, drop pending cycle
+        zstr_sendx(asset_server, "REPEAT_RATE", "100", NULL);
+        zsock_wait(asset_server);
+        zstr_sendx(asset_server, "REPEAT_SLICE", "50", NULL);
+        zsock_wait(asset_server);
+        zstr_sendx(asset_server, "REPEAT_ALL", NULL);
+        mlm_client_destroy(&requester);
+
+        log_info("fty-asset-server-test:Test #19: OK");
+    }
+
+    // Test #20: requests are handled concurrently by mailbox workers, replies come from the owner
+    {
+        log_debug("fty-asset-server-test:Test #20");
+
+        std::string   requesterName = client_name + "-requester";
+        std::string   ownerName     = client_name + "-owner";
+        mlm_client_t* requester     = mlm_client_new();
+        mlm_client_connect(requester, endpoint.c_str(), 5000, requesterName.c_str());
+        mlm_client_t* owner = mlm_client_new();
+        mlm_client_connect(owner, endpoint.c_str(), 5000, ownerName.c_str());
+
+        const int delay    = 200;
+        const int requests = 4;
+
+        fty::MailboxWorkerPool pool;
+        pool.addSubject("SLOW", [](const fty::MailboxWorkerPool::Send& send, const char* sender, zmsg_t* msg) {
+            zclock_sleep(delay);
+            char*   n     = zmsg_popstr(msg);
+            zmsg_t* reply = zmsg_new();
+            zmsg_addstr(reply, n);
+            send(sender, "SLOW", &reply);
+            zmsg_destroy(&reply);
+            zstr_free(&n);
+        });
+        pool.setSize(requests);
+        pool.start(owner, ownerName);
+
+        auto run = [&](size_t limit) -> int64_t {
+            pool.setSubjectLimit("SLOW", limit);
+            int64_t start = zclock_mono();
+            for (int i = 0; i < requests; i++) {
+                zmsg_t* msg = zmsg_new();
+                zmsg_addstr(msg, std::to_string(i).c_str());
+                pool.dispatch("SLOW", requesterName, &msg);
+            }
+
+            zpoller_t* poller = zpoller_new(mlm_client_msgpipe(requester), NULL);
+            for (zsock_t* sock : pool.sockets()) {
+                zpoller_add(poller, sock);
+            }
+            int replies = 0;
+            while (replies < requests) {
+                void* which = zpoller_wait(poller, 5000);
+                assert (which);
+                if (pool.onWorker(which)) {
+                    continue;
+                }
+                zmsg_t* reply = mlm_client_recv(requester);
+                assert (reply);
+                assert (streq(mlm_client_subject(requester), "SLOW"));
+                assert (ownerName == mlm_client_sender(requester));
+                zmsg_destroy(&reply);
+                replies++;
+            }
+            zpoller_destroy(&poller);
+            return zclock_mono() - start;
+        };
+
+        // one request at a time
+        int64_t serial = run(1);
+        assert (pool.peak("SLOW") == 1);
+        assert (serial >= requests * delay);
+
+        // all requests at once
+        int64_t parallel = run(requests);
+        assert (pool.peak("SLOW") == requests);
+
+        log_info("fty-asset-server-test:Test #20: %d requests of %d ms: serial %" PRIi64
+                 " ms, concurrent %" PRIi64 " ms",
+            requests, delay, serial, parallel);
+        pool.stop();
+
+        // replies of the agent come from its own address, not from a worker
+        zmsg_t* msg = zmsg_new();
+        zmsg_addstr(msg, "GET");
+        zmsg_addstr(msg, "");
+        zmsg_addstr(msg, "rack controller");
+        mlm_client_sendto(requester, asset_server_test_name.c_str(), "ASSETS_IN_CONTAINER", NULL, 5000, &msg);
+        zmsg_t* reply = mlm_client_recv(requester);
+        assert (reply);
+        assert (streq(mlm_client_subject(requester), "ASSETS_IN_CONTAINER"));
+        assert (asset_server_test_name == mlm_client_sender(requester));
+        zmsg_destroy(&reply);
+
+        mlm_client_destroy(&owner);
+        mlm_client_destroy(&requester);
+
+        log_info("fty-asset-server-test:Test #20: OK");
+    }
+
+    // Test #21: encoded asset message cache
+    {
+        log_debug("fty-asset-server-test:Test #21");
+
+        fty::AssetMsgCache cache;
+        std::string        subject;
+
+        zmsg_t* msg = zmsg_new();
+        zmsg_addstr(msg, "ups-1 content");
+        cache.put("ups-1", FTY_PROTO_ASSET_OP_UPDATE, "device.ups@ups-1", msg, cache.generation());
+        zmsg_destroy(&msg);
+        msg = zmsg_new();
+        zmsg_addstr(msg, "datacenter-1 content");
+        cache.put("datacenter-1", FTY_PROTO_ASSET_OP_UPDATE, "datacenter.N_A@datacenter-1", msg, cache.generation());
+        zmsg_destroy(&msg);
+        msg = zmsg_new();
+        zmsg_addstr(msg, "rack-1 content");
+        cache.put("rack-1", FTY_PROTO_ASSET_OP_UPDATE, "rack.N_A@rack-1", msg, cache.generation());
+        zmsg_destroy(&msg);
+        assert (cache.size() == 3);
+
+        msg = cache.get("ups-1", FTY_PROTO_ASSET_OP_UPDATE, subject);
+        assert (msg);
+        assert (subject == "device.ups@ups-1");
+        char* content = zmsg_popstr(msg);
+        assert (streq(content, "ups-1 content"));
+        zstr_free(&content);
+        zmsg_destroy(&msg);
+
+        // other operation, unknown asset
+        assert (cache.get("ups-1", FTY_PROTO_ASSET_OP_CREATE, subject) == NULL);
+        assert (cache.get("ups-2", FTY_PROTO_ASSET_OP_UPDATE, subject) == NULL);
+        assert (cache.hits() == 1);
+        assert (cache.misses() == 2);
+
+        // datacenters are dropped with the changed asset
+        cache.invalidate("ups-1");
+        assert (cache.size() == 1);
+        msg = cache.get("rack-1", FTY_PROTO_ASSET_OP_UPDATE, subject);
+        assert (msg);
+        zmsg_destroy(&msg);
+
+        // a message encoded across an invalidation is not kept
+        uint64_t generation = cache.generation();
+        cache.invalidate("ups-2");
+        msg = zmsg_new();
+        zmsg_addstr(msg, "ups-2 content");
+        cache.put("ups-2", FTY_PROTO_ASSET_OP_UPDATE, "device.ups@ups-2", msg, generation);
+        assert (cache.get("ups-2", FTY_PROTO_ASSET_OP_UPDATE, subject) == NULL);
+
+        // and other caches of the process are invalidated with inventory writes
+        cache.put("ups-2", FTY_PROTO_ASSET_OP_UPDATE, "device.ups@ups-2", msg, cache.generation());
+        zmsg_destroy(&msg);
+        assert (cache.size() == 2);
+        fty::AssetMsgCache::invalidateAll("ups-2");
+        assert (cache.size() == 1);
+
+        // over the budget, least recently used messages are dropped
+        assert (cache.bytes() > 0);
+        cache.setBudget(0);
+        assert (cache.size() == 0 && cache.bytes() == 0);
+
+        // expired messages are encoded again
+        cache.setBudget(1024 * 1024);
+        msg = zmsg_new();
+        zmsg_addstr(msg, "rack-1 content");
+        cache.put("rack-1", FTY_PROTO_ASSET_OP_UPDATE, "rack.N_A@rack-1", msg, cache.generation());
+        zmsg_destroy(&msg);
+        cache.setTtl(std::chrono::seconds(-1));
+        assert (cache.get("rack-1", FTY_PROTO_ASSET_OP_UPDATE, subject) == NULL);
+        assert (cache.size() == 0);
+
+        cache.clear();
+        assert (cache.size() == 0);
+
+        log_info("fty-asset-server-test:Test #21: OK");
+    }
+
+    // Test #22: coalescing of container updates
+    {
+        log_debug("fty-asset-server-test:Test #22");
+
+        fty::TopologyCoalescer coalescer;
+        assert (!coalescer.pending());
+        assert (coalescer.timeout(0) == -1);
+
+        coalescer.setWindow(100);
+        coalescer.add("rack-1", 0);
+        coalescer.add("rack-1", 50);
+        coalescer.add("row-1", 80);
+        coalescer.add("rack-1", 90);
+        // window is not extended by later updates
+        assert (coalescer.timeout(50) == 50);
+        assert (coalescer.take(99).empty());
+
+        auto updates = coalescer.take(100);
+        assert (updates.size() == 2);
+        assert (updates["rack-1"].count == 3);
+        assert (updates["row-1"].count == 1);
+        assert (!coalescer.pending());
+
+        coalescer.setWindow(0);
+        coalescer.add("rack-1", 200);
+        assert (coalescer.timeout(200) == 0);
+        assert (coalescer.take(200).size() == 1);
+
+        coalescer.addSuppressed(4);
+        assert (coalescer.getSuppressed() == 4);
+
+        log_info("fty-asset-server-test:Test #22: OK");
+    }
+
+    // Test #23: generation of missing uuid and create_ts
+    {
+        log_debug("fty-asset-server-test:Test #23");
+
+        auto ext1 = s_generate_uuid_create_ts("Eaton", "9PX", "SN123", true, true);
+        auto ext2 = s_generate_uuid_create_ts("Eaton", "9PX", "SN123", true, false);
+        assert (ext1.size() == 2);
+        assert (!ext1["create_ts"].empty());
+        // calculated uuid is stable
+        assert (ext2.size() == 1);
+        assert (ext1["uuid"] == ext2["uuid"]);
+
+        // random uuid without serial number
+        auto ext3 = s_generate_uuid_create_ts("Eaton", "9PX", "", true, false);
+        auto ext4 = s_generate_uuid_create_ts("Eaton", "9PX", "", true, false);
+        assert (!ext3["uuid"].empty());
+        assert (ext3["uuid"] != ext4["uuid"]);
+
+        assert (s_generate_uuid_create_ts("", "", "", false, false).empty());
+        assert (s_backfill_uuid_create_ts("test", "", true) == 0);
+
+        log_info("fty-asset-server-test:Test #23: OK");
+    }
+
+    // Test #24: request statistics, subject STATS
+    {
+        log_debug("fty-asset-server-test:Test #24");
+
+        for (uint64_t usecs : {0, 7, 8, 15, 1000, 123456789}) {
+            size_t bucket = fty::RequestStats::bucket(usecs);
+            assert (fty::RequestStats::bucketValue(bucket) <= usecs);
+            assert (fty::RequestStats::bucketValue(bucket + 1) > usecs);
+        }
+
+        fty::RequestStats stats;
+        for (uint64_t i = 1; i <= 100; i++) {
+            stats.record("TEST", i * 1000, 2);
+        }
+        {
+            fty::RequestTimer timer(stats, "TIMED");
+            fty::RequestStats::countDbQuery();
+        }
+        {
+            fty::RequestTimer timer(stats, "CANCELLED");
+            timer.cancel();
+        }
+        auto summaries = stats.summaries();
+        assert (summaries.size() == 2);
+        assert (summaries[0].subject == "TEST");
+        assert (summaries[0].count == 100);
+        assert (summaries[0].dbQueries == 200);
+        assert (summaries[0].max == 100000);
+        // percentiles are within one bucket
+        assert (summaries[0].p50 <= 50000 && summaries[0].p50 * 8 / 7 >= 50000);
+        assert (summaries[0].p99 <= 99000 && summaries[0].p99 * 8 / 7 >= 99000);
+        assert (summaries[1].subject == "TIMED");
+        assert (summaries[1].dbQueries == 1);
+
+        // mailbox
+        zmsg_t* msg = zmsg_new();
+        zmsg_addstr(msg, "RESET");
+        [[maybe_unused]] int rv = mlm_client_sendto(ui, asset_server_test_name.c_str(), "STATS", NULL, 5000, &msg);
+        assert (rv == 0);
+        zmsg_t* reply = mlm_client_recv(ui);
+        assert (streq(mlm_client_subject(ui), "STATS"));
+        char* str = zmsg_popstr(reply);
+        assert (streq(str, "OK"));
+        zstr_free(&str);
+        bool found = false;
+        for (str = zmsg_popstr(reply); str; str = zmsg_popstr(reply)) {
+            found = found || strncmp(str, "ENAME_FROM_INAME count=", 23) == 0;
+            zstr_free(&str);
+        }
+        assert (found);
+        zmsg_destroy(&reply);
+
+        // only the previous STATS request is left
+        msg = zmsg_new();
+        rv  = mlm_client_sendto(ui, asset_server_test_name.c_str(), "STATS", NULL, 5000, &msg);
+        assert (rv == 0);
+        reply = mlm_client_recv(ui);
+        assert (zmsg_size(reply) == 2);
+        str = zmsg_popstr(reply);
+        zstr_free(&str);
+        str = zmsg_popstr(reply);
+        assert (strncmp(str, "STATS count=1 ", 14) == 0);
+        zstr_free(&str);
+        zmsg_destroy(&reply);
+
+        log_info("fty-asset-server-test:Test #24: OK");
+    }
+
+    // Test #25: targeted republish loads the requested assets only
+    {
+        log_debug("fty-asset-server-test:Test #25");
+
+        std::mutex            lock;
+        bool                  loaded = false;
+        std::set<std::string> requested;
+        set_assets_stream_data_loader([&](const std::string& client_name, const std::set<std::string>* names,
+                                          std::vector<AssetStreamData>& assets, bool test_mode) {
+            std::unique_lock<std::mutex> guard(lock);
+            loaded = true;
+            assert (names);
+            requested = *names;
+            return s_test_bulk_loader(10)(client_name, names, assets, test_mode);
+        });
+
+        zmsg_t* msg = zmsg_new();
+        zmsg_addstr(msg, "ups-7");
+        zmsg_addstr(msg, "ups-2");
+        zmsg_addstr(msg, "rack-1");
+        [[maybe_unused]] int rv = mlm_client_sendto(ui, asset_server_test_name.c_str(), "REPUBLISH", NULL, 5000, &msg);
+        assert (rv == 0);
+        for (int i = 0; i < 100; i++) {
+            std::unique_lock<std::mutex> guard(lock);
+            if (loaded) {
+                break;
+            }
+            guard.unlock();
+            zclock_sleep(10);
+        }
+        set_assets_stream_data_loader(AssetStreamDataLoader());
+
+        std::unique_lock<std::mutex> guard(lock);
+        assert (loaded);
+        assert ((requested == std::set<std::string>{"ups-7", "ups-2", "rack-1"}));
+
+        log_info("fty-asset-server-test:Test #25: OK");
+    }
+
+    // Test #26: LIST hydration, bulk loading as loading per asset
+    {
+        log_debug("fty-asset-server-test:Test #26");
+
+        std::vector<std::string> inames;
+        for (int i = 0; i < 50; i++) {
+            inames.push_back("ups-" + std::to_string(i));
+        }
+
+        std::vector<fty::AssetImpl> single;
+        for (const auto& iname : inames) {
+            single.push_back(fty::AssetImpl(iname));
+        }
+
+        std::vector<fty::AssetImpl> bulk = fty::AssetImpl::loadList(inames);
+
+        // same assets
+        assert (bulk.size() == single.size());
+        for (size_t i = 0; i < bulk.size(); i++) {
+            assert (bulk[i] == single[i]);
+            cxxtools::SerializationInfo si1, si2;
+            si1 <<= single[i];
+            si2 <<= bulk[i];
+            assert (JSON::writeToString(si1, false) == JSON::writeToString(si2, false));
+        }
+
+        log_info("fty-asset-server-test:Test #26: OK");
+    }
+
+    // Test #29: update notification payloads, serialized once as per topic
+    {
+        log_debug("fty-asset-server-test:Test #29");
+
+        fty::AssetImpl before("ups-1");
+        fty::AssetImpl after(before);
+        after.setAssetStatus(fty::AssetStatus::Nonactive);
+
+        std::string perTopic;
+        {
+            // response
+            std::string reply = fty::Asset::toJson(after);
+
+            // full topic
+            cxxtools::SerializationInfo si;
+            cxxtools::SerializationInfo tmpSi;
+            tmpSi <<= before;
+            cxxtools::SerializationInfo& beforeSi = si.addMember("");
+            beforeSi.setCategory(cxxtools::SerializationInfo::Category::Object);
+            beforeSi = tmpSi;
+            beforeSi.setName("before");
+            tmpSi.clear();
+            tmpSi <<= after;
+            cxxtools::SerializationInfo& afterSi = si.addMember("");
+            afterSi.setCategory(cxxtools::SerializationInfo::Category::Object);
+            afterSi = tmpSi;
+            afterSi.setName("after");
+            perTopic = JSON::writeToString(si, false);
+
+            // old interface, iname read back from the payload
+            cxxtools::SerializationInfo siRead;
+            JSON::readFromString(perTopic, siRead);
+            fty::Asset asset;
+            siRead.getMember("after") >>= asset;
+            assert (asset.getInternalName() == after.getInternalName() && !reply.empty());
+        }
+
+        fty::AssetNotification updated = fty::AssetNotification::updated(before, after);
+        assert (updated.iname() == after.getInternalName() && !updated.asset().empty());
+        std::string once = updated.payload();
+
+        // same payload on the topic
+        assert (once == perTopic);
+
+        fty::AssetNotification notification = fty::AssetNotification::created(after);
+        assert (notification.payload() == fty::Asset::toJson(after));
+        assert (streq(notification.subject(), FTY_ASSET_SUBJECT_CREATED));
+        assert (streq(notification.lightSubject(), FTY_ASSET_SUBJECT_CREATED_L));
+
+        // legacy stream message is built from the notified asset
+        assert (notification.after() && notification.after()->getInternalName() == after.getInternalName());
+        assert (updated.after() && updated.after()->getAssetStatus() == fty::AssetStatus::Nonactive);
+        assert (!fty::AssetNotification::deleted(after).after());
+
+        log_info("fty-asset-server-test:Test #29: OK");
+    }
+
+    // Test #30: delta of an update
+    {
+        log_debug("fty-asset-server-test:Test #30");
+
+        fty::AssetImpl before("ups-1");
+        fty::AssetImpl after(before);
+        after.setExtEntry("status.operating", "retired");
+
+        fty::AssetNotification notification = fty::AssetNotification::updated(before, after);
+        assert (!notification.delta().empty());
+        assert (notification.delta().size() < notification.payload().size());
+
+        fty::AssetDelta delta;
+        fty::AssetDelta::fromJson(notification.delta(), delta);
+        assert (delta.getInternalName() == "ups-1");
+        fty::Asset applied(before);
+        delta.apply(applied);
+        assert (applied == after);
+
+        // nothing to publish on the delta topic
+        assert (fty::AssetNotification::updated(before, before).delta().empty());
+        assert (fty::AssetNotification::created(after).delta().empty());
+
+        log_info("fty-asset-server-test:Test #30: full %zu bytes, delta %zu bytes", notification.payload().size(),
+            notification.delta().size());
+        log_info("fty-asset-server-test:Test #30: OK");
+    }
+
+    // Test #31: creation of assets in one batch, as created one by one
+    {
+        log_debug("fty-asset-server-test:Test #31");
+
+        std::vector<fty::AssetImpl> assets;
+        for (int i = 0; i < 10; i++) {
+            fty::AssetImpl asset;
+            asset.setInternalName("ups-batch-" + std::to_string(i));
+            asset.setAssetType(fty::TYPE_DEVICE);
+            asset.setAssetSubtype(fty::SUB_UPS);
+            asset.setAssetStatus(fty::AssetStatus::Nonactive);
+            asset.setParentIname("datacenter-3");
+            asset.setExtEntry("name", "UPS batch " + std::to_string(i));
+            assets.push_back(asset);
+        }
+
+        std::vector<fty::AssetImpl> single(assets);
+        for (auto& asset : single) {
+            asset.create();
+        }
+
+        std::vector<fty::AssetImpl> batch(assets);
+        fty::AssetImpl::createBatch(batch);
+
+        assert (batch.size() == assets.size());
+        for (size_t i = 0; i < batch.size(); i++) {
+            assert (batch[i].getInternalName() == single[i].getInternalName());
+            assert (!batch[i].getExtEntry(fty::EXT_CREATE_TS).empty());
+            assert (!batch[i].getExtEntry(fty::EXT_UUID).empty());
+        }
+
+        // child sent before its parent, both in the batch
+        std::vector<fty::AssetImpl> family(2);
+        family[0].setInternalName("ups-batch-child");
+        family[0].setAssetType(fty::TYPE_DEVICE);
+        family[0].setAssetSubtype(fty::SUB_UPS);
+        family[0].setParentIname("rack-batch");
+        family[1].setInternalName("rack-batch");
+        family[1].setAssetType(fty::TYPE_RACK);
+        family[1].setParentIname("datacenter-3");
+        fty::AssetImpl::createBatch(family);
+        assert (family[0].getParentIname() == family[1].getInternalName());
+        assert (family[1].getParentIname() == "datacenter-3");
+        assert (family[0].getExtEntry(fty::EXT_CREATE_TS) == family[1].getExtEntry(fty::EXT_CREATE_TS));
+
+        log_info("fty-asset-server-test:Test #31: OK");
+    }
+
+    // Test #32: uuids of a GET_MANY request resolved at once
+    {
+        log_debug("fty-asset-server-test:Test #32");
+
+        auto inames = fty::AssetImpl::getInamesFromUuids({"uuid-1", "uuid-2"});
+        assert (inames.size() == 2);
+        assert (inames["uuid-1"] == "DC-1");
+        assert (inames["uuid-2"] == "DC-1");
+
+        log_info("fty-asset-server-test:Test #32: OK");
+    }
+
+    // Test #33: SRR save streamed by chunks
+    {
+        log_debug("fty-asset-server-test:Test #33");
+
+        // same document as the assets serialized all at once, across several chunks
+        {
+            std::vector<std::string> inames;
+            for (size_t i = 0; i < 250; i++) {
+                inames.push_back("srr-" + std::to_string(i));
+            }
+
+            std::ostringstream out;
+            fty::AssetImpl::assetsToSrr(inames, out);
+
+            cxxtools::SerializationInfo expected;
+            for (const auto& iname : inames) {
+                cxxtools::SerializationInfo& si = expected.addMember("");
+                fty::AssetImpl::assetToSrr(fty::AssetImpl(iname), si);
+                si.setCategory(cxxtools::SerializationInfo::Category::Object);
+            }
+            expected.setCategory(cxxtools::SerializationInfo::Category::Array);
+            assert (out.str() == JSON::writeToString(expected, false));
+
+            cxxtools::SerializationInfo saved;
+            JSON::readFromString(out.str(), saved);
+            assert (saved.memberCount() == inames.size());
+            size_t i = 0;
+            for (const auto& si : saved) {
+                fty::AssetImpl asset;
+                fty::AssetImpl::srrToAsset(si, asset);
+                assert (asset.getInternalName() == inames[i]);
+                assert (asset.getAssetSubtype() == fty::SUB_UPS);
+                assert (asset.getExtEntry("name") == "My Asset");
+                i++;
+            }
+        }
+
+        log_info("fty-asset-server-test:Test #33: OK");
+    }
+
+    // Test #34: restore order of deep and wide hierarchies
+    {
+        log_debug("fty-asset-server-test:Test #34");
+
+        const int count = 2000;
+
+        // deep: one chain, listed children first
+        std::vector<fty::AssetImpl> deep(count);
+        for (int i = 0; i < count; i++) {
+            int level = count - 1 - i;
+            deep[i].setInternalName("deep-" + std::to_string(level));
+            deep[i].setParentIname(level == 0 ? "" : "deep-" + std::to_string(level - 1));
+        }
+
+        // wide: 100 datacenters of 19 children, listed children first
+        std::vector<fty::AssetImpl> wide(count);
+        for (int i = 0; i < count; i++) {
+            if (i < count - 100) {
+                wide[i].setInternalName("wide-child-" + std::to_string(i));
+                wide[i].setParentIname("wide-dc-" + std::to_string(i % 100));
+            } else {
+                wide[i].setInternalName("wide-dc-" + std::to_string(i - (count - 100)));
+            }
+        }
+
+        for (auto* assets : {&deep, &wide}) {
+            fty::AssetImpl::sortParentsFirst(*assets);
+
+            assert (assets->size() == size_t(count));
+            std::set<std::string> restored;
+            for (const auto& asset : *assets) {
+                assert (asset.getParentIname().empty() || restored.count(asset.getParentIname()));
+                restored.insert(asset.getInternalName());
+            }
+        }
+
+        log_info("fty-asset-server-test:Test #34: OK");
+    }
+
+    // Test #35: bulk restore, one insert per level, one activation request per device and one link pass
+    {
+        log_debug("fty-asset-server-test:Test #35");
+
+        std::vector<fty::AssetImpl> assets(3);
+        assets[0].setInternalName("datacenter-35");
+        assets[1].setInternalName("room-35");
+        assets[1].setParentIname("datacenter-35");
+        assets[2].setInternalName("ups-35");
+        assets[2].setParentIname("room-35");
+        assets[2].setAssetType(fty::TYPE_DEVICE);
+        assets[2].setAssetSubtype(fty::SUB_UPS);
+        assets[2].addLink("datacenter-35", "", "", 1, {});
+
+        auto restored = fty::AssetImpl::restoreBatch(assets);
+        assert (restored == std::vector<bool>(3, true));
+        assert (!assets[2].getExtEntry(fty::EXT_CREATE_TS).empty());
+
+        std::vector<fty::AssetImpl*> toActivate = {&assets[2]};
+        assert (fty::AssetImpl::activateBatch(toActivate) == std::vector<bool>{true});
+        assert (assets[2].getAssetStatus() == fty::AssetStatus::Active);
+
+        // the activator takes one asset per request, a refused device does not stop the others
+        std::vector<fty::AssetImpl> devices(4);
+        for (size_t i = 0; i < devices.size(); i++) {
+            devices[i].setInternalName("ups-35-" + std::to_string(i));
+            devices[i].setAssetType(fty::TYPE_DEVICE);
+            devices[i].setAssetSubtype(fty::SUB_UPS);
+        }
+        devices[3].setInternalName("room-35-3");
+        devices[3].setAssetType(fty::TYPE_ROOM);
+        devices[3].setAssetSubtype("");
+
+        // second request is refused
+        std::vector<std::pair<std::string, std::string>> requests; // command, asset
+        auto request = [&requests](const std::string& command, const std::vector<std::string>& frames) {
+            assert (frames.size() == 1);
+            requests.emplace_back(command, frames[0]);
+            if (requests.size() == 2) {
+                throw std::runtime_error("Licensing limitation hit");
+            }
+            return std::vector<std::string>{"OK"};
+        };
+
+        std::vector<fty::AssetImpl*> batch = {&devices[0], &devices[1], &devices[2], &devices[3]};
+        auto activated = fty::AssetImpl::activateBatch(batch, request);
+        assert ((activated == std::vector<bool>{true, false, true, true}));
+        assert (requests.size() == 3);
+        for (size_t i = 0; i < requests.size(); i++) {
+            assert (requests[i].first == "ACTIVATE_ASSET");
+            assert (requests[i].second.find("ups-35-" + std::to_string(i)) != std::string::npos);
+        }
+        assert (devices[0].getAssetStatus() == fty::AssetStatus::Active);
+        assert (devices[1].getAssetStatus() != fty::AssetStatus::Active);
+        assert (devices[3].getAssetStatus() == fty::AssetStatus::Active);
+
+        requests.clear();
+        auto deactivated = fty::AssetImpl::deactivateBatch(batch, request);
+        assert ((deactivated == std::vector<bool>{true, false, true, true}));
+        assert (requests.size() == 3);
+        assert (requests[0].first == "DEACTIVATE_ASSET");
+        assert (devices[0].getAssetStatus() == fty::AssetStatus::Nonactive);
+
+        fty::AssetImpl::restoreLinksBatch({&assets[0], &assets[1], &assets[2]});
+
+        log_info("fty-asset-server-test:Test #35: OK");
+    }
+
+    // Test #36: deletion order from the depths of the assets, children first
+    {
+        log_debug("fty-asset-server-test:Test #36");
+
+        auto deleted = fty::AssetImpl::deleteList({"asset-36", "child-1"}, false);
+        assert (deleted.size() == 2);
+        assert (deleted[0].first.getInternalName() == "child-1");
+        assert (deleted[1].first.getInternalName() == "asset-36");
+
+        log_info("fty-asset-server-test:Test #36: OK");
+    }
+
+    // Test #37: 8 threads sharing pools of 1 to 8 connections, as many concurrent queries as connections
+    {
+        log_debug("fty-asset-server-test:Test #37");
+
+        // queries of the first connections wait until all connections of the pool are in use, so a pool
+        // which would not hand out all of them fails on the timeout; later queries do not wait
+        struct Usage
+        {
+            std::mutex              lock;
+            std::condition_variable changed;
+            int                     active  = 0;
+            int                     peak    = 0;
+            int                     target  = 0;
+            bool                    reached = false;
+        };
+        Usage usage;
+
+        struct CountedConnection
+        {
+            Usage* usage;
+
+            void query()
+            {
+                std::unique_lock<std::mutex> lock(usage->lock);
+                usage->active++;
+                usage->peak = std::max(usage->peak, usage->active);
+                if (usage->active >= usage->target) {
+                    usage->reached = true;
+                    usage->changed.notify_all();
+                }
+                bool reached = usage->changed.wait_for(lock, std::chrono::seconds(5), [this] {
+                    return usage->reached;
+                });
+                assert (reached);
+                usage->active--;
+            }
+        };
+
+        std::atomic<int>                       opened{0};
+        fty::ConnectionPool<CountedConnection> pool([&opened, &usage] {
+            opened++;
+            return CountedConnection{&usage};
+        });
+
+        for (int size : {1, 2, 4, 8}) {
+            pool.setSize(size_t(size));
+            {
+                std::unique_lock<std::mutex> lock(usage.lock);
+                usage.peak    = 0;
+                usage.target  = size;
+                usage.reached = false;
+            }
+
+            std::vector<std::thread> threads;
+            for (int t = 0; t < 8; t++) {
+                threads.emplace_back([&pool] {
+                    for (int i = 0; i < 10; i++) {
+                        fty::ConnectionPool<CountedConnection>::Lease lease(pool);
+                        // nested operations of a thread get its connection
+                        fty::ConnectionPool<CountedConnection>::Lease nested(pool);
+                        assert (&nested.connection() == &lease.connection());
+                        lease.connection().query();
+                    }
+                });
+            }
+            for (auto& thread : threads) {
+                thread.join();
+            }
+
+            log_info("fty-asset-server-test:Test #37: pool of %d, at most %d concurrent queries", size, usage.peak);
+            // every connection is used, never more
+            assert (usage.peak == size);
+            assert (opened == size);
+        }
+
+        // a connection failing its check is opened again, when borrowed or after an operation threw
+        struct CheckedConnection
+        {
+            bool alive = true;
+        };
+        int                                    reopened = 0;
+        fty::ConnectionPool<CheckedConnection> checked(
+            [&reopened] {
+                reopened++;
+                return CheckedConnection();
+            },
+            1,
+            [](CheckedConnection& conn) {
+                return conn.alive;
+            });
+        {
+            fty::ConnectionPool<CheckedConnection>::Lease lease(checked);
+            lease.connection().alive = false;
+        }
+        {
+            fty::ConnectionPool<CheckedConnection>::Lease lease(checked);
+            assert (lease.connection().alive);
+        }
+        assert (reopened == 2);
+        try {
+            fty::ConnectionPool<CheckedConnection>::Lease lease(checked);
+            lease.connection().alive = false;
+            throw std::runtime_error("connection lost");
+        } catch (const std::runtime_error&) {
+        }
+        assert (reopened == 2);
+        {
+            fty::ConnectionPool<CheckedConnection>::Lease lease(checked);
+            assert (lease.connection().alive);
+        }
+        assert (reopened == 3);
+
+        log_info("fty-asset-server-test:Test #37: OK");
+    }
+
+    // Test #38: read-through storage cache, one backend load per asset until it is written
+    {
+        log_debug("fty-asset-server-test:Test #38");
+
+        fty::CachedStorage cache(fty::DBTest::getInstance());
+
+        // first call loads the whole asset, the next ones are hits
+        fty::Asset first;
+        cache.loadAsset("ups-38", first);
+        cache.loadExtMap(first);
+        cache.loadLinkedAssets(first);
+        assert (cache.misses() == 1 && cache.hits() == 2);
+        assert (cache.size() == 1);
+        assert (first.getExtEntry(fty::EXT_NAME) == "My Asset");
+        assert (first.getLinkedAssets().size() == 2);
+
+        fty::Asset second;
+        second.setInternalName("ups-38");
+        assert (cache.loadAssets({&second}) == std::vector<bool>{true});
+        assert (cache.hits() == 3);
+        assert (second == first);
+
+        // uuid of a cached asset is known without the backend, which answers "DC-1"
+        assert (cache.inameByUuid("123-456-789") == "ups-38");
+
+        // written assets are loaded again
+        cache.update(second);
+        assert (cache.size() == 0);
+        cache.loadAsset("ups-38", first);
+        assert (cache.misses() == 2);
+
+        // and dropped again at the end of the transaction writing them
+        cache.beginTransaction();
+        cache.saveExtMap(second);
+        cache.loadAsset("ups-38", first);
+        assert (cache.size() == 1);
+        cache.commitTransaction();
+        assert (cache.size() == 0);
+
+        cache.loadAsset("ups-38", first);
+        cache.removeAsset(first);
+        assert (cache.size() == 0);
+        assert (cache.inameByUuid("123-456-789") == "DC-1");
+
+        cache.loadAsset("ups-38", first);
+        assert (cache.bytes() > 0);
+        cache.setBudget(0);
+        assert (cache.size() == 0 && cache.bytes() == 0);
+
+        log_info("fty-asset-server-test:Test #38: OK");
+    }
+
     zactor_destroy(&autoupdate_server);
     zactor_destroy(&asset_server);
     mlm_client_destroy(&ui);
@@ -0,0 +1,237 @@
+/*  =========================================================================
+    mailbox-worker-pool - pool of workers for read-only mailbox requests
+
+    Copyright (C) 2014 - 2020 Eaton
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+    =========================================================================
+*/
+
+#include "mailbox-worker-pool.h"
+
+#include <czmq.h>
+#include <fty_log.h>
+#include <malamute.h>
+#include <mlm_client.h>
+
+namespace fty {
+
+struct MailboxWorkerPool::Worker
+{
+    zactor_t*                             actor = nullptr;
+    bool                                  busy  = false;
+    std::string                           subject; // subject being handled
+    std::string                           name;
+    const std::map<std::string, Handler>* handlers = nullptr;
+};
+
+// worker gets <subject>/<sender>/<request frames>, sends REPLY/<address>/<subject>/<reply frames>
+// for every reply and answers DONE when the request is handled
+void MailboxWorkerPool::workerActor(zsock_t* pipe, void* args)
+{
+    const Worker* worker = static_cast<const Worker*>(args);
+
+    Send send = [pipe](const char* address, const char* subject, zmsg_t** msg) -> int {
+        zmsg_pushstr(*msg, subject);
+        zmsg_pushstr(*msg, address);
+        zmsg_pushstr(*msg, "REPLY");
+        int rv = zmsg_send(msg, pipe);
+        zmsg_destroy(msg);
+        return rv;
+    };
+    zsock_signal(pipe, 0);
+
+    while (!zsys_interrupted) {
+        zmsg_t* msg = zmsg_recv(pipe);
+        if (!msg) {
+            break;
+        }
+
+        char* subject = zmsg_popstr(msg);
+        if (!subject || streq(subject, "$TERM")) {
+            zstr_free(&subject);
+            zmsg_destroy(&msg);
+            break;
+        }
+        char* sender = zmsg_popstr(msg);
+
+        auto it = worker->handlers->find(subject);
+        if (it != worker->handlers->end()) {
+            try {
+                it->second(send, sender, msg);
+            } catch (const std::exception& e) {
+                log_error("%s:\t%s handler failed: %s", worker->name.c_str(), subject, e.what());
+            }
+        }
+        zmsg_destroy(&msg);
+        zstr_free(&sender);
+        zstr_free(&subject);
+
+        zstr_send(pipe, "DONE");
+    }
+}
+
+MailboxWorkerPool::~MailboxWorkerPool()
+{
+    stop();
+}
+
+void MailboxWorkerPool::addSubject(const std::string& subject, Handler handler)
+{
+    m_handlers[subject] = handler;
+}
+
+void MailboxWorkerPool::setSubjectLimit(const std::string& subject, size_t limit)
+{
+    m_limits[subject] = limit;
+}
+
+void MailboxWorkerPool::start(mlm_client_t* client, const std::string& name)
+{
+    stop();
+
+    m_client = client;
+    for (size_t i = 0; i < m_size; i++) {
+        auto worker      = std::unique_ptr<Worker>(new Worker);
+        worker->name     = name + "-worker-" + std::to_string(i);
+        worker->handlers = &m_handlers;
+        worker->actor    = zactor_new(workerActor, worker.get());
+        m_workers.push_back(std::move(worker));
+    }
+    log_debug("%s:\t%zu mailbox workers started", name.c_str(), m_workers.size());
+}
+
+void MailboxWorkerPool::stop()
+{
+    for (auto& worker : m_workers) {
+        zactor_destroy(&worker->actor);
+    }
+    m_workers.clear();
+    m_running.clear();
+
+    for (auto& request : m_pending) {
+        zmsg_destroy(&request.msg);
+    }
+    m_pending.clear();
+}
+
+bool MailboxWorkerPool::handles(const std::string& subject) const
+{
+    return !m_workers.empty() && m_handlers.count(subject) > 0;
+}
+
+void MailboxWorkerPool::dispatch(const std::string& subject, const std::string& sender, zmsg_t** msg)
+{
+    m_pending.push_back({subject, sender, *msg});
+    *msg = nullptr;
+    schedule();
+}
+
+std::vector<zsock_t*> MailboxWorkerPool::sockets() const
+{
+    std::vector<zsock_t*> socks;
+    for (const auto& worker : m_workers) {
+        socks.push_back(zactor_sock(worker->actor));
+    }
+    return socks;
+}
+
+bool MailboxWorkerPool::onWorker(void* which)
+{
+    for (auto& worker : m_workers) {
+        if (which != zactor_sock(worker->actor)) {
+            continue;
+        }
+
+        zmsg_t* msg  = zmsg_recv(worker->actor);
+        char*   kind = msg ? zmsg_popstr(msg) : nullptr;
+        if (kind && streq(kind, "REPLY")) {
+            char* address = zmsg_popstr(msg);
+            char* subject = zmsg_popstr(msg);
+            if (mlm_client_sendto(m_client, address, subject, NULL, 5000, &msg) != 0) {
+                log_error("%s:\tCannot send %s reply to %s", worker->name.c_str(), subject, address);
+            }
+            zmsg_destroy(&msg);
+            zstr_free(&subject);
+            zstr_free(&address);
+            zstr_free(&kind);
+            return true;
+        }
+        zstr_free(&kind);
+        zmsg_destroy(&msg);
+
+        if (worker->busy) {
+            m_running[worker->subject]--;
+            worker->busy = false;
+            worker->subject.clear();
+        }
+        schedule();
+        return true;
+    }
+    return false;
+}
+
+size_t MailboxWorkerPool::peak(const std::string& subject) const
+{
+    auto it = m_peak.find(subject);
+    return it == m_peak.end() ? 0 : it->second;
+}
+
+size_t MailboxWorkerPool::limit(const std::string& subject) const
+{
+    auto it = m_limits.find(subject);
+    return (it == m_limits.end() || it->second == 0) ? m_workers.size() : it->second;
+}
+
+// sends queued requests to idle workers, in order, as long as their subject is below its limit
+void MailboxWorkerPool::schedule()
+{
+    for (auto it = m_pending.begin(); it != m_pending.end();) {
+        Worker* idle = nullptr;
+        for (auto& worker : m_workers) {
+            if (!worker->busy) {
+                idle = worker.get();
+                break;
+            }
+        }
+        if (!idle) {
+            return;
+        }
+
+        if (m_running[it->subject] >= limit(it->subject)) {
+            ++it;
+            continue;
+        }
+
+        zmsg_pushstr(it->msg, it->sender.c_str());
+        zmsg_pushstr(it->msg, it->subject.c_str());
+        if (zmsg_send(&it->msg, idle->actor) != 0) {
+            log_error("Cannot dispatch %s request from %s", it->subject.c_str(), it->sender.c_str());
+            zmsg_destroy(&it->msg);
+            it = m_pending.erase(it);
+            continue;
+        }
+
+        idle->busy    = true;
+        idle->subject = it->subject;
+        size_t running = ++m_running[it->subject];
+        if (running > m_peak[it->subject]) {
+            m_peak[it->subject] = running;
+        }
+        it = m_pending.erase(it);
+    }
+}
+
+} // namespace fty
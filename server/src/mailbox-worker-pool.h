@@ -0,0 +1,118 @@
+/*  =========================================================================
+    mailbox-worker-pool - pool of workers for read-only mailbox requests
+
+    Copyright (C) 2014 - 2020 Eaton
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+    =========================================================================
+*/
+
+#pragma once
+
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+typedef struct _zactor_t     zactor_t;
+typedef struct _zmsg_t       zmsg_t;
+typedef struct _zsock_t      zsock_t;
+typedef struct _mlm_client_t mlm_client_t;
+
+namespace fty {
+
+// Bounded pool of actors handling read-only mailbox subjects of the legacy interface.
+// Requests are handled concurrently while the owner actor keeps doing the serialized work
+// (writes, stream). Replies are passed back to the owner and sent by its malamute client,
+// so that clients get them from the address they sent the request to.
+// Requests over the pool size or over the limit of their subject wait in a queue.
+class MailboxWorkerPool
+{
+public:
+    // sends msg to address with subject, takes ownership of msg, returns 0 on success
+    using Send = std::function<int(const char* address, const char* subject, zmsg_t** msg)>;
+    // called in a worker thread, replies are sent to sender through send
+    using Handler = std::function<void(const Send& send, const char* sender, zmsg_t* msg)>;
+
+    MailboxWorkerPool() = default;
+    ~MailboxWorkerPool();
+
+    MailboxWorkerPool(const MailboxWorkerPool&) = delete;
+    MailboxWorkerPool& operator=(const MailboxWorkerPool&) = delete;
+
+    // subjects must be registered before start()
+    void addSubject(const std::string& subject, Handler handler);
+
+    // max number of requests of subject handled at once, 0 means pool size
+    void setSubjectLimit(const std::string& subject, size_t limit);
+
+    void setSize(size_t size)
+    {
+        m_size = size;
+    }
+
+    size_t getSize() const
+    {
+        return m_size;
+    }
+
+    // starts workers, their replies are sent through client, which must be polled by the owner only
+    void start(mlm_client_t* client, const std::string& name);
+    void stop();
+
+    // true if subject is handled by running workers
+    bool handles(const std::string& subject) const;
+
+    // queues request and sends it to a worker when possible, takes ownership of msg
+    void dispatch(const std::string& subject, const std::string& sender, zmsg_t** msg);
+
+    // sockets of the workers, to be polled by the owner
+    std::vector<zsock_t*> sockets() const;
+
+    // handles message coming from a worker socket (reply to send or end of a request),
+    // returns false if which is not a worker
+    bool onWorker(void* which);
+
+    // max number of requests of subject handled at once so far
+    size_t peak(const std::string& subject) const;
+
+private:
+    struct Worker;
+
+    struct Request
+    {
+        std::string subject;
+        std::string sender;
+        zmsg_t*     msg;
+    };
+
+    size_t                               m_size   = 4;
+    mlm_client_t*                        m_client = nullptr;
+    std::map<std::string, Handler>       m_handlers;
+    std::map<std::string, size_t>        m_limits;
+    std::map<std::string, size_t>        m_running;
+    std::map<std::string, size_t>        m_peak;
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    std::deque<Request>                  m_pending;
+
+    void   schedule();
+    size_t limit(const std::string& subject) const;
+
+    static void workerActor(zsock_t* pipe, void* args);
+};
+
+} // namespace fty
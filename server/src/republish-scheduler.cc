@@ -0,0 +1,93 @@
+/*  =========================================================================
+    republish-scheduler - pacing of the periodic ASSETS republish
+
+    Copyright (C) 2014 - 2020 Eaton
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+    =========================================================================
+*/
+
+#include "republish-scheduler.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace fty {
+
+void RepublishScheduler::start(size_t count, int64_t now)
+{
+    m_remaining = count;
+    m_last      = now;
+    // first slice goes immediately
+    m_tokens    = static_cast<double>(m_sliceSize);
+    m_cycleRate = m_rate;
+
+    // do not let a cycle overlap the next one
+    if (m_cycleRate > 0 && m_interval > 0) {
+        m_cycleRate = std::max(m_cycleRate, static_cast<double>(count) / m_interval);
+    }
+}
+
+void RepublishScheduler::refill(int64_t now)
+{
+    if (now > m_last) {
+        m_tokens = std::min(static_cast<double>(m_sliceSize), m_tokens + m_cycleRate * (now - m_last) / 1000.0);
+        m_last   = now;
+    }
+}
+
+size_t RepublishScheduler::take(int64_t now)
+{
+    if (!pending()) {
+        return 0;
+    }
+
+    size_t count;
+    if (m_cycleRate <= 0) {
+        count = std::min(m_sliceSize, m_remaining);
+    } else {
+        refill(now);
+        count = std::min(m_sliceSize, m_remaining);
+        if (m_tokens < static_cast<double>(count)) {
+            return 0;
+        }
+        m_tokens -= static_cast<double>(count);
+    }
+    m_remaining -= count;
+    return count;
+}
+
+int RepublishScheduler::timeout(int64_t now) const
+{
+    if (!pending()) {
+        return -1;
+    }
+    if (m_cycleRate <= 0) {
+        return 0;
+    }
+
+    double tokens = m_tokens;
+    if (now > m_last) {
+        tokens += m_cycleRate * (now - m_last) / 1000.0;
+    }
+    // wait for a whole slice rather than sending assets one by one
+    double needed = static_cast<double>(std::min(m_sliceSize, m_remaining));
+    if (tokens >= needed) {
+        return 0;
+    }
+    return static_cast<int>(std::ceil((needed - tokens) * 1000.0 / m_cycleRate));
+}
+
+} // namespace fty
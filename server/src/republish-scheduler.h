@@ -0,0 +1,91 @@
+/*  =========================================================================
+    republish-scheduler - pacing of the periodic ASSETS republish
+
+    Copyright (C) 2014 - 2020 Eaton
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+    =========================================================================
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace fty {
+
+// Splits a republish cycle into slices emitted on a token bucket schedule,
+// so the actor can handle mailbox and stream events between two slices.
+// Time is given by the caller (monotonic, in ms).
+class RepublishScheduler
+{
+public:
+    // assets per second, 0 means no pacing (slices are sent back to back)
+    void setRate(double rate)
+    {
+        m_rate = rate;
+    }
+
+    double getRate() const
+    {
+        return m_rate;
+    }
+
+    // maximum number of assets sent at once
+    void setSliceSize(size_t size)
+    {
+        m_sliceSize = size ? size : 1;
+    }
+
+    size_t getSliceSize() const
+    {
+        return m_sliceSize;
+    }
+
+    // repeat interval in seconds, a cycle is always paced to end within it
+    void setInterval(int seconds)
+    {
+        m_interval = seconds;
+    }
+
+    // starts a new cycle of count assets, the rest of a previous cycle is dropped
+    void start(size_t count, int64_t now);
+
+    // true if some assets of the current cycle were not sent yet
+    bool pending() const
+    {
+        return m_remaining > 0;
+    }
+
+    // number of assets which can be sent now, consumed from the bucket
+    size_t take(int64_t now);
+
+    // ms until the next slice can be sent, -1 if nothing is pending
+    int timeout(int64_t now) const;
+
+private:
+    double  m_rate      = 100.0;
+    size_t  m_sliceSize = 50;
+    int     m_interval  = 0;
+
+    double  m_cycleRate = 0.0;
+    double  m_tokens    = 0.0;
+    int64_t m_last      = 0;
+    size_t  m_remaining = 0;
+
+    void refill(int64_t now);
+};
+
+} // namespace fty
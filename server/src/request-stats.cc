@@ -0,0 +1,108 @@
+/*  =========================================================================
+    request-stats - latency statistics of handled requests
+
+    Copyright (C) 2014 - 2020 Eaton
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+    =========================================================================
+*/
+
+#include "request-stats.h"
+
+namespace fty {
+
+thread_local uint64_t RequestStats::s_dbQueries = 0;
+
+// values below 8 have their own bucket, above the 3 bits after the most significant one select the bucket
+size_t RequestStats::bucket(uint64_t usecs)
+{
+    if (usecs < 8) {
+        return static_cast<size_t>(usecs);
+    }
+    size_t msb = 63 - static_cast<size_t>(__builtin_clzll(usecs));
+    size_t idx = (msb - 2) * 8 + ((usecs >> (msb - 3)) & 7);
+    return idx < BUCKETS ? idx : BUCKETS - 1;
+}
+
+// lowest value of bucket
+uint64_t RequestStats::bucketValue(size_t bucket)
+{
+    if (bucket < 8) {
+        return bucket;
+    }
+    size_t msb = bucket / 8 + 2;
+    return (uint64_t(8) | (bucket % 8)) << (msb - 3);
+}
+
+uint64_t RequestStats::Histogram::percentile(double p) const
+{
+    if (count == 0) {
+        return 0;
+    }
+    uint64_t rank = static_cast<uint64_t>(p * static_cast<double>(count) / 100.0);
+    if (rank >= count) {
+        rank = count - 1;
+    }
+    uint64_t seen = 0;
+    for (size_t i = 0; i < BUCKETS; i++) {
+        seen += buckets[i];
+        if (seen > rank) {
+            uint64_t value = bucketValue(i);
+            return value < max ? value : max;
+        }
+    }
+    return max;
+}
+
+void RequestStats::record(const std::string& subject, uint64_t usecs, uint64_t dbQueries)
+{
+    // plain lock_guard, fty::Lock logs on every request
+    std::lock_guard<std::mutex> lock(m_lock);
+
+    Histogram& histogram = m_histograms[subject];
+    histogram.count++;
+    histogram.dbQueries += dbQueries;
+    if (usecs > histogram.max) {
+        histogram.max = usecs;
+    }
+    histogram.buckets[bucket(usecs)]++;
+}
+
+std::vector<RequestStats::Summary> RequestStats::summaries() const
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+
+    std::vector<Summary> result;
+    for (const auto& it : m_histograms) {
+        Summary summary;
+        summary.subject   = it.first;
+        summary.count     = it.second.count;
+        summary.p50       = it.second.percentile(50);
+        summary.p90       = it.second.percentile(90);
+        summary.p99       = it.second.percentile(99);
+        summary.max       = it.second.max;
+        summary.dbQueries = it.second.dbQueries;
+        result.push_back(summary);
+    }
+    return result;
+}
+
+void RequestStats::reset()
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    m_histograms.clear();
+}
+
+} // namespace fty
@@ -0,0 +1,132 @@
+/*  =========================================================================
+    request-stats - latency statistics of handled requests
+
+    Copyright (C) 2014 - 2020 Eaton
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+    =========================================================================
+*/
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace fty {
+
+// Count, latency histogram and DB round trips of handled requests, by subject.
+// Latencies are kept in log-linear buckets (8 buckets per power of two), so a percentile
+// is known within 12.5% with a fixed memory per subject. The histogram of a subject is allocated
+// when its first request is recorded, the next requests do not allocate.
+class RequestStats
+{
+public:
+    struct Summary
+    {
+        std::string subject;
+        uint64_t    count     = 0;
+        uint64_t    p50       = 0; // us
+        uint64_t    p90       = 0;
+        uint64_t    p99       = 0;
+        uint64_t    max       = 0;
+        uint64_t    dbQueries = 0;
+    };
+
+    void record(const std::string& subject, uint64_t usecs, uint64_t dbQueries);
+
+    // summary of every subject, by subject name
+    std::vector<Summary> summaries() const;
+
+    void reset();
+
+    // to be called on every executed DB statement (see CountedStatement), counted for the request
+    // handled by the current thread
+    static void countDbQuery()
+    {
+        s_dbQueries++;
+    }
+
+    static uint64_t dbQueries()
+    {
+        return s_dbQueries;
+    }
+
+    static size_t   bucket(uint64_t usecs);
+    static uint64_t bucketValue(size_t bucket);
+
+private:
+    static const size_t BUCKETS = 62 * 8;
+
+    struct Histogram
+    {
+        uint64_t                      count     = 0;
+        uint64_t                      max       = 0;
+        uint64_t                      dbQueries = 0;
+        std::array<uint64_t, BUCKETS> buckets{};
+
+        uint64_t percentile(double p) const;
+    };
+
+    static thread_local uint64_t s_dbQueries;
+
+    mutable std::mutex               m_lock;
+    std::map<std::string, Histogram> m_histograms;
+};
+
+// Records duration and DB queries of a request from its construction to its destruction
+class RequestTimer
+{
+public:
+    RequestTimer(RequestStats& stats, const std::string& subject)
+        : m_stats(stats)
+        , m_subject(subject)
+        , m_start(std::chrono::steady_clock::now())
+        , m_dbQueries(RequestStats::dbQueries())
+    {
+    }
+
+    ~RequestTimer()
+    {
+        if (m_cancelled) {
+            return;
+        }
+        auto usecs = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - m_start).count();
+        m_stats.record(m_subject, static_cast<uint64_t>(usecs), RequestStats::dbQueries() - m_dbQueries);
+    }
+
+    // request is not recorded, ie. unknown subject
+    void cancel()
+    {
+        m_cancelled = true;
+    }
+
+    RequestTimer(const RequestTimer&) = delete;
+    RequestTimer& operator=(const RequestTimer&) = delete;
+
+private:
+    RequestStats&                         m_stats;
+    std::string                           m_subject;
+    std::chrono::steady_clock::time_point m_start;
+    uint64_t                              m_dbQueries;
+    bool                                  m_cancelled = false;
+};
+
+} // namespace fty
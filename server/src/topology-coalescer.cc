@@ -0,0 +1,51 @@
+/*  =========================================================================
+    topology-coalescer - coalescing of container updates
+
+    Copyright (C) 2014 - 2020 Eaton
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+    =========================================================================
+*/
+
+#include "topology-coalescer.h"
+
+namespace fty {
+
+void TopologyCoalescer::add(const std::string& container, int64_t now)
+{
+    if (m_updates.empty()) {
+        m_deadline = now + m_window;
+    }
+    m_updates[container].count++;
+}
+
+int TopologyCoalescer::timeout(int64_t now) const
+{
+    if (m_updates.empty()) {
+        return -1;
+    }
+    return m_deadline > now ? static_cast<int>(m_deadline - now) : 0;
+}
+
+TopologyCoalescer::Updates TopologyCoalescer::take(int64_t now)
+{
+    Updates updates;
+    if (!m_updates.empty() && now >= m_deadline) {
+        updates.swap(m_updates);
+    }
+    return updates;
+}
+
+} // namespace fty
@@ -0,0 +1,87 @@
+/*  =========================================================================
+    topology-coalescer - coalescing of container updates
+
+    Copyright (C) 2014 - 2020 Eaton
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+    =========================================================================
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+
+namespace fty {
+
+// Collects updated containers over a short window, so a burst of updates of the same containers
+// republishes their contents once. Window starts with the first update and is not extended by
+// the next ones, an update is never delayed more than the window.
+// Time is given by the caller (monotonic, in ms).
+class TopologyCoalescer
+{
+public:
+    struct Update
+    {
+        size_t count = 0; // number of updates received in the window
+    };
+
+    using Updates = std::map<std::string, Update>;
+
+    // window in ms, 0 means updates are handled right away
+    void setWindow(int ms)
+    {
+        m_window = ms > 0 ? ms : 0;
+    }
+
+    int getWindow() const
+    {
+        return m_window;
+    }
+
+    void add(const std::string& container, int64_t now);
+
+    bool pending() const
+    {
+        return !m_updates.empty();
+    }
+
+    // ms until the collected updates are due, -1 if nothing is pending
+    int timeout(int64_t now) const;
+
+    // collected updates if the window is over, empty otherwise
+    Updates take(int64_t now);
+
+    // republishes avoided by coalescing
+    void addSuppressed(size_t count)
+    {
+        m_suppressed += count;
+    }
+
+    uint64_t getSuppressed() const
+    {
+        return m_suppressed;
+    }
+
+private:
+    int      m_window     = 200;
+    int64_t  m_deadline   = 0;
+    uint64_t m_suppressed = 0;
+    Updates  m_updates;
+};
+
+} // namespace fty
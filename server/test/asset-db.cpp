@@ -0,0 +1,202 @@
+#include "asset-db.h"
+#include "request-stats.h"
+#include <catch2/catch.hpp>
+#include <cstdlib>
+#include <fty_asset_dto.h>
+#include <fty_common_db_dbpath.h>
+#include <test-db/sample-db.h>
+#include <thread>
+
+TEST_CASE("Load assets in bulk")
+{
+    fty::SampleDb db(R"(
+        items:
+            - type     : Datacenter
+              name     : load-dc
+              ext-name : Data Center
+              attrs :
+                  contact_name : John
+              items :
+                  - type     : Feed
+                    name     : load-feed
+                    ext-name : Feed
+                  - type     : Ups
+                    name     : load-ups
+                    ext-name : Ups
+                    attrs :
+                        serial_no : SN1
+                        model     : M1
+        links:
+            - dest : load-ups
+              src  : load-feed
+              type : power chain
+    )");
+    DBConn::url = getenv("DBURL");
+
+    fty::DB& storage = fty::DB::getInstance();
+
+    std::vector<std::string> inames = {"load-ups", "load-dc", "load-missing", "load-feed"};
+
+    std::vector<fty::Asset> single;
+    for (const auto& iname : inames) {
+        fty::Asset asset;
+        if (iname != "load-missing") {
+            storage.loadAsset(iname, asset);
+            storage.loadExtMap(asset);
+            storage.loadLinkedAssets(asset);
+        }
+        single.push_back(asset);
+    }
+
+    std::vector<fty::Asset>  bulk(inames.size());
+    std::vector<fty::Asset*> ptrs;
+    for (size_t i = 0; i < inames.size(); i++) {
+        bulk[i].setInternalName(inames[i]);
+        ptrs.push_back(&bulk[i]);
+    }
+
+    uint64_t          queries = fty::RequestStats::dbQueries();
+    std::vector<bool> found   = storage.loadAssets(ptrs);
+    // elements, ext attributes, links and link attributes
+    CHECK(fty::RequestStats::dbQueries() - queries == 4);
+
+    REQUIRE(found == std::vector<bool>{true, true, false, true});
+    for (size_t i = 0; i < inames.size(); i++) {
+        if (found[i]) {
+            CHECK(bulk[i] == single[i]);
+        }
+    }
+
+    CHECK(bulk[0].getParentIname() == "load-dc");
+    CHECK(bulk[0].getExtEntry("serial_no") == "SN1");
+    REQUIRE(bulk[0].getLinkedAssets().size() == 1);
+    CHECK(bulk[0].getLinkedAssets()[0].sourceId() == "load-feed");
+    CHECK(bulk[1].getExtEntry("contact_name") == "John");
+    CHECK(bulk[3].getAssetSubtype() == "feed");
+
+    // names are matched as the database compares them, each requested asset gets its own row
+    fty::Asset upper;
+    fty::Asset spaced;
+    fty::Asset feed;
+    upper.setInternalName("LOAD-UPS");
+    spaced.setInternalName("load-dc ");
+    feed.setInternalName("load-feed");
+    REQUIRE(storage.loadAssets({&feed, &upper, &spaced}) == std::vector<bool>{true, true, true});
+    CHECK(feed.getAssetSubtype() == "feed");
+    CHECK(upper.getInternalName() == "load-ups");
+    CHECK(upper.getExtEntry("serial_no") == "SN1");
+    CHECK(spaced.getInternalName() == "load-dc");
+    CHECK(spaced.getExtEntry("contact_name") == "John");
+}
+
+TEST_CASE("Transaction on a pool of connections")
+{
+    fty::SampleDb db(R"(
+        items:
+            - type     : Datacenter
+              name     : trans-dc
+              ext-name : Transaction DC
+    )");
+    DBConn::url = getenv("DBURL");
+
+    fty::DB& storage = fty::DB::getInstance();
+    storage.setPoolSize(2);
+
+    fty::Asset asset;
+    asset.setInternalName("trans-room");
+    asset.setAssetType("room");
+    asset.setAssetSubtype("N_A");
+    asset.setAssetStatus(fty::AssetStatus::Nonactive);
+    asset.setParentIname("trans-dc");
+
+    // visible only from the connection of the transaction
+    auto seenByOtherThread = [&storage] {
+        bool seen = false;
+        std::thread other([&storage, &seen] {
+            seen = bool(storage.getID("trans-room"));
+        });
+        other.join();
+        return seen;
+    };
+
+    SECTION("rollback")
+    {
+        storage.beginTransaction();
+        storage.insert(asset);
+        CHECK(storage.getID("trans-room"));
+        CHECK(!seenByOtherThread());
+        storage.rollbackTransaction();
+
+        CHECK(!storage.getID("trans-room"));
+    }
+
+    SECTION("commit")
+    {
+        storage.beginTransaction();
+        storage.insert(asset);
+        CHECK(!seenByOtherThread());
+        storage.commitTransaction();
+
+        CHECK(storage.getID("trans-room"));
+        CHECK(seenByOtherThread());
+        storage.removeAsset(asset);
+    }
+}
+
+TEST_CASE("Type ids")
+{
+    DBConn::url = getenv("DBURL");
+
+    fty::DB& storage = fty::DB::getInstance();
+    storage.refreshTypes();
+
+    uint64_t queries = fty::RequestStats::dbQueries();
+    CHECK(storage.getTypeID("datacenter") != 0);
+    CHECK(storage.getSubtypeID("ups") != 0);
+    // empty and unknown names are not read again from the database just after the types were read
+    CHECK(storage.getTypeID("") == 0);
+    CHECK(storage.getSubtypeID("") == 0);
+    CHECK(storage.getTypeID("unknown-type") == 0);
+    CHECK(storage.getSubtypeID("unknown-subtype") == 0);
+    CHECK(fty::RequestStats::dbQueries() == queries);
+}
+
+TEST_CASE("Lists padded to a power of two")
+{
+    fty::SampleDb db(R"(
+        items:
+            - type     : Datacenter
+              name     : pad-dc
+              ext-name : Pad DC
+              items :
+                  - type     : Rack
+                    name     : pad-rack-1
+                    ext-name : Pad rack 1
+                  - type     : Rack
+                    name     : pad-rack-2
+                    ext-name : Pad rack 2
+    )");
+    DBConn::url = getenv("DBURL");
+
+    fty::DB& storage = fty::DB::getInstance();
+
+    // three values bound as four, the last one twice
+    fty::Asset               assets[3];
+    std::vector<fty::Asset*> ptrs;
+    std::vector<std::string> inames = {"pad-missing", "pad-rack-2", "pad-rack-1"};
+    for (size_t i = 0; i < inames.size(); i++) {
+        assets[i].setInternalName(inames[i]);
+        ptrs.push_back(&assets[i]);
+    }
+    CHECK(storage.loadAssets(ptrs) == std::vector<bool>{false, true, true});
+
+    CHECK(storage.verifyIDs({"pad-rack-1", "pad-missing", "pad-rack-2"}) == std::vector<bool>{false, true, false});
+
+    storage.updateStatus({"pad-dc", "pad-rack-1", "pad-rack-2"}, fty::AssetStatus::Nonactive);
+    fty::Asset dc;
+    storage.loadAsset("pad-dc", dc);
+    CHECK(dc.getAssetStatus() == fty::AssetStatus::Nonactive);
+    fty::Asset rack;
+    storage.loadAsset("pad-rack-2", rack);
+    CHECK(rack.getAssetStatus() == fty::AssetStatus::Nonactive);
+}
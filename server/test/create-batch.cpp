@@ -0,0 +1,64 @@
+#include "asset.h"
+#include <catch2/catch.hpp>
+#include <cstdlib>
+#include <fty_common_asset_types.h>
+#include <fty_common_db_dbpath.h>
+#include <test-db/sample-db.h>
+
+static fty::AssetImpl batchAsset(
+    const std::string& name, const std::string& type, const std::string& subtype, const std::string& parent)
+{
+    fty::AssetImpl asset;
+    asset.setInternalName(name);
+    asset.setAssetType(type);
+    asset.setAssetSubtype(subtype);
+    asset.setAssetStatus(fty::AssetStatus::Nonactive);
+    asset.setParentIname(parent);
+    asset.setExtEntry("name", name);
+    return asset;
+}
+
+TEST_CASE("Create batch")
+{
+    fty::SampleDb db(R"(
+        items:
+            - type     : Datacenter
+              name     : batch-dc
+              ext-name : Batch DC
+    )");
+    DBConn::url = getenv("DBURL");
+
+    // child before its parent, powered by a feed of the batch
+    std::vector<fty::AssetImpl> batch;
+    batch.push_back(batchAsset("new-ups", fty::TYPE_DEVICE, fty::SUB_UPS, "new-rack"));
+    batch.push_back(batchAsset("new-rack", fty::TYPE_RACK, "N_A", "batch-dc"));
+    batch.push_back(batchAsset("new-feed", fty::TYPE_DEVICE, "feed", "batch-dc"));
+    batch[0].addLink("new-feed", "", "", 1);
+
+    fty::AssetImpl::createBatch(batch);
+
+    const std::string& ups  = batch[0].getInternalName();
+    const std::string& rack = batch[1].getInternalName();
+    const std::string& feed = batch[2].getInternalName();
+    CHECK(ups.rfind("ups-", 0) == 0);
+    CHECK(rack.rfind("rack-", 0) == 0);
+    CHECK(feed.rfind("feed-", 0) == 0);
+
+    // references to names of the batch are renamed
+    CHECK(batch[0].getParentIname() == rack);
+    REQUIRE(batch[0].getLinkedAssets().size() == 1);
+    CHECK(batch[0].getLinkedAssets()[0].sourceId() == feed);
+
+    std::vector<fty::AssetImpl> loaded = fty::AssetImpl::loadList({ups, rack, feed});
+    REQUIRE(loaded.size() == 3);
+    CHECK(loaded[0].getParentIname() == rack);
+    CHECK(loaded[0].getExtEntry("name") == "new-ups");
+    CHECK(!loaded[0].getExtEntry(fty::EXT_UUID).empty());
+    REQUIRE(loaded[0].getLinkedAssets().size() == 1);
+    CHECK(loaded[0].getLinkedAssets()[0].sourceId() == feed);
+    CHECK(loaded[1].getParentIname() == "batch-dc");
+    CHECK(loaded[2].getParentIname() == "batch-dc");
+
+    fty::AssetImpl::deleteList({ups, feed, rack}, false);
+    CHECK(fty::AssetImpl::loadList({ups, rack, feed}).empty());
+}
@@ -0,0 +1,61 @@
+#include "asset.h"
+#include <catch2/catch.hpp>
+#include <cstdlib>
+#include <fty_common_db_dbpath.h>
+#include <test-db/sample-db.h>
+
+TEST_CASE("Get many by uuid")
+{
+    fty::SampleDb db(R"(
+        items:
+            - type     : Datacenter
+              name     : many-dc
+              ext-name : Many DC
+              attrs :
+                  uuid : many-uuid-dc
+              items :
+                  - type     : Rack
+                    name     : many-rack
+                    ext-name : Many rack
+                    attrs :
+                        uuid : many-uuid-rack
+                    items :
+                        - type     : Ups
+                          name     : many-ups
+                          ext-name : Many UPS
+                          attrs :
+                              uuid : many-uuid-ups
+    )");
+    DBConn::url = getenv("DBURL");
+
+    // uuids are resolved with one query, unknown ones are not returned
+    auto inames = fty::AssetImpl::getInamesFromUuids({"many-uuid-ups", "many-uuid-unknown", "many-uuid-rack"});
+    REQUIRE(inames.size() == 2);
+    CHECK(inames["many-uuid-ups"] == "many-ups");
+    CHECK(inames["many-uuid-rack"] == "many-rack");
+
+    // then loaded at once, with their parents loaded once for all
+    std::vector<fty::AssetImpl> assets = fty::AssetImpl::loadList({inames["many-uuid-ups"], inames["many-uuid-rack"]});
+    REQUIRE(assets.size() == 2);
+    CHECK(assets[0].getInternalName() == "many-ups");
+    CHECK(assets[0].getExtEntry(fty::EXT_UUID) == "many-uuid-ups");
+    CHECK(assets[1].getInternalName() == "many-rack");
+
+    fty::ParentsCache cache;
+    fty::AssetImpl::loadParents(assets, cache);
+    for (auto& asset : assets) {
+        asset.updateParentsList(cache);
+    }
+
+    const auto& upsParents = assets[0].getParentsList();
+    REQUIRE(upsParents.size() == 2);
+    CHECK(upsParents[0].getInternalName() == "many-rack");
+    CHECK(upsParents[1].getInternalName() == "many-dc");
+    REQUIRE(assets[1].getParentsList().size() == 1);
+    CHECK(assets[1].getParentsList()[0].getInternalName() == "many-dc");
+
+    // same as the asset loaded alone
+    fty::AssetImpl single("many-ups");
+    single.updateParentsList();
+    CHECK(single.getParentsList() == upsParents);
+}
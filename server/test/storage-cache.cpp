@@ -0,0 +1,61 @@
+#include "asset-db-cache.h"
+#include "asset-db.h"
+#include "asset.h"
+#include "asset/dbhelpers.h"
+#include <catch2/catch.hpp>
+#include <cstdlib>
+#include <czmq.h>
+#include <fty_common_db_dbpath.h>
+#include <test-db/sample-db.h>
+
+TEST_CASE("Storage cache")
+{
+    fty::SampleDb db(R"(
+        items:
+            - type     : Datacenter
+              name     : cache-dc
+              ext-name : Cache DC
+              items :
+                  - type     : Ups
+                    name     : cache-ups
+                    ext-name : Cache UPS
+                    attrs :
+                        serial_no : SN1
+    )");
+    DBConn::url = getenv("DBURL");
+
+    SECTION("ids of a rolled back insert are forgotten")
+    {
+        fty::CachedStorage cache(fty::DB::getInstance());
+
+        fty::Asset asset;
+        asset.setInternalName("cache-room");
+        asset.setAssetType("room");
+        asset.setAssetSubtype("N_A");
+        asset.setAssetStatus(fty::AssetStatus::Nonactive);
+        asset.setParentIname("cache-dc");
+
+        cache.beginTransaction();
+        cache.insert(asset);
+        CHECK(cache.getID("cache-room"));
+        cache.rollbackTransaction();
+
+        CHECK(!cache.getID("cache-room"));
+    }
+
+    SECTION("inventory written outside of the storage is loaded again")
+    {
+        fty::AssetImpl::setStorageType(fty::AssetStorage::StorageType::StorageCachedDB);
+
+        CHECK(fty::AssetImpl("cache-ups").getExtEntry("serial_no") == "SN1");
+
+        zhash_t* ext = zhash_new();
+        zhash_insert(ext, "serial_no", const_cast<char*>("SN2"));
+        REQUIRE(process_insert_inventory("cache-ups", ext, true, false) == 0);
+        zhash_destroy(&ext);
+
+        CHECK(fty::AssetImpl("cache-ups").getExtEntry("serial_no") == "SN2");
+
+        fty::AssetImpl::setStorageType(fty::AssetStorage::StorageType::StorageDB);
+    }
+}
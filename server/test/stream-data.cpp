@@ -0,0 +1,164 @@
+#include "asset-stream-data.h"
+#include "asset/dbhelpers.h"
+#include "request-stats.h"
+#include <catch2/catch.hpp>
+#include <cstdlib>
+#include <fty_common_db_dbpath.h>
+#include <map>
+#include <sstream>
+#include <test-db/sample-db.h>
+#include <tntdb/row.h>
+
+// more racks and devices than SQL_IN_BATCH, so that every IN list is split
+static const size_t RACKS = 150;
+
+static std::string rackName(size_t i)
+{
+    return "stream-rack-" + std::to_string(i);
+}
+
+static std::string upsName(size_t i)
+{
+    return "stream-ups-" + std::to_string(i);
+}
+
+static std::string sample()
+{
+    std::stringstream ss;
+    ss << "items:\n";
+    ss << "  - type : Datacenter\n";
+    ss << "    name : stream-dc\n";
+    ss << "    items:\n";
+    for (size_t i = 0; i < RACKS; i++) {
+        ss << "      - type : Rack\n";
+        ss << "        name : " << rackName(i) << "\n";
+        ss << "        items:\n";
+        ss << "          - type : Ups\n";
+        ss << "            name : " << upsName(i) << "\n";
+        ss << "            attrs:\n";
+        ss << "              serial_no : SN" << i << "\n";
+    }
+    return ss.str();
+}
+
+TEST_CASE("Stream data by batches")
+{
+    fty::SampleDb db(sample());
+    DBConn::url = getenv("DBURL");
+
+    std::set<std::string> names;
+    std::set<uint32_t>    ids;
+    for (size_t i = 0; i < RACKS; i++) {
+        names.insert(rackName(i));
+        names.insert(upsName(i));
+        ids.insert(db.idByName(upsName(i)));
+    }
+
+    SECTION("basic rows by names")
+    {
+        std::set<std::string>                  selected;
+        std::function<void(const tntdb::Row&)> cb = [&](const tntdb::Row& row) {
+            selected.insert(row["name"].getString());
+        };
+        REQUIRE(select_asset_element_basic_by_names(names, cb, false) == 0);
+        CHECK(selected == names);
+    }
+
+    SECTION("basic rows by ids")
+    {
+        std::set<uint32_t>                     selected;
+        std::function<void(const tntdb::Row&)> cb = [&](const tntdb::Row& row) {
+            selected.insert(row["id"].getUnsigned32());
+        };
+        REQUIRE(select_asset_element_basic_by_ids(ids, cb, false) == 0);
+        CHECK(selected == ids);
+    }
+
+    SECTION("ext attributes by ids")
+    {
+        std::map<uint32_t, std::string>        serials;
+        std::function<void(const tntdb::Row&)> cb = [&](const tntdb::Row& row) {
+            if (row["keytag"].getString() == "serial_no") {
+                serials[row["id_asset_element"].getUnsigned32()] = row["value"].getString();
+            }
+        };
+        REQUIRE(select_ext_attributes_by_ids(ids, cb, false) == 0);
+        REQUIRE(serials.size() == RACKS);
+        for (size_t i = 0; i < RACKS; i++) {
+            CHECK(serials[db.idByName(upsName(i))] == "SN" + std::to_string(i));
+        }
+    }
+
+    SECTION("parents by names")
+    {
+        std::vector<AssetStreamData> all;
+        REQUIRE(select_all_assets_stream_data("test", all, false) == 0);
+
+        std::map<std::string, AssetStreamData> selected;
+        std::function<void(const tntdb::Row&)> cb = [&](const tntdb::Row& row) {
+            AssetStreamData& data = selected[row["name"].getString()];
+            data.parents.assign(ASSET_STREAM_MAX_PARENTS, "");
+            row["id_parent"].get(data.parentId);
+            for (size_t i = 0; i < ASSET_STREAM_MAX_PARENTS; i++) {
+                row["parent_name" + std::to_string(i + 1)].get(data.parents[i]);
+            }
+        };
+
+        // one query per SQL_IN_BATCH names, as for the legacy messages of a batch notification
+        uint64_t queries = fty::RequestStats::dbQueries();
+        REQUIRE(select_asset_element_parents_by_names(names, cb, false) == 0);
+        CHECK(fty::RequestStats::dbQueries() - queries == (names.size() + 127) / 128);
+
+        REQUIRE(selected.size() == names.size());
+        for (const auto& data : all) {
+            if (!names.count(data.name)) {
+                continue;
+            }
+            CHECK(selected[data.name].parentId == data.parentId);
+            CHECK(selected[data.name].parents == data.parents);
+        }
+    }
+
+    SECTION("selected assets as all assets")
+    {
+        std::vector<AssetStreamData> all;
+        REQUIRE(select_all_assets_stream_data("test", all, false) == 0);
+        std::map<std::string, AssetStreamData> expected;
+        for (const auto& data : all) {
+            expected[data.name] = data;
+        }
+
+        // devices only: their racks, more than SQL_IN_BATCH, are read by the ancestor walk
+        std::set<std::string> devices;
+        for (size_t i = 0; i < RACKS; i++) {
+            devices.insert(upsName(i));
+        }
+        devices.insert("stream-unknown");
+
+        std::vector<AssetStreamData> assets;
+        REQUIRE(select_assets_stream_data("test", devices, assets, false) == 0);
+        REQUIRE(assets.size() == RACKS);
+        for (const auto& data : assets) {
+            const auto& exp = expected.at(data.name);
+            CHECK(data.found);
+            CHECK(data.id == exp.id);
+            CHECK(data.typeId == exp.typeId);
+            CHECK(data.subtypeId == exp.subtypeId);
+            CHECK(data.parentId == exp.parentId);
+            CHECK(data.status == exp.status);
+            CHECK(data.ext == exp.ext);
+            CHECK(data.parents == exp.parents);
+            REQUIRE(data.parents.size() == ASSET_STREAM_MAX_PARENTS);
+            CHECK(data.parents[1] == "stream-dc");
+        }
+
+        // racks and devices together, ancestors already known are not read again
+        assets.clear();
+        REQUIRE(select_assets_stream_data("test", names, assets, false) == 0);
+        REQUIRE(assets.size() == names.size());
+        for (const auto& data : assets) {
+            CHECK(data.ext == expected.at(data.name).ext);
+            CHECK(data.parents == expected.at(data.name).parents);
+        }
+    }
+}